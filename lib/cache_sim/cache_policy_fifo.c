@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <stdint.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_policy_fill.h"
+#include "cache_policy_fifo.h"
+
+/* fifo_victim */
+static int fifo_victim(const uint64_t *stamps, const int associativity,
+    const uint64_t loads, uint64_t *state) {
+    int way = 0, victim = 0;
+
+    /* ways loaded in turn are evicted in turn */
+    if (0 == (loads & POLICY_FILL_INVALIDATED)) {
+        victim = (int)*state;
+        *state = (victim + 1) % associativity;
+
+        return victim;
+    }
+
+    /* otherwise, the way loaded the longest ago, refills after an
+     * invalidation included
+     */
+    for (way = 1; way < associativity; way++) {
+        if (stamps[way] < stamps[victim]) {
+            victim = way;
+        }
+    }
+
+    return victim;
+}
+
+/* policy_fifo_init */
+int policy_fifo_init(cache_handle_t *cache) {
+    return policy_fill_init(cache);
+}
+
+/* policy_fifo_access */
+int policy_fifo_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return policy_fill_access(cache, line_id, load, &fifo_victim);
+}
+
+// EOF
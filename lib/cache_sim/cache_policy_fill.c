@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_util.h"
+#include "cache_policy_fill.h"
+
+/* policy_fill_init */
+int policy_fill_init(cache_handle_t *cache) {
+    /* sanity check: does cache exist? */
+    if (NULL == cache) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration and initialization */
+    policy_fill_t *fill = NULL;
+    size_t size = 0;
+    uint64_t i = 0;
+
+    /* allocate the handle and all arrays in a single data area */
+    size = sizeof(policy_fill_t) +
+        (cache->total_lines * sizeof(policy_fill_way_t)) +
+        (cache->total_lines * sizeof(uint64_t)) +
+        (cache->total_sets * 2 * sizeof(uint64_t));
+    fill = (policy_fill_t *)malloc(size);
+
+    if (NULL == fill) {
+        printf("Error: unable to allocate memory for cache data\n");
+        return CACHE_SIM_ERROR;
+    }
+    cache->data = fill;
+
+    fill->ways = (policy_fill_way_t *)(fill + 1);
+    fill->stamps = (uint64_t *)(fill->ways + cache->total_lines);
+    fill->loads = fill->stamps + cache->total_lines;
+    fill->state = fill->loads + cache->total_sets;
+
+    /* initialize data area */
+    for (i = 0; i < cache->total_lines; i++) {
+        fill->ways[i].line_id = UINT64_MAX;
+        fill->ways[i].load    = LOAD_ACCESS;
+        fill->ways[i].dirty   = 0;
+        fill->stamps[i]       = 0;
+    }
+    for (i = 0; i < cache->total_sets; i++) {
+        fill->loads[i] = 0;
+        fill->state[i] = 0;
+    }
+
+    if (cache_sim_verbose) {
+        printf("Memory required: %9d bytes\n", (int)(sizeof(cache_handle_t) +
+            size));
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* policy_fill_access */
+int policy_fill_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load, policy_fill_victim_fn_t victim_fn) {
+    policy_fill_t *fill = (policy_fill_t *)cache->data;
+    policy_fill_way_t *ways = NULL;
+    uint64_t *stamps = NULL;
+    uint64_t set = line_id;
+    int way = 0, victim = -1;
+
+    /* calculate set for this address */
+    CACHE_SIM_LINE_ID_TO_SET(set);
+    ways = &(fill->ways[set * cache->associativity]);
+    stamps = &(fill->stamps[set * cache->associativity]);
+
+    /* look for the line, and for the first empty way */
+    for (way = 0; way < cache->associativity; way++) {
+        if (line_id == ways[way].line_id) {
+            #ifdef DEBUG
+            printf("HIT    line id [%018p] set [%2d:%d]\n", line_id, set, way);
+            #endif
+
+            /* writes leave the line dirty */
+            if (LOAD_WRITE == load) {
+                ways[way].dirty = 1;
+            }
+
+            /* if the hit was on a prefetched line */
+            if (LOAD_IS_PREFETCH(ways[way].load)) {
+                /* reset load reason */
+                cache->prefetch_load = ways[way].load;
+                ways[way].load = LOAD_ACCESS;
+
+                return (CACHE_SIM_L1_HIT + CACHE_SIM_L1_HIT_PREFETCH);
+            }
+
+            return CACHE_SIM_L1_HIT;
+        }
+
+        if ((0 > victim) && (UINT64_MAX == ways[way].line_id)) {
+            victim = way;
+        }
+    }
+
+    /* a full set lets the policy choose */
+    if (0 > victim) {
+        victim = victim_fn(stamps, cache->associativity, fill->loads[set],
+            &(fill->state[set]));
+    }
+
+    #ifdef DEBUG
+    printf("MISS   line id [%018p]\n", line_id);
+    printf("LOAD   line id [%018p] set [%2d:%d] load reason [%d]\n", line_id,
+        set, victim, load);
+    #endif
+
+    /* report the evicted line, if any */
+    cache->victim = ways[victim].line_id;
+    cache->victim_dirty = ways[victim].dirty;
+
+    /* the loaded line is the newest of its set */
+    stamps[victim] = fill->loads[set]++;
+
+    /* if the evicted line was prefetched and never accessed */
+    if (LOAD_IS_PREFETCH(ways[victim].load)) {
+        cache->prefetch_load = ways[victim].load;
+
+        /* load the data */
+        ways[victim].line_id = line_id;
+        ways[victim].load = (LOAD_WRITE == load) ? LOAD_ACCESS : load;
+        ways[victim].dirty = (LOAD_WRITE == load);
+
+        return (CACHE_SIM_L1_MISS + CACHE_SIM_L1_PREFETCH_EVICT);
+    }
+
+    /* load the data */
+    ways[victim].line_id = line_id;
+    ways[victim].load = (LOAD_WRITE == load) ? LOAD_ACCESS : load;
+    ways[victim].dirty = (LOAD_WRITE == load);
+
+    return CACHE_SIM_L1_MISS;
+}
+
+/* policy_fill_invalidate */
+int policy_fill_invalidate(cache_handle_t *cache, const uint64_t line_id) {
+    policy_fill_t *fill = (policy_fill_t *)cache->data;
+    policy_fill_way_t *ways = NULL;
+    uint64_t set = line_id;
+    int way = 0;
+
+    /* calculate set for this address */
+    CACHE_SIM_LINE_ID_TO_SET(set);
+    ways = &(fill->ways[set * cache->associativity]);
+
+    for (way = 0; way < cache->associativity; way++) {
+        if (line_id == ways[way].line_id) {
+            #ifdef DEBUG
+            printf("INVAL  line id [%018p] set [%2d:%d]\n", line_id, set, way);
+            #endif
+
+            cache->victim = line_id;
+            cache->victim_dirty = ways[way].dirty;
+
+            ways[way].line_id = UINT64_MAX;
+            ways[way].load = LOAD_ACCESS;
+            ways[way].dirty = 0;
+
+            /* the set is no longer loaded in turn */
+            fill->loads[set] |= POLICY_FILL_INVALIDATED;
+
+            return CACHE_SIM_L1_HIT;
+        }
+    }
+
+    return CACHE_SIM_L1_MISS;
+}
+
+// EOF
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef CACHE_POLICY_FILL_H_
+#define CACHE_POLICY_FILL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CACHE_SIM_H_
+#include "cache_sim.h"
+#endif
+
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+
+/* Code shared by the policies that only act when a line is loaded: hits
+ * leave their state untouched, empty ways are filled first and a full set
+ * asks the policy for its victim. Every way is stamped with the number of
+ * lines loaded into its set before it, which tells the order they came in.
+ * Stamps are kept apart from the ways since hits never read them.
+ */
+typedef struct {
+    uint64_t line_id;
+    uint8_t  load;
+    uint8_t  dirty;
+    uint8_t  padding[6];
+} policy_fill_way_t;
+
+typedef struct {
+    policy_fill_way_t *ways;
+    uint64_t *stamps;  // stamp of each way
+    uint64_t *loads;   // lines loaded into each set so far
+    uint64_t *state;   // per set state of the victim selection
+} policy_fill_t;
+
+/* Set in the load count of a set once one of its lines was invalidated.
+ * Until then, the ways of the set were loaded in turn. Stamps keep growing
+ * since the flag is the topmost bit.
+ */
+#define POLICY_FILL_INVALIDATED (1ULL << 63)
+
+/* Picks the way of a full set to evict, given the stamps of its ways */
+typedef int (*policy_fill_victim_fn_t)(const uint64_t *stamps,
+    const int associativity, const uint64_t loads, uint64_t *state);
+
+int policy_fill_init(cache_handle_t *cache);
+int policy_fill_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load, policy_fill_victim_fn_t victim_fn);
+int policy_fill_invalidate(cache_handle_t *cache, const uint64_t line_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_POLICY_FILL_H_ */
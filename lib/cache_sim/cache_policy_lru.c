@@ -31,6 +31,37 @@
 #include "cache_sim_util.h"
 #include "cache_policy_lru.h"
 
+/* bytes of a 64-bit word */
+#define LRU_LOW_BITS  0x0101010101010101ULL
+#define LRU_HIGH_BITS 0x8080808080808080ULL
+
+/* lru_zero_bytes: sets the high bit of each byte of word that is zero */
+static inline uint64_t lru_zero_bytes(const uint64_t word) {
+    return ~(((word & ~LRU_HIGH_BITS) + ~LRU_HIGH_BITS) | word) &
+        LRU_HIGH_BITS;
+}
+
+/* lru_fingerprint */
+static inline uint64_t lru_fingerprint(const uint64_t line_id) {
+    return (line_id * 0x9e3779b97f4a7c15ULL) >> 56;
+}
+
+/* lru_set_byte */
+static inline uint64_t lru_set_byte(const uint64_t word, const int byte,
+    const uint64_t value) {
+    return (word & ~(0xffULL << (8 * byte))) | (value << (8 * byte));
+}
+
+/* lru_matrix_set: sets with a bit matrix are followed by their tags */
+static inline policy_lru_set_t *lru_matrix_set(const policy_lru_t *lru,
+    const uint64_t set, const int associativity) {
+    return (policy_lru_set_t *)((char *)lru->sets + (set *
+        (sizeof(policy_lru_set_t) + (associativity * sizeof(uint64_t)))));
+}
+
+/* access functions, policy_lru_init picks one by associativity */
+static policy_access_fn_t lru_access_fn(const cache_handle_t *cache);
+
 /* policy_lru_init */
 int policy_lru_init(cache_handle_t *cache) {
     /* sanity check: does cache exist? */
@@ -39,88 +70,425 @@ int policy_lru_init(cache_handle_t *cache) {
         return CACHE_SIM_ERROR;
     }
 
+    /* sanity check: do way indexes and the sentinel fit in the lists? */
+    if (UINT16_MAX <= cache->associativity) {
+        printf("Error: associativity too large for LRU policy\n");
+        return CACHE_SIM_ERROR;
+    }
+
     /* variables declaration and initialization */
-    void *ptr = NULL;
+    policy_lru_t *lru = NULL;
+    policy_lru_way_t *ways = NULL;
+    policy_lru_set_t *set_data = NULL;
+    size_t size = 0;
     uint64_t i = 0;
+    int matrix = (POLICY_LRU_MATRIX_WAYS >= cache->associativity);
+    int words = (cache->associativity + 7) / 8;
+    int stride = matrix ? 0 : words * 8;
+    int set_size = sizeof(policy_lru_set_t) +
+        (cache->associativity * sizeof(uint64_t));
+    int way = 0;
 
-    /* allocate data area */
-    ptr = malloc(sizeof(policy_lru_t) * cache->total_lines);
+    /* allocate the handle and all arrays in a single data area */
+    size = sizeof(policy_lru_t);
+    if (matrix) {
+        size += cache->total_sets * set_size;
+    } else {
+        size += (cache->total_sets * stride * sizeof(uint64_t)) +
+            (cache->total_sets * words * sizeof(uint64_t)) +
+            ((cache->total_lines + cache->total_sets) *
+            sizeof(policy_lru_way_t));
+    }
+    lru = (policy_lru_t *)malloc(size);
 
-    if (NULL == ptr) {
+    if (NULL == lru) {
         printf("Error: unable to allocate memory for cache data\n");
         return CACHE_SIM_ERROR;
     }
-    cache->data = ptr;
+    cache->data = lru;
+
+    lru->words = words;
+    lru->stride = stride;
+    lru->line_id = NULL;
+    lru->fingerprint = NULL;
+    lru->ways = NULL;
+    lru->sets = NULL;
+
+    /* initialize data area, all ways invalid and way 0 the first to fill */
+    if (matrix) {
+        lru->sets = (policy_lru_set_t *)(lru + 1);
+
+        for (i = 0; i < cache->total_sets; i++) {
+            set_data = lru_matrix_set(lru, i, cache->associativity);
+            memset(set_data, 0, sizeof(policy_lru_set_t));
+            set_data->clock = UINT64_MAX;
+
+            /* each way is older than the ways after it */
+            for (way = 0; way < cache->associativity; way++) {
+                set_data->order |= (((1ULL << cache->associativity) - 1) &
+                    ~((2ULL << way) - 1)) << (8 * way);
+                set_data->load[way] = LOAD_ACCESS;
+                set_data->line_id[way] = UINT64_MAX;
+            }
+        }
+    } else {
+        lru->line_id = (uint64_t *)(lru + 1);
+        lru->fingerprint = lru->line_id + (cache->total_sets * stride);
 
-    /* initialize data area */
-    for (i = (uint64_t)cache->data;
-        i < ((uint64_t)cache->data + (sizeof(policy_lru_t) * cache->total_lines));
-        i += sizeof(uint64_t)) {
-        /* write UINT64_MAX everywhere... */
-        *(uint64_t *)i = UINT64_MAX;
+        for (i = 0; i < cache->total_sets * stride; i++) {
+            lru->line_id[i] = UINT64_MAX;
+        }
+        lru->ways = (policy_lru_way_t *)(lru->fingerprint +
+            (cache->total_sets * words));
+
+        for (i = 0; i < cache->total_sets * words; i++) {
+            lru->fingerprint[i] = 0;
+        }
+
+        for (i = 0; i < cache->total_sets; i++) {
+            ways = &(lru->ways[i * (cache->associativity + 1)]);
+
+            for (way = 0; way <= cache->associativity; way++) {
+                ways[way].age   = UINT64_MAX;
+                ways[way].newer = (way + 1) % (cache->associativity + 1);
+                ways[way].older = (way + cache->associativity) %
+                    (cache->associativity + 1);
+                ways[way].load  = LOAD_ACCESS;
+                ways[way].dirty = 0;
+            }
+        }
     }
 
-    printf("Memory required: %9d bytes\n", (sizeof(cache_handle_t) +
-        (sizeof(policy_lru_t) * cache->total_lines)));
+    /* the access function of this geometry replaces policy_lru_access */
+    cache->access_fn = lru_access_fn(cache);
+
+    if (cache_sim_verbose) {
+        printf("Memory required: %9d bytes\n", (int)(sizeof(cache_handle_t) +
+            size));
+    }
 
     return CACHE_SIM_SUCCESS;
 }
 
-/* policy_lru_read */
-int policy_lru_access(cache_handle_t *cache, const uint64_t line_id,
-    const load_t load) {
-    static policy_lru_t *base_addr = NULL;
-    static policy_lru_t *lru = NULL;
-    static uint64_t set = UINT64_MAX;
-    static int way = 0;
-    register int i = 0;
+/* lru_matrix_lookup: returns the way that holds line_id, or -1 */
+static inline int lru_matrix_lookup(const policy_lru_set_t *set_data,
+    const int associativity, const uint64_t line_id, const uint64_t pattern) {
+    uint64_t match = 0;
+    int way = 0;
+
+    /* a few tags are compared faster than their fingerprints are kept */
+    if (POLICY_LRU_TAG_WAYS >= associativity) {
+        for (way = 0; way < associativity; way++) {
+            if (set_data->line_id[way] == line_id) {
+                return way;
+            }
+        }
+        return -1;
+    }
+
+    match = lru_zero_bytes(set_data->fingerprint ^ pattern) &
+        (LRU_HIGH_BITS >> (8 * (8 - associativity)));
+
+    while (0 != match) {
+        way = __builtin_ctzll(match) / 8;
+        if (set_data->line_id[way] == line_id) {
+            return way;
+        }
+        match &= match - 1;
+    }
+
+    return -1;
+}
+
+/* lru_matrix_touch: makes way the most recently used one */
+static inline void lru_matrix_touch(policy_lru_set_t *set_data,
+    const int associativity, const int way, const uint64_t clock) {
+    uint64_t columns = LRU_LOW_BITS >> (8 * (8 - associativity));
+    uint64_t order = 0;
+    uint8_t ties = 0;
+
+    /* a direct-mapped set has no order to keep */
+    if (1 == associativity) {
+        return;
+    }
+
+    order = (set_data->order | (columns << way)) & ~(0xffULL << (8 * way));
+
+    if (clock != set_data->clock) {
+        set_data->clock = clock;
+        set_data->touched = 1 << way;
+        set_data->order = order;
+        return;
+    }
+
+    /* ways touched during the same access are evicted from the highest
+     * way down, so the way stays older than those with a lower index
+     */
+    ties = set_data->touched & ((1 << way) - 1);
+    set_data->touched |= 1 << way;
+    order |= (uint64_t)ties << (8 * way);
+
+    while (0 != ties) {
+        order &= ~(1ULL << ((8 * __builtin_ctz(ties)) + way));
+        ties &= ties - 1;
+    }
+
+    set_data->order = order;
+}
+
+/* lru_matrix_victim: returns the way no other way is older than */
+static inline int lru_matrix_victim(const policy_lru_set_t *set_data,
+    const int associativity) {
+    uint64_t order = set_data->order;
+
+    /* nor a choice of victim */
+    if (1 == associativity) {
+        return 0;
+    }
+
+    /* fold the rows of the set into one */
+    if (4 < associativity) {
+        order |= order >> 32;
+    }
+    if (2 < associativity) {
+        order |= order >> 16;
+    }
+    order |= order >> 8;
+
+    return __builtin_ctz(~(unsigned)order);
+}
+
+/* lru_matrix_access */
+static inline __attribute__((always_inline)) int lru_matrix_access(
+    cache_handle_t *cache, const uint64_t line_id, const load_t load,
+    const int associativity) {
+    policy_lru_t *lru = (policy_lru_t *)cache->data;
+    policy_lru_set_t *set_data = NULL;
+    uint64_t set = UINT64_MAX;
+    uint64_t pattern = lru_fingerprint(line_id);
+    int way = -1;
+    int rc = CACHE_SIM_L1_MISS;
 
     /* calculate tag and set for this address */
     set = line_id;
     CACHE_SIM_LINE_ID_TO_SET(set);
 
-    /* calculate data area base address for this set */
-    base_addr = (policy_lru_t *)((uint64_t)cache->data +
-        (set * cache->associativity * sizeof(policy_lru_t)));
-    lru = base_addr;
+    set_data = lru_matrix_set(lru, set, associativity);
+    way = lru_matrix_lookup(set_data, associativity, line_id,
+        pattern * LRU_LOW_BITS);
+
+    /* check if data is present */
+    if (-1 != way) {
+        #ifdef DEBUG
+        printf("HIT    line id [%018p] set [%2d:%d]\n", line_id, set, way);
+        #endif
+
+        lru_matrix_touch(set_data, associativity, way, cache->clock);
+
+        /* writes leave the line dirty */
+        if (LOAD_WRITE == load) {
+            set_data->dirty[way] = 1;
+        }
+
+        /* if the hit was on a prefetched line */
+        if (LOAD_IS_PREFETCH(set_data->load[way])) {
+            /* update the load reason */
+            cache->prefetch_load = set_data->load[way];
+            set_data->load[way] = LOAD_ACCESS;
+
+            return (CACHE_SIM_L1_HIT + CACHE_SIM_L1_HIT_PREFETCH);
+        }
+
+        return CACHE_SIM_L1_HIT;
+    }
+
+    /* evict the LRU way, which is a free way if there is any (bonus!) */
+    way = lru_matrix_victim(set_data, associativity);
+    cache->victim = set_data->line_id[way];
+    cache->victim_dirty = set_data->dirty[way];
+
+    /* if the evicted line was prefetched and never accessed */
+    if (LOAD_IS_PREFETCH(set_data->load[way])) {
+        cache->prefetch_load = set_data->load[way];
+        rc = (CACHE_SIM_L1_MISS + CACHE_SIM_L1_PREFETCH_EVICT);
+    }
+
+    /* if data was not found, report that and load it */
+    #ifdef DEBUG
+    printf("MISS   line id [%018p]\n", line_id);
+    printf("LOAD   line id [%018p] set [%2d:%d] load reason [%d]\n", line_id,
+        set, way, load);
+    #endif
+
+    /* load the data */
+    set_data->line_id[way] = line_id;
+    if (POLICY_LRU_TAG_WAYS < associativity) {
+        set_data->fingerprint = lru_set_byte(set_data->fingerprint, way,
+            pattern);
+    }
+    set_data->load[way] = (LOAD_WRITE == load) ? LOAD_ACCESS : load;
+    set_data->dirty[way] = (LOAD_WRITE == load);
+    lru_matrix_touch(set_data, associativity, way, cache->clock);
+
+    return rc;
+}
+
+/* lru_matrix_access_N: the common associativities get their own copy of
+ * lru_matrix_access, with masks and set sizes folded into constants
+ */
+static int lru_matrix_access_1(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return lru_matrix_access(cache, line_id, load, 1);
+}
 
-    /* iterate across all the ways of the set */
-    for (i = cache->associativity; i > 0; i--) {
-        /* check if data is present */
-        if (base_addr->line_id == line_id) {
-            /* update access age */
-            base_addr->age = cache->access;
+static int lru_matrix_access_2(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return lru_matrix_access(cache, line_id, load, 2);
+}
 
-            #ifdef DEBUG
-            printf("HIT    line id [%018p] set [%2d:%d]\n", line_id, set, i);
-            #endif
+static int lru_matrix_access_4(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return lru_matrix_access(cache, line_id, load, 4);
+}
 
-            /* if the hit was on a prefetched line */
-            if (LOAD_PREFETCH == base_addr->load) {
-                /* update the load reason */
-                base_addr->load = LOAD_ACCESS;
+static int lru_matrix_access_8(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return lru_matrix_access(cache, line_id, load, 8);
+}
 
-                return (CACHE_SIM_L1_HIT + CACHE_SIM_L1_HIT_PREFETCH);
+/* lru_matrix_access_any */
+static int lru_matrix_access_any(cache_handle_t *cache,
+    const uint64_t line_id, const load_t load) {
+    return lru_matrix_access(cache, line_id, load, cache->associativity);
+}
+
+/* lru_list_lookup: returns the way that holds line_id, or -1 */
+static inline int lru_list_lookup(const policy_lru_t *lru,
+    const uint64_t *fingerprint, const uint64_t *tags,
+    const uint64_t line_id, const uint64_t pattern) {
+    uint64_t match = 0;
+    int way = 0;
+    register int i = 0;
+
+    for (i = 0; i < lru->words; i++) {
+        match = lru_zero_bytes(fingerprint[i] ^ pattern);
+
+        /* ways past the associativity have invalid tags */
+        while (0 != match) {
+            way = (i * 8) + (__builtin_ctzll(match) / 8);
+            if (tags[way] == line_id) {
+                return way;
             }
+            match &= match - 1;
+        }
+    }
+
+    return -1;
+}
+
+/* lru_unlink */
+static inline void lru_unlink(policy_lru_way_t *ways, const uint16_t way) {
+    ways[ways[way].newer].older = ways[way].older;
+    ways[ways[way].older].newer = ways[way].newer;
+}
+
+/* lru_link */
+static inline void lru_link(policy_lru_way_t *ways, const uint16_t newer,
+    const uint16_t way) {
+    uint16_t older = ways[newer].older;
+
+    ways[way].newer = newer;
+    ways[way].older = older;
+    ways[newer].older = way;
+    ways[older].newer = way;
+}
+
+/* lru_touch */
+static inline void lru_touch(policy_lru_way_t *ways, const uint16_t sentinel,
+    const uint16_t way, const uint64_t age) {
+    uint16_t newer = sentinel;
+
+    /* ways touched during the same access are evicted from the highest
+     * way down, so the way goes below those with a lower index (the
+     * sentinel has the highest index and never matches the age)
+     */
+    while ((age == ways[ways[newer].older].age) &&
+        (ways[newer].older < way)) {
+        newer = ways[newer].older;
+    }
+
+    ways[way].age = age;
+    lru_link(ways, newer, way);
+}
+
+/* lru_list_access */
+static int lru_list_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    policy_lru_t *lru = (policy_lru_t *)cache->data;
+    policy_lru_way_t *ways = NULL;
+    uint64_t *tags = NULL;
+    uint64_t *fingerprint = NULL;
+    uint64_t set = UINT64_MAX;
+    uint64_t pattern = lru_fingerprint(line_id);
+    uint16_t sentinel = cache->associativity;
+    int way = -1;
+    int rc = CACHE_SIM_L1_MISS;
+
+    /* calculate tag and set for this address */
+    set = line_id;
+    CACHE_SIM_LINE_ID_TO_SET(set);
 
-            return CACHE_SIM_L1_HIT;
+    /* calculate data area base addresses for this set */
+    ways = &(lru->ways[set * (cache->associativity + 1)]);
+    tags = &(lru->line_id[set * lru->stride]);
+    fingerprint = &(lru->fingerprint[set * lru->words]);
+
+    way = lru_list_lookup(lru, fingerprint, tags, line_id,
+        pattern * LRU_LOW_BITS);
+
+    /* check if data is present */
+    if (-1 != way) {
+        #ifdef DEBUG
+        printf("HIT    line id [%018p] set [%2d:%d]\n", line_id, set, way);
+        #endif
+
+        if (ways[sentinel].older == way) {
+            /* no way was touched during this access yet, so the order
+             * holds for the most recently used way
+             */
+            ways[way].age = cache->clock;
+        } else {
+            lru_unlink(ways, way);
+            lru_touch(ways, sentinel, way, cache->clock);
         }
 
-        /* if it is a free way use it (bonus!) */
-        if (UINT64_MAX == base_addr->line_id) {
-            lru = base_addr;
-            way = i;
-            break;
+        /* writes leave the line dirty */
+        if (LOAD_WRITE == load) {
+            ways[way].dirty = 1;
         }
 
-        /* find the last recently used way in the set */
-        if (base_addr->age <= lru->age) {
-            lru = base_addr;
-            way = i;
+        /* if the hit was on a prefetched line */
+        if (LOAD_IS_PREFETCH(ways[way].load)) {
+            /* update the load reason */
+            cache->prefetch_load = ways[way].load;
+            ways[way].load = LOAD_ACCESS;
+
+            return (CACHE_SIM_L1_HIT + CACHE_SIM_L1_HIT_PREFETCH);
         }
 
-        /* increment way address */
-        base_addr++;
+        return CACHE_SIM_L1_HIT;
+    }
+
+    /* evict the LRU way, which is a free way if there is any (bonus!) */
+    way = ways[sentinel].newer;
+    lru_unlink(ways, way);
+    cache->victim = tags[way];
+    cache->victim_dirty = ways[way].dirty;
+
+    /* if the evicted line was prefetched and never accessed */
+    if (LOAD_IS_PREFETCH(ways[way].load)) {
+        cache->prefetch_load = ways[way].load;
+        rc = (CACHE_SIM_L1_MISS + CACHE_SIM_L1_PREFETCH_EVICT);
     }
 
     /* if data was not found, report that and load it */
@@ -130,22 +498,104 @@ int policy_lru_access(cache_handle_t *cache, const uint64_t line_id,
         set, way, load);
     #endif
 
-    /* if the evicted line was prefetched and never accessed */
-    if (LOAD_PREFETCH == lru->load) {
-        /* load the data */
-        lru->age = cache->access;
-        lru->line_id = line_id;
-        lru->load = load;
+    /* load the data */
+    tags[way] = line_id;
+    fingerprint[way / 8] = lru_set_byte(fingerprint[way / 8], way % 8,
+        pattern);
+    ways[way].load = (LOAD_WRITE == load) ? LOAD_ACCESS : load;
+    ways[way].dirty = (LOAD_WRITE == load);
+    lru_touch(ways, sentinel, way, cache->clock);
 
-        return (CACHE_SIM_L1_MISS + CACHE_SIM_L1_PREFETCH_EVICT);
+    return rc;
+}
+
+/* lru_access_fn */
+static policy_access_fn_t lru_access_fn(const cache_handle_t *cache) {
+    if (POLICY_LRU_MATRIX_WAYS < cache->associativity) {
+        return &lru_list_access;
     }
 
-    /* load the data */
-    lru->age = cache->access;
-    lru->line_id = line_id;
-    lru->load = load;
+    switch (cache->associativity) {
+        case 1:
+            return &lru_matrix_access_1;
+        case 2:
+            return &lru_matrix_access_2;
+        case 4:
+            return &lru_matrix_access_4;
+        case 8:
+            return &lru_matrix_access_8;
+        default:
+            return &lru_matrix_access_any;
+    }
+}
+
+/* policy_lru_access */
+int policy_lru_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return lru_access_fn(cache)(cache, line_id, load);
+}
+
+/* policy_lru_invalidate */
+int policy_lru_invalidate(cache_handle_t *cache, const uint64_t line_id) {
+    policy_lru_t *lru = (policy_lru_t *)cache->data;
+    policy_lru_set_t *set_data = NULL;
+    policy_lru_way_t *ways = NULL;
+    uint64_t *tags = NULL;
+    uint64_t set = UINT64_MAX;
+    uint64_t pattern = lru_fingerprint(line_id) * LRU_LOW_BITS;
+    uint16_t sentinel = cache->associativity;
+    int way = -1;
+
+    /* calculate tag and set for this address */
+    set = line_id;
+    CACHE_SIM_LINE_ID_TO_SET(set);
+
+    if (NULL != lru->sets) {
+        set_data = lru_matrix_set(lru, set, cache->associativity);
+        tags = set_data->line_id;
+        way = lru_matrix_lookup(set_data, cache->associativity, line_id,
+            pattern);
+    } else {
+        tags = &(lru->line_id[set * lru->stride]);
+        ways = &(lru->ways[set * (cache->associativity + 1)]);
+        way = lru_list_lookup(lru, &(lru->fingerprint[set * lru->words]),
+            tags, line_id, pattern);
+    }
+
+    /* nothing to do if the line is not present */
+    if (-1 == way) {
+        return CACHE_SIM_L1_MISS;
+    }
+
+    #ifdef DEBUG
+    printf("INVAL  line id [%018p] set [%2d:%d]\n", line_id, set, way);
+    #endif
+
+    cache->victim = line_id;
+    tags[way] = UINT64_MAX;
+
+    /* make the way the least recently used one, so that it is the next one
+     * filled (in a matrix, it leaves the rows of all the ways and its own
+     * row holds all the others)
+     */
+    if (NULL != set_data) {
+        cache->victim_dirty = set_data->dirty[way];
+        set_data->order = lru_set_byte(set_data->order &
+            ~((LRU_LOW_BITS >> (8 * (8 - cache->associativity))) << way),
+            way, ((1 << cache->associativity) - 1) & ~(1 << way));
+        set_data->touched &= ~(1 << way);
+        set_data->load[way] = LOAD_ACCESS;
+        set_data->dirty[way] = 0;
+    } else {
+        cache->victim_dirty = ways[way].dirty;
+        lru_unlink(ways, way);
+        lru_link(ways, ways[sentinel].newer, way);
+        ways[way].age = UINT64_MAX;
+        ways[way].load = LOAD_ACCESS;
+        ways[way].dirty = 0;
+    }
 
-    return CACHE_SIM_L1_MISS;
+    return CACHE_SIM_L1_HIT;
 }
 
 // EOF
@@ -37,12 +37,60 @@ extern "C" {
 int policy_lru_init(cache_handle_t *cache);
 int policy_lru_access(cache_handle_t *cache, const uint64_t line_id,
 	const load_t load);
+int policy_lru_invalidate(cache_handle_t *cache, const uint64_t line_id);
+
+/* Hits are found by comparing one-byte fingerprints of the tags of a set,
+ * eight ways at a time in a 64-bit word, and then the full tags of the
+ * matching ways only. Sets of up to POLICY_LRU_TAG_WAYS ways compare their
+ * tags directly.
+ *
+ * Up to POLICY_LRU_MATRIX_WAYS ways, the recency order of a set is a bit
+ * matrix packed in a 64-bit word: bit c of byte r is set if way c was used
+ * more recently than way r. Using a way sets its column and clears its row,
+ * and the LRU way is the one that is in no row. Larger sets keep their ways
+ * in a circular list ordered by recency, linked by way index through a
+ * sentinel entry that follows the ways of the set.
+ *
+ * Either way, invalid ways are the least recently used ones and are filled
+ * first, and ways touched during the same access (a demand load and its
+ * prefetch) are evicted from the highest way down, which keeps victims
+ * identical to a search for the oldest way.
+ */
+#define POLICY_LRU_MATRIX_WAYS 8
+#define POLICY_LRU_TAG_WAYS    4
 
 typedef struct {
-    uint64_t line_id;
     uint64_t age;
+    uint16_t newer;    // next way towards the most recently used
+    uint16_t older;    // next way towards the least recently used
     uint8_t  load;
-    uint8_t  padding[15];
+    uint8_t  dirty;
+    uint8_t  padding[2];
+} policy_lru_way_t;
+
+typedef struct {
+    uint64_t order;    // recency bit matrix
+    uint64_t fingerprint;
+    uint64_t clock;    // clock of the last time a way was touched
+    uint8_t  load[POLICY_LRU_MATRIX_WAYS];
+    uint8_t  dirty[POLICY_LRU_MATRIX_WAYS];
+    uint8_t  touched;  // ways touched at that clock
+    uint8_t  padding[7];
+    uint64_t line_id[];
+} policy_lru_set_t;
+
+/* Sets with a bit matrix only use sets, each followed by the tags of its
+ * ways. The others use line_id, fingerprint and ways: tags are indexed by
+ * set * stride + way, fingerprints by set * words + way / 8 and list entries
+ * by set * (associativity + 1) + way.
+ */
+typedef struct {
+    uint64_t *line_id;
+    uint64_t *fingerprint;
+    policy_lru_way_t *ways;
+    policy_lru_set_t *sets;
+    int words;         // fingerprint words per set
+    int stride;        // tags per set
 } policy_lru_t;
 
 #ifdef __cplusplus
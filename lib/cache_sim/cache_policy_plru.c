@@ -71,12 +71,15 @@ int policy_plru_init(cache_handle_t *cache) {
         /* write UINT64_MAX in all blocks... */
         block->line_id = UINT64_MAX;
         block->load = LOAD_ACCESS;
+        block->dirty = 0;
     }
 
     /* print out how much memory it requires */
-    printf("Memory required: %9d bytes\n",
-        ((sizeof(policy_plru_t) * cache->total_lines) +
-        (cache->total_sets * sizeof(uint64_t))));
+    if (cache_sim_verbose) {
+        printf("Memory required: %9d bytes\n",
+            ((sizeof(policy_plru_t) * cache->total_lines) +
+            (cache->total_sets * sizeof(uint64_t))));
+    }
 
     return CACHE_SIM_SUCCESS;
 }
@@ -84,10 +87,10 @@ int policy_plru_init(cache_handle_t *cache) {
 /* policy_plru_access */
 int policy_plru_access(cache_handle_t *cache, const uint64_t line_id,
     const load_t load) {
-    static policy_plru_t *way_addr = NULL;
-    static uint64_t *plru_mask = NULL;
-    static uint64_t set = UINT64_MAX;
-    static int way = 0, i = 0;
+    policy_plru_t *way_addr = NULL;
+    uint64_t *plru_mask = NULL;
+    uint64_t set = UINT64_MAX;
+    int way = 0, i = 0;
     int bit = 0, bit_set = 0, bit_offset = 0;
 
     /* calculate set for this address */
@@ -110,6 +113,11 @@ int policy_plru_access(cache_handle_t *cache, const uint64_t line_id,
             printf("HIT    line id [%018p] set [%2d:%d]\n", line_id, set, way);
             #endif
 
+            /* writes leave the line dirty */
+            if (LOAD_WRITE == load) {
+                way_addr->dirty = 1;
+            }
+
             /* update PLRU mask by inverting the bits used by this way */
             for (i = 0; i < (int)log2(cache->associativity); i++) {
                 /* find out which bit should be toggled */
@@ -127,8 +135,9 @@ int policy_plru_access(cache_handle_t *cache, const uint64_t line_id,
             }
 
             /* if the hit was on a prefetched line */
-            if (LOAD_PREFETCH == way_addr->load) {
+            if (LOAD_IS_PREFETCH(way_addr->load)) {
                 /* reset load reason */
+                cache->prefetch_load = way_addr->load;
                 way_addr->load = LOAD_ACCESS;
 
                 return (CACHE_SIM_L1_HIT + CACHE_SIM_L1_HIT_PREFETCH);
@@ -177,18 +186,62 @@ int policy_plru_access(cache_handle_t *cache, const uint64_t line_id,
         set, way, load);
     #endif
 
+    /* report the evicted line, if any */
+    cache->victim = way_addr->line_id;
+    cache->victim_dirty = way_addr->dirty;
+
     /* if the evicted line was prefetched and never accessed */
-    if (LOAD_PREFETCH == way_addr->load) {
+    if (LOAD_IS_PREFETCH(way_addr->load)) {
+        cache->prefetch_load = way_addr->load;
+
         /* load the data */
         way_addr->line_id = line_id;
-        way_addr->load = load;
+        way_addr->load = (LOAD_WRITE == load) ? LOAD_ACCESS : load;
+        way_addr->dirty = (LOAD_WRITE == load);
 
         return (CACHE_SIM_L1_MISS + CACHE_SIM_L1_PREFETCH_EVICT);
     }
 
     /* load the data */
     way_addr->line_id = line_id;
-    way_addr->load = load;
+    way_addr->load = (LOAD_WRITE == load) ? LOAD_ACCESS : load;
+    way_addr->dirty = (LOAD_WRITE == load);
+
+    return CACHE_SIM_L1_MISS;
+}
+
+/* policy_plru_invalidate */
+int policy_plru_invalidate(cache_handle_t *cache, const uint64_t line_id) {
+    policy_plru_t *way_addr = NULL;
+    uint64_t set = UINT64_MAX;
+    int way = 0;
+
+    /* calculate set for this address */
+    set = line_id;
+    CACHE_SIM_LINE_ID_TO_SET(set);
+
+    /* calculate the base address of the first way on the set */
+    way_addr = (policy_plru_t *)((uint64_t)cache->data +
+        (cache->total_sets * sizeof(uint64_t)) +
+        (set * cache->associativity * sizeof(policy_plru_t)));
+
+    /* the PLRU mask is left untouched, the empty way is replaced in turn */
+    for (way = 0; way < cache->associativity; way++, way_addr++) {
+        if (line_id == way_addr->line_id) {
+            #ifdef DEBUG
+            printf("INVAL  line id [%018p] set [%2d:%d]\n", line_id, set, way);
+            #endif
+
+            cache->victim = line_id;
+            cache->victim_dirty = way_addr->dirty;
+
+            way_addr->line_id = UINT64_MAX;
+            way_addr->load = LOAD_ACCESS;
+            way_addr->dirty = 0;
+
+            return CACHE_SIM_L1_HIT;
+        }
+    }
 
     return CACHE_SIM_L1_MISS;
 }
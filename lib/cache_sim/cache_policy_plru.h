@@ -44,11 +44,13 @@ extern "C" {
 int policy_plru_init(cache_handle_t *cache);
 int policy_plru_access(cache_handle_t *cache, const uint64_t line_id,
     const load_t load);
+int policy_plru_invalidate(cache_handle_t *cache, const uint64_t line_id);
 
 typedef struct {
     uint64_t line_id;
     uint8_t  load;
-    uint8_t  padding[7];
+    uint8_t  dirty;
+    uint8_t  padding[6];
 } policy_plru_t;
 
 #ifdef __cplusplus
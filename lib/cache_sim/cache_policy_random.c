@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <stdint.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_util.h"
+#include "cache_policy_fill.h"
+#include "cache_policy_random.h"
+
+/* random_victim */
+static int random_victim(const uint64_t *stamps, const int associativity,
+    const uint64_t loads, uint64_t *state) {
+    return (int)(random_next(state) % associativity);
+}
+
+/* policy_random_init */
+int policy_random_init(cache_handle_t *cache) {
+    policy_fill_t *fill = NULL;
+    uint64_t i = 0;
+
+    if (CACHE_SIM_SUCCESS != policy_fill_init(cache)) {
+        return CACHE_SIM_ERROR;
+    }
+
+    /* each set has its own generator */
+    fill = (policy_fill_t *)cache->data;
+    for (i = 0; i < cache->total_sets; i++) {
+        fill->state[i] = random_seed(i + 1);
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* policy_random_access */
+int policy_random_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return policy_fill_access(cache, line_id, load, &random_victim);
+}
+
+// EOF
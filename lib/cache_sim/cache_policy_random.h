@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef CACHE_POLICY_RANDOM_H_
+#define CACHE_POLICY_RANDOM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CACHE_SIM_H_
+#include "cache_sim.h"
+#endif
+
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+
+int policy_random_init(cache_handle_t *cache);
+int policy_random_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load);
+
+/* Victims are chosen at random among the ways of the set, empty ways are
+ * used first. Each set has its own generator, so results do not depend on
+ * how sets are interleaved (or split among threads).
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_POLICY_RANDOM_H_ */
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_util.h"
+#include "cache_policy_rrip.h"
+
+/* policy_rrip_init */
+int policy_rrip_init(cache_handle_t *cache) {
+    /* sanity check: does cache exist? */
+    if (NULL == cache) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration and initialization */
+    policy_rrip_t *rrip = NULL;
+    size_t size = 0;
+    uint64_t i = 0;
+
+    /* allocate the handle and all arrays in a single data area */
+    size = sizeof(policy_rrip_t) +
+        (cache->total_lines * sizeof(policy_rrip_way_t)) +
+        (cache->total_sets * sizeof(uint64_t));
+    rrip = (policy_rrip_t *)malloc(size);
+
+    if (NULL == rrip) {
+        printf("Error: unable to allocate memory for cache data\n");
+        return CACHE_SIM_ERROR;
+    }
+    cache->data = rrip;
+
+    rrip->ways = (policy_rrip_way_t *)(rrip + 1);
+    rrip->random = (uint64_t *)(rrip->ways + cache->total_lines);
+
+    /* leaders are spread over the cache, small caches only have leaders */
+    rrip->duel = cache->total_sets / POLICY_RRIP_LEADERS;
+    if (2 > rrip->duel) {
+        rrip->duel = 2;
+    }
+    rrip->psel = POLICY_RRIP_PSEL / 2;
+
+    /* initialize data area */
+    for (i = 0; i < cache->total_lines; i++) {
+        rrip->ways[i].line_id = UINT64_MAX;
+        rrip->ways[i].rrpv    = POLICY_RRIP_DISTANT;
+        rrip->ways[i].load    = LOAD_ACCESS;
+        rrip->ways[i].dirty   = 0;
+    }
+    for (i = 0; i < cache->total_sets; i++) {
+        rrip->random[i] = random_seed(i + 1);
+    }
+
+    if (cache_sim_verbose) {
+        printf("Memory required: %9d bytes\n", (int)(sizeof(cache_handle_t) +
+            size));
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* rrip_access */
+static inline int rrip_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load, const int bimodal) {
+    policy_rrip_t *rrip = (policy_rrip_t *)cache->data;
+    policy_rrip_way_t *ways = NULL;
+    uint64_t set = line_id;
+    int way = 0, victim = -1, rrpv = -1, i = 0;
+
+    /* calculate set for this address */
+    CACHE_SIM_LINE_ID_TO_SET(set);
+    ways = &(rrip->ways[set * cache->associativity]);
+
+    /* look for the line, and for the most distant way of the set */
+    for (way = 0; way < cache->associativity; way++) {
+        if (line_id == ways[way].line_id) {
+            #ifdef DEBUG
+            printf("HIT    line id [%018p] set [%2d:%d]\n", line_id, set, way);
+            #endif
+
+            /* writes leave the line dirty */
+            if (LOAD_WRITE == load) {
+                ways[way].dirty = 1;
+            }
+
+            /* the line is expected again soon */
+            ways[way].rrpv = 0;
+
+            /* if the hit was on a prefetched line */
+            if (LOAD_IS_PREFETCH(ways[way].load)) {
+                /* reset load reason */
+                cache->prefetch_load = ways[way].load;
+                ways[way].load = LOAD_ACCESS;
+
+                return (CACHE_SIM_L1_HIT + CACHE_SIM_L1_HIT_PREFETCH);
+            }
+
+            return CACHE_SIM_L1_HIT;
+        }
+
+        /* empty ways are used first */
+        if (UINT64_MAX == ways[way].line_id) {
+            if (POLICY_RRIP_DISTANT + 1 != rrpv) {
+                victim = way;
+                rrpv = POLICY_RRIP_DISTANT + 1;
+            }
+        } else if (rrpv < ways[way].rrpv) {
+            victim = way;
+            rrpv = ways[way].rrpv;
+        }
+    }
+
+    /* age the whole set until the victim has a distant prediction */
+    if (POLICY_RRIP_DISTANT > rrpv) {
+        for (i = 0; i < cache->associativity; i++) {
+            ways[i].rrpv += POLICY_RRIP_DISTANT - rrpv;
+        }
+    }
+
+    #ifdef DEBUG
+    printf("MISS   line id [%018p]\n", line_id);
+    printf("LOAD   line id [%018p] set [%2d:%d] load reason [%d]\n", line_id,
+        set, victim, load);
+    #endif
+
+    /* report the evicted line, if any */
+    cache->victim = ways[victim].line_id;
+    cache->victim_dirty = ways[victim].dirty;
+
+    /* SRRIP inserts with a long prediction, BRRIP mostly with a distant one */
+    ways[victim].rrpv = POLICY_RRIP_LONG;
+    if (bimodal &&
+        (0 != (random_next(&(rrip->random[set])) % POLICY_RRIP_BIMODAL))) {
+        ways[victim].rrpv = POLICY_RRIP_DISTANT;
+    }
+
+    /* if the evicted line was prefetched and never accessed */
+    if (LOAD_IS_PREFETCH(ways[victim].load)) {
+        cache->prefetch_load = ways[victim].load;
+
+        /* load the data */
+        ways[victim].line_id = line_id;
+        ways[victim].load = (LOAD_WRITE == load) ? LOAD_ACCESS : load;
+        ways[victim].dirty = (LOAD_WRITE == load);
+
+        return (CACHE_SIM_L1_MISS + CACHE_SIM_L1_PREFETCH_EVICT);
+    }
+
+    /* load the data */
+    ways[victim].line_id = line_id;
+    ways[victim].load = (LOAD_WRITE == load) ? LOAD_ACCESS : load;
+    ways[victim].dirty = (LOAD_WRITE == load);
+
+    return CACHE_SIM_L1_MISS;
+}
+
+/* policy_srrip_access */
+int policy_srrip_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return rrip_access(cache, line_id, load, 0);
+}
+
+/* policy_brrip_access */
+int policy_brrip_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    return rrip_access(cache, line_id, load, 1);
+}
+
+/* policy_drrip_access */
+int policy_drrip_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    policy_rrip_t *rrip = (policy_rrip_t *)cache->data;
+    uint64_t set = line_id;
+    int rc = CACHE_SIM_ERROR;
+
+    /* calculate set for this address */
+    CACHE_SIM_LINE_ID_TO_SET(set);
+
+    /* SRRIP leaders, their misses push the followers towards BRRIP */
+    if (0 == (set % rrip->duel)) {
+        rc = rrip_access(cache, line_id, load, 0);
+        if ((CACHE_SIM_L1_MISS & rc) && (POLICY_RRIP_PSEL - 1 > rrip->psel)) {
+            rrip->psel++;
+        }
+        return rc;
+    }
+
+    /* BRRIP leaders, their misses push the followers towards SRRIP */
+    if (1 == (set % rrip->duel)) {
+        rc = rrip_access(cache, line_id, load, 1);
+        if ((CACHE_SIM_L1_MISS & rc) && (0 < rrip->psel)) {
+            rrip->psel--;
+        }
+        return rc;
+    }
+
+    /* followers */
+    return rrip_access(cache, line_id, load,
+        (POLICY_RRIP_PSEL / 2) <= rrip->psel);
+}
+
+/* policy_rrip_invalidate */
+int policy_rrip_invalidate(cache_handle_t *cache, const uint64_t line_id) {
+    policy_rrip_t *rrip = (policy_rrip_t *)cache->data;
+    policy_rrip_way_t *ways = NULL;
+    uint64_t set = line_id;
+    int way = 0;
+
+    /* calculate set for this address */
+    CACHE_SIM_LINE_ID_TO_SET(set);
+    ways = &(rrip->ways[set * cache->associativity]);
+
+    for (way = 0; way < cache->associativity; way++) {
+        if (line_id == ways[way].line_id) {
+            #ifdef DEBUG
+            printf("INVAL  line id [%018p] set [%2d:%d]\n", line_id, set, way);
+            #endif
+
+            cache->victim = line_id;
+            cache->victim_dirty = ways[way].dirty;
+
+            ways[way].line_id = UINT64_MAX;
+            ways[way].rrpv = POLICY_RRIP_DISTANT;
+            ways[way].load = LOAD_ACCESS;
+            ways[way].dirty = 0;
+
+            return CACHE_SIM_L1_HIT;
+        }
+    }
+
+    return CACHE_SIM_L1_MISS;
+}
+
+// EOF
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef CACHE_POLICY_RRIP_H_
+#define CACHE_POLICY_RRIP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CACHE_SIM_H_
+#include "cache_sim.h"
+#endif
+
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+
+int policy_rrip_init(cache_handle_t *cache);
+int policy_srrip_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load);
+int policy_brrip_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load);
+int policy_drrip_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load);
+int policy_rrip_invalidate(cache_handle_t *cache, const uint64_t line_id);
+
+/* Re-reference interval prediction (Jaleel et al., ISCA 2010) with 2-bit
+ * predictions. Hits predict a near re-reference, SRRIP inserts lines with a
+ * long one and BRRIP with a distant one (long once every POLICY_RRIP_BIMODAL
+ * insertions). DRRIP duels both on POLICY_RRIP_LEADERS sets each and lets
+ * the remaining sets follow the one missing less, as told by psel.
+ */
+#define POLICY_RRIP_DISTANT 3
+#define POLICY_RRIP_LONG    2
+#define POLICY_RRIP_BIMODAL 32
+#define POLICY_RRIP_LEADERS 32
+#define POLICY_RRIP_PSEL    1024
+
+typedef struct {
+    uint64_t line_id;
+    uint8_t  rrpv;     // re-reference prediction value
+    uint8_t  load;
+    uint8_t  dirty;
+    uint8_t  padding[5];
+} policy_rrip_way_t;
+
+typedef struct {
+    policy_rrip_way_t *ways;
+    uint64_t *random;  // per set state of the BRRIP insertions
+    uint64_t duel;     // a set leads if (set % duel) is 0 (SRRIP) or 1 (BRRIP)
+    int psel;          // grows when SRRIP leaders miss
+    int padding;
+} policy_rrip_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_POLICY_RRIP_H_ */
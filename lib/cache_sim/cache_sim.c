@@ -31,16 +31,24 @@
 #include "cache_sim.h"
 #include "cache_sim_types.h"
 #include "cache_sim_reuse.h"
+#include "cache_sim_mrc.h"
 #include "cache_sim_symbol.h"
-#include "cache_policy_lru.h"
-#include "cache_policy_plru.h"
+#include "cache_sim_parallel.h"
+#include "cache_sim_prefetcher.h"
+#include "cache_sim_policy.h"
 
-/* List of policies */
-static policy_t policies[] = {
-    { "lru",  &policy_lru_init,  &policy_lru_access  },
-    { "plru", &policy_plru_init, &policy_plru_access },
-    { NULL,   NULL,              NULL,               }
-};
+/* Informational output is on by default */
+int cache_sim_verbose = 1;
+
+/* cache_sim_set_verbose */
+void cache_sim_set_verbose(const int verbose) {
+    cache_sim_verbose = verbose;
+}
+
+/* cache_sim_get_verbose */
+int cache_sim_get_verbose(void) {
+    return cache_sim_verbose;
+}
 
 /* cache_sim_init */
 cache_handle_t* cache_sim_init(const unsigned int total_size,
@@ -54,7 +62,9 @@ cache_handle_t* cache_sim_init(const unsigned int total_size,
     /* variables declaration and initialization */
     cache_handle_t *cache = NULL;
 
-    printf("--------------------------------\n");
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+    }
 
     /* create the cache */
     if (NULL == (cache = cache_create(total_size, line_size, associativity))) {
@@ -67,8 +77,10 @@ cache_handle_t* cache_sim_init(const unsigned int total_size,
         return NULL;
     }
 
-    printf(" Cache initialized successfully \n");
-    printf("--------------------------------\n");
+    if (cache_sim_verbose) {
+        printf(" Cache initialized successfully \n");
+        printf("--------------------------------\n");
+    }
 
     return cache;
 }
@@ -80,28 +92,45 @@ int cache_sim_fini(cache_handle_t *cache) {
         cache_sim_reuse_disable(cache);
     }
 
+    /* is the miss ratio curve enabled? */
+    if (NULL != cache->mrc_data) {
+        cache_sim_mrc_disable(cache);
+    }
+
     /* is symbols tracking enabled? */
     if (NULL != cache->symbol_data) {
         cache_sim_symbol_disable(cache);
     }
 
-    printf("--------------------------------\n");
-    printf("Total accesses: %16"PRIu64"\n", cache->access);
-    printf("Cache hits:     %16"PRIu64"\n", cache->hit);
-    printf(" -> rate        %15.2f%%\n",
-        (((double)cache->hit / (double)cache->access) * 100));
-    printf(" -> prefetched  %16"PRIu64"\n", cache->prefetcher_hit);
-    printf("Cache misses:   %16"PRIu64"\n", cache->miss);
-    printf(" -> rate        %15.2f%%\n",
-        (((double)cache->miss / (double)cache->access) * 100));
-    printf("Set conflicts:  %16"PRIu64"\n", cache->conflict);
-    printf(" -> rate        %15.2f%%\n",
-        (((double)cache->conflict / (double)cache->miss) * 100));
-    printf("Prefetcher:                     \n");
-    printf(" -> next line   %16"PRIu64"\n", cache->prefetcher_next_line);
-    printf(" -> pollution   %16"PRIu64"\n", cache->prefetcher_evict);
-    printf("  Cache finalized successfully  \n");
-    printf("--------------------------------\n");
+    /* is parallel simulation enabled? (merges per thread counters) */
+    if (NULL != cache->thread_stats) {
+        cache_sim_parallel_disable(cache);
+    }
+
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf("Total accesses: %16"PRIu64"\n", cache->access);
+        printf("Cache hits:     %16"PRIu64"\n", cache->hit);
+        printf(" -> rate        %15.2f%%\n",
+            (((double)cache->hit / (double)cache->access) * 100));
+        printf(" -> prefetched  %16"PRIu64"\n", cache->prefetcher_hit);
+        printf("Cache misses:   %16"PRIu64"\n", cache->miss);
+        printf(" -> rate        %15.2f%%\n",
+            (((double)cache->miss / (double)cache->access) * 100));
+        printf("Set conflicts:  %16"PRIu64"\n", cache->conflict);
+        printf(" -> rate        %15.2f%%\n",
+            (((double)cache->conflict / (double)cache->miss) * 100));
+        printf("Prefetcher:                     \n");
+        printf(" -> next line   %16"PRIu64"\n", cache->prefetcher_next_line);
+        printf(" -> pollution   %16"PRIu64"\n", cache->prefetcher_evict);
+        printf("  Cache finalized successfully  \n");
+        printf("--------------------------------\n");
+    }
+
+    /* are prefetchers statistics being collected? */
+    if (NULL != cache->prefetcher_data) {
+        cache_sim_prefetcher_fini(cache);
+    }
 
     /* destroy the cache and free memory */
     cache_destroy(cache);
@@ -132,19 +161,37 @@ static cache_handle_t* cache_create(const unsigned int total_size,
     cache->set_length    = (int)log2(cache->total_sets);
 
     /* replacement policy */
-    cache->access_fn = NULL;
-    cache->data      = NULL;
+    cache->access_fn     = NULL;
+    cache->invalidate_fn = NULL;
+    cache->set_local     = 1;
+    cache->clock         = 0;
+    cache->victim        = UINT64_MAX;
+    cache->victim_dirty  = 0;
+    cache->demand_victim = UINT64_MAX;
+    cache->prefetch_load = LOAD_ACCESS;
+    cache->data          = NULL;
 
     /* reused distance */
     cache->reuse_data  = NULL;
     cache->reuse_limit = 0;
     cache->reuse_fn    = NULL;
 
+    /* miss ratio curve */
+    cache->mrc_data = NULL;
+
     /* symbols tracking */
     cache->symbol_data = NULL;
 
     /* prefetchers */
     cache->next_line = PREFETCHER_INVALID;
+    cache->prefetcher_data = NULL;
+
+    /* parallel simulation */
+    cache->threads      = 1;
+    cache->thread_stats = NULL;
+
+    /* cache hierarchy */
+    cache->level = 0;
 
     /* initialize performance counters */
     cache->hit                  = 0;
@@ -154,15 +201,19 @@ static cache_handle_t* cache_create(const unsigned int total_size,
     cache->prefetcher_next_line = 0;
     cache->prefetcher_hit       = 0;
     cache->prefetcher_evict     = 0;
-
-    printf("   Cache created successfully   \n");
-    printf("Cache size:      %9d bytes\n", cache->total_size);
-    printf("Line length:     %9d bytes\n", cache->line_size);
-    printf("Number of lines: %15d\n", cache->total_lines);
-    printf("Associativity:   %15d\n", cache->associativity);
-    printf("Number of sets:  %15d\n", cache->total_sets);
-    printf("Offset length:   %10d bits\n", cache->offset_length);
-    printf("Set length:      %10d bits\n", cache->set_length);
+    cache->writeback            = 0;
+    cache->invalidation         = 0;
+
+    if (cache_sim_verbose) {
+        printf("   Cache created successfully   \n");
+        printf("Cache size:      %9d bytes\n", cache->total_size);
+        printf("Line length:     %9d bytes\n", cache->line_size);
+        printf("Number of lines: %15d\n", cache->total_lines);
+        printf("Associativity:   %15d\n", cache->associativity);
+        printf("Number of sets:  %15d\n", cache->total_sets);
+        printf("Offset length:   %10d bits\n", cache->offset_length);
+        printf("Set length:      %10d bits\n", cache->set_length);
+    }
 
     return cache;
 }
@@ -179,29 +230,30 @@ static void cache_destroy(cache_handle_t *cache) {
 
 /* set_policy */
 static int set_policy(cache_handle_t *cache, const char *policy) {
-    int i = 0;
+    /* find the requested policy (built-in or registered) */
+    const policy_t *found = cache_sim_policy_find(policy);
 
-    /* find the requested policy and set the function */
-    while (NULL != policies[i].name) {
-        if (0 == strcmp(policy, policies[i].name)) {
-
-            /* set the policy function */
-            cache->access_fn = policies[i].access_fn;
+    if (NULL == found) {
+        printf("replacement policy not found\n");
+        return CACHE_SIM_ERROR;
+    }
 
-            printf("Replacem policy: %15s\n", policy);
+    /* set the policy function */
+    cache->access_fn = found->access_fn;
+    cache->invalidate_fn = found->invalidate_fn;
+    cache->set_local = found->set_local;
 
-            /* initialize the data area */
-            if (CACHE_SIM_SUCCESS != policies[i].init_fn(cache)) {
-                printf("error initializing the cache data area\n");
-            }
+    if (cache_sim_verbose) {
+        printf("Replacem policy: %15s\n", policy);
+    }
 
-            return CACHE_SIM_SUCCESS;
-        }
-        i++;
+    /* initialize the data area */
+    if (CACHE_SIM_SUCCESS != found->init_fn(cache)) {
+        printf("error initializing the cache data area\n");
+        return CACHE_SIM_ERROR;
     }
 
-    printf("replacement policy not found\n");
-    return CACHE_SIM_ERROR;
+    return CACHE_SIM_SUCCESS;
 }
 
 // EOF
@@ -46,16 +46,29 @@ extern "C" {
 
 /* Some limitations */
 #define CACHE_SIM_SYMBOL_MAX_LENGTH 40
+#define CACHE_SIM_BATCH_LENGTH      1024
 
 /* Type declaration: the cache itself */
 typedef struct cache_handle cache_handle_t;
 
+/* Type declaration: a hierarchy of caches */
+typedef struct cache_hierarchy cache_hierarchy_t;
+
+/* Type declaration: private caches of several cores and a shared cache */
+typedef struct cache_coherence cache_coherence_t;
+
 /* Functions declaration */
 cache_handle_t* cache_sim_init(const unsigned int total_size,
     const unsigned int line_size, const unsigned int associativity,
     const char *policy);
 int cache_sim_fini(cache_handle_t *cache);
 int cache_sim_access(cache_handle_t *cache, const uint64_t address);
+int cache_sim_access_ip(cache_handle_t *cache, const uint64_t address,
+    const uint64_t ip);
+int cache_sim_access_batch(cache_handle_t *cache, const uint64_t *address,
+    const uint8_t *write, const size_t count, int *level);
+void cache_sim_set_verbose(const int verbose);
+int cache_sim_get_verbose(void);
 
 static cache_handle_t* cache_create(const unsigned int total_size,
     const unsigned int line_size, const unsigned int associativity);
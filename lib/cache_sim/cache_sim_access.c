@@ -29,15 +29,20 @@
 #include "cache_sim_types.h"
 #include "cache_sim_util.h"
 #include "cache_sim_reuse.h"
+#include "cache_sim_mrc.h"
+#include "cache_sim_parallel.h"
+#include "cache_sim_prefetcher.h"
 
-/* cache_sim_access */
-int cache_sim_access(cache_handle_t *cache, const uint64_t address) {
+/* access */
+static inline int access(cache_handle_t *cache, const uint64_t address,
+    const uint64_t ip) {
     /* variables declaration */
-    static int rc = CACHE_SIM_ERROR;
-    static uint64_t line_id = UINT64_MAX;
+    int rc = CACHE_SIM_ERROR;
+    uint64_t line_id = UINT64_MAX;
 
     /* increment access counter */
     cache->access++;
+    cache->clock++;
 
     /* calculate tag and set for this address */
     line_id = address;
@@ -48,7 +53,16 @@ int cache_sim_access(cache_handle_t *cache, const uint64_t address) {
     #endif
 
     /* call the replacement algorithm access function and evaluate the result */
-    switch (rc = cache->access_fn(cache, line_id, LOAD_ACCESS)) {
+    rc = cache->access_fn(cache, line_id, LOAD_ACCESS);
+    cache->demand_victim = (CACHE_SIM_L1_MISS & rc) ? cache->victim :
+        UINT64_MAX;
+
+    /* account for prefetched lines before new prefetches are issued */
+    if (NULL != cache->prefetcher_data) {
+        cache_sim_prefetcher_account(cache, line_id, rc);
+    }
+
+    switch (rc) {
         /* hit on a prefetched line */
         case CACHE_SIM_L1_HIT + CACHE_SIM_L1_HIT_PREFETCH: // fallover!
             /* increment prefetcher hits counter */
@@ -58,8 +72,8 @@ int cache_sim_access(cache_handle_t *cache, const uint64_t address) {
             if (PREFETCHER_NEXT_LINE_TAGGED == cache->next_line) {
                 /* if the next line load evicts a prefetched line */
                 if ((CACHE_SIM_L1_MISS + CACHE_SIM_L1_PREFETCH_EVICT) ==
-                    cache->access_fn(cache, (line_id + cache->line_size),
-                        LOAD_PREFETCH)) {
+                    cache_sim_prefetcher_issue(cache,
+                        (line_id + cache->line_size), LOAD_PREFETCH)) {
                     /* increment prefetched evicted lines counter */
                     cache->prefetcher_evict++;
                 }
@@ -91,8 +105,8 @@ int cache_sim_access(cache_handle_t *cache, const uint64_t address) {
                (PREFETCHER_NEXT_LINE_TAGGED == cache->next_line)) {
                 /* if the next line load evicts a prefetched line */
                 if ((CACHE_SIM_L1_MISS + CACHE_SIM_L1_PREFETCH_EVICT) ==
-                    cache->access_fn(cache, (line_id + cache->line_size),
-                        LOAD_PREFETCH)) {
+                    cache_sim_prefetcher_issue(cache,
+                        (line_id + cache->line_size), LOAD_PREFETCH)) {
                     /* increment prefetched evicted lines counter */
                     cache->prefetcher_evict++;
                 }
@@ -107,6 +121,16 @@ int cache_sim_access(cache_handle_t *cache, const uint64_t address) {
             break;
     }
 
+    /* train the stride and stream prefetchers */
+    if (NULL != cache->prefetcher_data) {
+        cache_sim_prefetcher_train(cache, address, ip, rc);
+    }
+
+    /* count the stack distance for the miss ratio curve */
+    if (NULL != cache->mrc_data) {
+        cache_sim_mrc_access(cache, line_id);
+    }
+
     /* calculate reuse distance and check for set associative conflicts */
     if (NULL != cache->reuse_data) {
         /* check for set associativity conflicts */
@@ -131,4 +155,85 @@ int cache_sim_access(cache_handle_t *cache, const uint64_t address) {
     return rc;
 }
 
+/* cache_sim_access */
+int cache_sim_access(cache_handle_t *cache, const uint64_t address) {
+    return access(cache, address, 0);
+}
+
+/* cache_sim_access_ip */
+int cache_sim_access_ip(cache_handle_t *cache, const uint64_t address,
+    const uint64_t ip) {
+    return access(cache, address, ip);
+}
+
+/* cache_sim_access_batch */
+int cache_sim_access_batch(cache_handle_t *cache, const uint64_t *address,
+    const uint8_t *write, const size_t count, int *level) {
+    /* sanity check: does cache exist? */
+    if ((NULL == cache) || (NULL == address)) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    uint64_t line_id[CACHE_SIM_BATCH_LENGTH];
+    uint64_t mask = ~(((uint64_t)1 << cache->offset_length) - 1);
+    uint64_t hit = 0;
+    size_t base = 0, length = 0, i = 0;
+    int rc = CACHE_SIM_ERROR;
+
+    /* prefetchers, reuse distance and miss ratio curves need the full path
+     * for every access
+     */
+    if ((PREFETCHER_INVALID != cache->next_line) ||
+        (NULL != cache->prefetcher_data) || (NULL != cache->reuse_data) ||
+        (NULL != cache->mrc_data)) {
+        for (i = 0; i < count; i++) {
+            rc = cache_sim_access(cache, address[i]);
+            if (NULL != level) {
+                level[i] = (CACHE_SIM_L1_HIT & rc) ? 1 : 2;
+            }
+        }
+        return CACHE_SIM_SUCCESS;
+    }
+
+    /* sets are independent, so threads can share them out */
+    if (NULL != cache->thread_stats) {
+        return cache_sim_parallel_access_batch(cache, address, write, count,
+            level);
+    }
+
+    for (base = 0; base < count; base += CACHE_SIM_BATCH_LENGTH) {
+        length = count - base;
+        if (CACHE_SIM_BATCH_LENGTH < length) {
+            length = CACHE_SIM_BATCH_LENGTH;
+        }
+
+        /* calculate all line ids first, this loop vectorizes */
+        for (i = 0; i < length; i++) {
+            line_id[i] = address[base + i] & mask;
+        }
+
+        /* then run the replacement algorithm, counting hits on the way */
+        for (i = 0; i < length; i++) {
+            cache->clock++;
+            rc = cache->access_fn(cache, line_id[i],
+                ((NULL != write) && write[base + i]) ? LOAD_WRITE :
+                    LOAD_ACCESS);
+            hit += (CACHE_SIM_L1_HIT & rc) ? 1 : 0;
+
+            if (NULL != level) {
+                level[base + i] = (CACHE_SIM_L1_HIT & rc) ? 1 : 2;
+            }
+        }
+    }
+
+    /* update performance counters once per batch */
+    cache->access += count;
+    cache->hit += hit;
+    cache->miss += count - hit;
+
+    return CACHE_SIM_SUCCESS;
+}
+
 // EOF
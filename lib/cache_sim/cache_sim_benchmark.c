@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* Measures accesses per second of the simulator for each replacement policy
+ * and each feature, so changes that slow one of them down show up. Results
+ * can be saved with -o and compared against on a later run with -b.
+ *
+ *   make benchmark
+ *   ./cache_sim_benchmark -n 16M -o before.csv
+ *   ./cache_sim_benchmark -n 16M -b before.csv
+ */
+
+/* System standard headers */
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_coherence.h"
+#include "cache_sim_conflict.h"
+#include "cache_sim_hierarchy.h"
+#include "cache_sim_mrc.h"
+#include "cache_sim_parallel.h"
+#include "cache_sim_prefetcher.h"
+#include "cache_sim_reuse.h"
+#include "cache_sim_symbol.h"
+
+/* Default # of accesses and # of runs of each benchmark (the best counts) */
+#define BENCHMARK_ACCESSES (8 * 1024 * 1024)
+#define BENCHMARK_RUNS     3
+#define BENCHMARK_CORES    4
+#define BENCHMARK_SYMBOLS  64
+
+/* What each benchmark exercises */
+typedef enum {
+    KIND_BATCH,
+    KIND_ACCESS,
+    KIND_PREFETCHER,
+    KIND_REUSE,
+    KIND_CONFLICT,
+    KIND_MRC,
+    KIND_SYMBOLS,
+    KIND_HIERARCHY,
+    KIND_COHERENCE
+} kind_t;
+
+/* Benchmark description, parameter depends on the kind */
+typedef struct {
+    const char *name;
+    kind_t kind;
+    const char *policy;
+    int parameter;
+    int threads;
+} benchmark_t;
+
+/* Synthetic trace shared by all benchmarks */
+typedef struct {
+    uint64_t *address;
+    uint64_t *ip;
+    uint8_t *write;
+    uint8_t *core;
+    size_t length;
+} trace_t;
+
+/* The benchmarks */
+static const benchmark_t benchmarks[] = {
+    { "batch lru",          KIND_BATCH,      "lru",    0,                 1 },
+    { "batch plru",         KIND_BATCH,      "plru",   0,                 1 },
+    { "batch srrip",        KIND_BATCH,      "srrip",  0,                 1 },
+    { "batch brrip",        KIND_BATCH,      "brrip",  0,                 1 },
+    { "batch drrip",        KIND_BATCH,      "drrip",  0,                 1 },
+    { "batch fifo",         KIND_BATCH,      "fifo",   0,                 1 },
+    { "batch random",       KIND_BATCH,      "random", 0,                 1 },
+    { "access lru",         KIND_ACCESS,     "lru",    0,                 1 },
+    { "prefetcher next",    KIND_PREFETCHER, "lru",
+        PREFETCHER_NEXT_LINE_SINGLE, 1 },
+    { "prefetcher tagged",  KIND_PREFETCHER, "lru",
+        PREFETCHER_NEXT_LINE_TAGGED, 1 },
+    { "prefetcher stride",  KIND_PREFETCHER, "lru",    PREFETCHER_STRIDE, 1 },
+    { "prefetcher stream",  KIND_PREFETCHER, "lru",    PREFETCHER_STREAM, 1 },
+    { "reuse 4096",         KIND_REUSE,      "lru",    4096,              1 },
+    { "conflict",           KIND_CONFLICT,   "lru",    0,                 1 },
+    { "mrc 1%",             KIND_MRC,        "lru",    1,                 1 },
+    { "mrc 100%",           KIND_MRC,        "lru",    100,               1 },
+    { "symbols",            KIND_SYMBOLS,    "lru",    BENCHMARK_SYMBOLS, 1 },
+    { "parallel lru",       KIND_BATCH,      "lru",    0,                 4 },
+    { "parallel srrip",     KIND_BATCH,      "srrip",  0,                 4 },
+    { "hierarchy",          KIND_HIERARCHY,  "lru",    0,                 1 },
+    { "coherence mesi",     KIND_COHERENCE,  "lru",    COHERENCE_MESI,    1 },
+    { "coherence moesi",    KIND_COHERENCE,  "lru",    COHERENCE_MOESI,   1 },
+    { "coherence parallel", KIND_COHERENCE,  "lru",    COHERENCE_MESI,    4 }
+};
+
+/* elapsed */
+static double elapsed(struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) +
+        ((end.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/* trace_create */
+static int trace_create(trace_t *trace, const size_t length) {
+    /* variables declaration */
+    uint64_t footprint = 4 * 1024 * 1024, state = 88172645463325252ULL;
+    size_t i = 0;
+
+    trace->length = length;
+    trace->address = (uint64_t *)malloc(length * sizeof(uint64_t));
+    trace->ip = (uint64_t *)malloc(length * sizeof(uint64_t));
+    trace->write = (uint8_t *)malloc(length * sizeof(uint8_t));
+    trace->core = (uint8_t *)malloc(length * sizeof(uint8_t));
+    if ((NULL == trace->address) || (NULL == trace->ip) ||
+        (NULL == trace->write) || (NULL == trace->core)) {
+        printf("Error: unable to allocate memory for the trace\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sequential runs of 8 byte words from a few IPs, mixed with random
+     * accesses over a footprint larger than the first levels
+     */
+    for (i = 0; i < length; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        if ((0 == (i % 32)) || (0 == (state % 3))) {
+            trace->address[i] = (state >> 8) % footprint;
+            trace->ip[i] = 0x400000 + ((state >> 40) % 16);
+        } else {
+            trace->address[i] = trace->address[i - 1] + 8;
+            trace->ip[i] = trace->ip[i - 1];
+        }
+        trace->write[i] = (0 == ((state >> 32) % 4));
+        trace->core[i] = (i / 64) % BENCHMARK_CORES;
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* run_cache */
+static double run_cache(const benchmark_t *benchmark, const trace_t *trace) {
+    /* variables declaration */
+    struct timespec start;
+    cache_handle_t *cache = NULL;
+    uint64_t size = 4 * 1024 * 1024 / BENCHMARK_SYMBOLS;
+    char symbol[CACHE_SIM_SYMBOL_MAX_LENGTH];
+    double seconds = -1;
+    size_t i = 0;
+    int rc = CACHE_SIM_SUCCESS;
+
+    if (NULL == (cache = cache_sim_init(32768, 64, 8, benchmark->policy))) {
+        return -1;
+    }
+
+    switch (benchmark->kind) {
+        case KIND_PREFETCHER:
+            rc = cache_sim_prefetcher_enable(cache, benchmark->parameter);
+            break;
+        case KIND_REUSE:
+            rc = cache_sim_reuse_enable(cache, benchmark->parameter);
+            break;
+        case KIND_CONFLICT:
+            rc = cache_sim_conflict_enable(cache);
+            break;
+        case KIND_MRC:
+            rc = cache_sim_mrc_enable(cache, benchmark->parameter / 100.0);
+            break;
+        case KIND_SYMBOLS:
+            for (i = 0; i < benchmark->parameter; i++) {
+                snprintf(symbol, sizeof(symbol), "array_%d", (int)i);
+                rc |= cache_sim_symbol_insert(cache, symbol, i * size, size);
+            }
+            break;
+        default:
+            break;
+    }
+    if ((CACHE_SIM_SUCCESS == rc) && (1 < benchmark->threads)) {
+        rc = cache_sim_parallel_enable(cache, benchmark->threads);
+    }
+    if (CACHE_SIM_SUCCESS != rc) {
+        cache_sim_fini(cache);
+        return -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    switch (benchmark->kind) {
+        case KIND_BATCH:
+            cache_sim_access_batch(cache, trace->address, trace->write,
+                trace->length, NULL);
+            break;
+        case KIND_PREFETCHER:
+            for (i = 0; i < trace->length; i++) {
+                cache_sim_access_ip(cache, trace->address[i], trace->ip[i]);
+            }
+            break;
+        case KIND_SYMBOLS:
+            for (i = 0; i < trace->length; i++) {
+                cache_sim_symbol_attribute(cache, trace->address[i]);
+            }
+            break;
+        default:
+            for (i = 0; i < trace->length; i++) {
+                cache_sim_access(cache, trace->address[i]);
+            }
+            break;
+    }
+    seconds = elapsed(&start);
+    cache_sim_fini(cache);
+
+    return seconds;
+}
+
+/* run_hierarchy */
+static double run_hierarchy(const benchmark_t *benchmark,
+    const trace_t *trace) {
+    /* variables declaration */
+    cache_level_t levels[] = {
+        { 32768,   64, 8,  NULL, HIERARCHY_NINE },
+        { 262144,  64, 8,  NULL, HIERARCHY_INCLUSIVE },
+        { 2097152, 64, 16, NULL, HIERARCHY_NINE }
+    };
+    struct timespec start;
+    cache_hierarchy_t *hierarchy = NULL;
+    double seconds = -1;
+    int i = 0;
+
+    for (i = 0; i < 3; i++) {
+        levels[i].policy = benchmark->policy;
+    }
+    if (NULL == (hierarchy = cache_sim_hierarchy_init(levels, 3))) {
+        return -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    cache_sim_hierarchy_access_batch(hierarchy, trace->address, trace->write,
+        trace->length, NULL);
+    seconds = elapsed(&start);
+    cache_sim_hierarchy_fini(hierarchy);
+
+    return seconds;
+}
+
+/* run_coherence */
+static double run_coherence(const benchmark_t *benchmark,
+    const trace_t *trace) {
+    /* variables declaration */
+    cache_level_t core = { 32768, 64, 8, NULL, HIERARCHY_NINE };
+    cache_level_t shared = { 2097152, 64, 16, NULL, HIERARCHY_NINE };
+    struct timespec start;
+    cache_coherence_t *coherence = NULL;
+    double seconds = -1;
+
+    core.policy = benchmark->policy;
+    shared.policy = benchmark->policy;
+    if (NULL == (coherence = cache_sim_coherence_init(BENCHMARK_CORES, &core,
+        &shared, benchmark->parameter))) {
+        return -1;
+    }
+    if ((1 < benchmark->threads) && (CACHE_SIM_SUCCESS !=
+        cache_sim_coherence_parallel(coherence, benchmark->threads))) {
+        cache_sim_coherence_fini(coherence);
+        return -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    cache_sim_coherence_access_batch(coherence, trace->core, trace->address,
+        trace->write, trace->length, NULL);
+    seconds = elapsed(&start);
+    cache_sim_coherence_fini(coherence);
+
+    return seconds;
+}
+
+/* baseline_find */
+static double baseline_find(const char *filename, const char *name) {
+    /* variables declaration */
+    char line[256], *comma = NULL;
+    double value = 0;
+    FILE *file = NULL;
+
+    if ((NULL == filename) || (NULL == (file = fopen(filename, "r")))) {
+        return 0;
+    }
+    while (NULL != fgets(line, sizeof(line), file)) {
+        if ((NULL != (comma = strrchr(line, ','))) &&
+            ((comma - line) == strlen(name)) &&
+            (0 == strncmp(line, name, comma - line))) {
+            value = atof(comma + 1);
+            break;
+        }
+    }
+    fclose(file);
+
+    return value;
+}
+
+/* main */
+int main(int argc, char *argv[]) {
+    /* variables declaration */
+    const benchmark_t *benchmark = NULL;
+    const char *baseline = NULL, *outputfile = NULL;
+    size_t accesses = BENCHMARK_ACCESSES;
+    double best = 0, seconds = 0, rate = 0, before = 0;
+    FILE *output = NULL;
+    trace_t trace;
+    char *end = NULL;
+    int b = 0, run = 0, runs = BENCHMARK_RUNS, parameter = 0;
+
+    while (-1 != (parameter = getopt(argc, argv, "b:hn:o:r:"))) {
+        switch (parameter) {
+            case 'b':
+                baseline = optarg;
+                break;
+            case 'n':
+                accesses = strtoull(optarg, &end, 10);
+                if (('k' == *end) || ('K' == *end)) {
+                    accesses <<= 10;
+                } else if (('m' == *end) || ('M' == *end)) {
+                    accesses <<= 20;
+                }
+                break;
+            case 'o':
+                outputfile = optarg;
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            default:
+                printf("Usage: cache_sim_benchmark [-n accesses] [-r runs] "
+                    "[-o file] [-b baseline]\n");
+                exit('h' == parameter ? 0 : 1);
+        }
+    }
+    if ((0 == accesses) || (0 >= runs)) {
+        printf("Error: at least one access and one run are needed\n");
+        exit(1);
+    }
+
+    cache_sim_set_verbose(0);
+    if (CACHE_SIM_SUCCESS != trace_create(&trace, accesses)) {
+        exit(1);
+    }
+    if ((NULL != outputfile) && (NULL == (output = fopen(outputfile, "w")))) {
+        printf("Error: unable to open %s\n", outputfile);
+        exit(1);
+    }
+
+    printf("%-24s %16s", "benchmark", "[acc/s]");
+    printf((NULL != baseline) ? " %16s %8s\n" : "\n", "baseline", "change");
+    for (b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+        benchmark = &(benchmarks[b]);
+
+        /* the fastest run is the least disturbed one */
+        for (run = 0, best = 0; run < runs; run++) {
+            switch (benchmark->kind) {
+                case KIND_HIERARCHY:
+                    seconds = run_hierarchy(benchmark, &trace);
+                    break;
+                case KIND_COHERENCE:
+                    seconds = run_coherence(benchmark, &trace);
+                    break;
+                default:
+                    seconds = run_cache(benchmark, &trace);
+                    break;
+            }
+            if ((0 < seconds) && ((0 == best) || (seconds < best))) {
+                best = seconds;
+            }
+        }
+        if (0 == best) {
+            printf("%-24s %16s\n", benchmark->name, "failed");
+            continue;
+        }
+
+        rate = trace.length / best;
+        printf("%-24s %16.0f", benchmark->name, rate);
+        if (0 < (before = baseline_find(baseline, benchmark->name))) {
+            printf(" %16.0f %+7.1f%%", before, ((rate / before) - 1) * 100);
+        }
+        printf("\n");
+        if (NULL != output) {
+            fprintf(output, "%s,%.0f\n", benchmark->name, rate);
+        }
+    }
+
+    if (NULL != output) {
+        fclose(output);
+    }
+    free(trace.address);
+    free(trace.ip);
+    free(trace.write);
+    free(trace.core);
+
+    exit(0);
+}
+
+// EOF
@@ -0,0 +1,834 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_coherence.h"
+#include "cache_sim_symbol.h"
+
+/* Names of the coherence protocols */
+static const char *protocol_names[] = {
+    "MESI", "MOESI"
+};
+
+/* directory_hash */
+static inline uint64_t directory_hash(directory_t *directory,
+    const uint64_t line_id) {
+    return ((line_id * 0x9E3779B97F4A7C15ULL) >> 32) & directory->mask;
+}
+
+/* directory_init */
+static int directory_init(directory_t *directory, const uint64_t size) {
+    /* variables declaration */
+    uint64_t i = 0;
+
+    directory->entry = (directory_entry_t *)malloc(size *
+        sizeof(directory_entry_t));
+    if (NULL == directory->entry) {
+        printf("Error: unable to allocate memory for the directory\n");
+        return CACHE_SIM_ERROR;
+    }
+    directory->mask = size - 1;
+    directory->total_entries = 0;
+
+    for (i = 0; i < size; i++) {
+        directory->entry[i].line_id = UINT64_MAX;
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* directory_find */
+static inline directory_entry_t* directory_find(directory_t *directory,
+    const uint64_t line_id) {
+    /* variables declaration */
+    uint64_t i = directory_hash(directory, line_id);
+
+    while (UINT64_MAX != directory->entry[i].line_id) {
+        if (line_id == directory->entry[i].line_id) {
+            return &(directory->entry[i]);
+        }
+        i = (i + 1) & directory->mask;
+    }
+
+    return NULL;
+}
+
+/* directory_place */
+static inline directory_entry_t* directory_place(directory_t *directory,
+    const uint64_t line_id) {
+    /* variables declaration */
+    uint64_t i = directory_hash(directory, line_id);
+
+    while (UINT64_MAX != directory->entry[i].line_id) {
+        i = (i + 1) & directory->mask;
+    }
+    directory->total_entries++;
+
+    return &(directory->entry[i]);
+}
+
+/* directory_grow */
+static int directory_grow(directory_t *directory) {
+    /* variables declaration */
+    directory_t old = *directory;
+    uint64_t i = 0;
+
+    if (CACHE_SIM_SUCCESS != directory_init(directory, (old.mask + 1) * 2)) {
+        *directory = old;
+        return CACHE_SIM_ERROR;
+    }
+
+    for (i = 0; i <= old.mask; i++) {
+        if (UINT64_MAX != old.entry[i].line_id) {
+            *directory_place(directory, old.entry[i].line_id) = old.entry[i];
+        }
+    }
+    free(old.entry);
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* directory_insert */
+static directory_entry_t* directory_insert(directory_t *directory,
+    const uint64_t line_id) {
+    /* variables declaration */
+    directory_entry_t *entry = NULL;
+
+    /* keep the table at most half full, so probes stay short */
+    if (((directory->total_entries + 1) * 2) > (directory->mask + 1)) {
+        if (CACHE_SIM_SUCCESS != directory_grow(directory)) {
+            return NULL;
+        }
+    }
+
+    entry = directory_place(directory, line_id);
+    entry->line_id = line_id;
+    entry->sharers = 0;
+    entry->invalidation = 0;
+    entry->upgrade = 0;
+    entry->transfer = 0;
+    entry->owner = COHERENCE_NONE;
+    entry->dirty = 0;
+    entry->padding = 0;
+
+    return entry;
+}
+
+/* directory_remove */
+static void directory_remove(directory_t *directory,
+    directory_entry_t *entry) {
+    /* variables declaration */
+    uint64_t i = entry - directory->entry;
+    uint64_t j = i, home = 0;
+
+    /* shift back the entries of the same probe chain, no tombstones */
+    for (;;) {
+        j = (j + 1) & directory->mask;
+        if (UINT64_MAX == directory->entry[j].line_id) {
+            break;
+        }
+        home = directory_hash(directory, directory->entry[j].line_id);
+        if (((j - home) & directory->mask) >= ((j - i) & directory->mask)) {
+            directory->entry[i] = directory->entry[j];
+            i = j;
+        }
+    }
+    directory->entry[i].line_id = UINT64_MAX;
+    directory->total_entries--;
+}
+
+/* coherence_writeback */
+static void coherence_writeback(cache_handle_t *core, cache_handle_t *shared,
+    const uint64_t line_id) {
+    core->writeback++;
+    shared->clock++;
+    if ((CACHE_SIM_L1_MISS & shared->access_fn(shared, line_id, LOAD_WRITE)) &&
+        (UINT64_MAX != shared->victim) && shared->victim_dirty) {
+        shared->writeback++;
+    }
+}
+
+/* coherence_fill */
+static int coherence_fill(cache_handle_t *shared, coherence_stats_t *stats,
+    const uint64_t line_id) {
+    shared->access++;
+    shared->clock++;
+    if (CACHE_SIM_L1_HIT & shared->access_fn(shared, line_id, LOAD_ACCESS)) {
+        shared->hit++;
+        return COHERENCE_SERVED_SHARED;
+    }
+    shared->miss++;
+    stats->memory++;
+    if ((UINT64_MAX != shared->victim) && shared->victim_dirty) {
+        shared->writeback++;
+    }
+
+    return COHERENCE_SERVED_MEMORY;
+}
+
+/* coherence_invalidate */
+static void coherence_invalidate(cache_handle_t **core,
+    coherence_stats_t *stats, directory_entry_t *entry, const int requester) {
+    /* variables declaration */
+    uint64_t others = entry->sharers & ~((uint64_t)1 << requester);
+    int i = 0;
+
+    for (i = 0; 0 != others; i++, others >>= 1) {
+        if (others & 1) {
+            core[i]->invalidate_fn(core[i], entry->line_id);
+            core[i]->invalidation++;
+            entry->invalidation++;
+            stats->invalidation++;
+        }
+    }
+    entry->sharers &= ((uint64_t)1 << requester);
+}
+
+/* coherence_evict */
+static void coherence_evict(cache_handle_t **core, cache_handle_t *shared,
+    directory_t *directory, const int requester, const uint64_t line_id) {
+    /* variables declaration */
+    directory_entry_t *entry = directory_find(directory, line_id);
+
+    if (NULL == entry) {
+        return;
+    }
+
+    /* the directory, not the policy, knows whether this copy is dirty: an
+     * owner in M which became S under MESI already wrote the line back
+     */
+    entry->sharers &= ~((uint64_t)1 << requester);
+    if (requester == entry->owner) {
+        if (entry->dirty) {
+            coherence_writeback(core[requester], shared, line_id);
+        }
+        entry->owner = COHERENCE_NONE;
+        entry->dirty = 0;
+    }
+
+    /* keep lines with events, they are reported when it is over */
+    if ((0 == entry->sharers) && (0 == entry->invalidation) &&
+        (0 == entry->upgrade) && (0 == entry->transfer)) {
+        directory_remove(directory, entry);
+    }
+}
+
+/* coherence_access */
+static int coherence_access(cache_coherence_t *coherence,
+    cache_handle_t **core, cache_handle_t *shared, directory_t *directory,
+    coherence_stats_t *stats, const int requester, const uint64_t line_id,
+    const int write) {
+    /* variables declaration */
+    cache_handle_t *cache = core[requester];
+    directory_entry_t *entry = NULL;
+    uint64_t bit = (uint64_t)1 << requester;
+    int owner = COHERENCE_NONE;
+    int served = COHERENCE_SERVED_PRIVATE;
+    int rc = CACHE_SIM_ERROR;
+
+    stats->access++;
+    cache->access++;
+    cache->clock++;
+    rc = cache->access_fn(cache, line_id, write ? LOAD_WRITE : LOAD_ACCESS);
+
+    if (CACHE_SIM_L1_HIT & rc) {
+        cache->hit++;
+        if (0 == write) {
+            return COHERENCE_SERVED_PRIVATE;
+        }
+
+        /* E and M write silently, S and O have to invalidate the others */
+        entry = directory_find(directory, line_id);
+        if ((NULL == entry) ||
+            ((requester == entry->owner) && (bit == entry->sharers))) {
+            if (NULL != entry) {
+                entry->dirty = 1;
+            }
+            return COHERENCE_SERVED_PRIVATE;
+        }
+        entry->upgrade++;
+        stats->upgrade++;
+        coherence_invalidate(core, stats, entry, requester);
+        entry->owner = requester;
+        entry->dirty = 1;
+
+        return COHERENCE_SERVED_PRIVATE;
+    }
+    cache->miss++;
+
+    /* the victim leaves the directory first, which may shift entries */
+    if (UINT64_MAX != cache->victim) {
+        coherence_evict(core, shared, directory, requester, cache->victim);
+    }
+
+    if ((NULL == (entry = directory_find(directory, line_id))) &&
+        (NULL == (entry = directory_insert(directory, line_id)))) {
+        return CACHE_SIM_ERROR;
+    }
+
+    owner = entry->owner;
+    if (COHERENCE_NONE != owner) {
+        /* the owner sends its copy, dirty or not */
+        served = COHERENCE_SERVED_CORE;
+        entry->transfer++;
+        stats->transfer++;
+
+        if (write) {
+            coherence_invalidate(core, stats, entry, requester);
+            entry->owner = requester;
+            entry->dirty = 1;
+        } else if (entry->dirty && (COHERENCE_MOESI == coherence->protocol)) {
+            /* M becomes O, or O stays O */
+        } else {
+            /* E becomes S, under MESI M writes back and becomes S */
+            if (entry->dirty) {
+                coherence_writeback(core[owner], shared, line_id);
+            }
+            entry->owner = COHERENCE_NONE;
+            entry->dirty = 0;
+        }
+    } else {
+        served = coherence_fill(shared, stats, line_id);
+
+        if (write) {
+            coherence_invalidate(core, stats, entry, requester);
+            entry->owner = requester;
+            entry->dirty = 1;
+        } else if (0 == entry->sharers) {
+            entry->owner = requester;
+            entry->dirty = 0;
+        }
+    }
+    entry->sharers |= bit;
+
+    return served;
+}
+
+/* cache_sim_coherence_init */
+cache_coherence_t* cache_sim_coherence_init(const int total_cores,
+    const cache_level_t *core_level, const cache_level_t *shared_level,
+    const coherence_t protocol) {
+    /* sanity check: are the levels described? */
+    if ((NULL == core_level) || (NULL == shared_level)) {
+        printf("Error: coherence needs a private and a shared level\n");
+        return NULL;
+    }
+
+    /* sanity check: does the sharers mask fit all cores? */
+    if ((0 >= total_cores) || (COHERENCE_MAX_CORES < total_cores)) {
+        printf("Error: number of cores must be between 1 and %d\n",
+            COHERENCE_MAX_CORES);
+        return NULL;
+    }
+
+    /* sanity check: is the protocol known? */
+    if (COHERENCE_INVALID <= protocol) {
+        printf("Error: unknown coherence protocol\n");
+        return NULL;
+    }
+
+    /* sanity check: do levels agree on the line size? */
+    if (core_level->line_size != shared_level->line_size) {
+        printf("Error: all levels must have the same line size\n");
+        return NULL;
+    }
+
+    /* variables declaration and initialization */
+    cache_coherence_t *coherence = NULL;
+    int i = 0;
+
+    /* allocate the caches array and the first partition in one area */
+    coherence = (cache_coherence_t *)malloc(sizeof(cache_coherence_t) +
+        (total_cores * sizeof(cache_handle_t *)));
+    if (NULL == coherence) {
+        printf("Error: unable to allocate memory for coherence\n");
+        return NULL;
+    }
+    coherence->core = (cache_handle_t **)(coherence + 1);
+    coherence->total_cores = 0;
+    coherence->protocol = protocol;
+    coherence->shared = NULL;
+    coherence->partitions = 1;
+    coherence->directory = NULL;
+    coherence->stats = NULL;
+
+    /* create the caches */
+    for (i = 0; i < total_cores; i++) {
+        coherence->core[i] = cache_sim_init(core_level->total_size,
+            core_level->line_size, core_level->associativity,
+            core_level->policy);
+        if (NULL == coherence->core[i]) {
+            printf("Error: unable to create the cache of core %d\n", i);
+            cache_sim_coherence_fini(coherence);
+            return NULL;
+        }
+        coherence->core[i]->level = 1;
+        coherence->total_cores++;
+    }
+
+    coherence->shared = cache_sim_init(shared_level->total_size,
+        shared_level->line_size, shared_level->associativity,
+        shared_level->policy);
+    if (NULL == coherence->shared) {
+        printf("Error: unable to create the shared cache\n");
+        cache_sim_coherence_fini(coherence);
+        return NULL;
+    }
+    coherence->shared->level = 2;
+
+    coherence->directory = (directory_t *)malloc(sizeof(directory_t));
+    coherence->stats = (coherence_stats_t *)calloc(1,
+        sizeof(coherence_stats_t));
+    if ((NULL == coherence->directory) || (NULL == coherence->stats) ||
+        (CACHE_SIM_SUCCESS != directory_init(coherence->directory,
+        COHERENCE_DIRECTORY))) {
+        printf("Error: unable to allocate memory for the directory\n");
+        free(coherence->directory);
+        coherence->directory = NULL;
+        cache_sim_coherence_fini(coherence);
+        return NULL;
+    }
+
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf("       Coherence is ON          \n");
+        printf("Cores:           %15d\n", total_cores);
+        printf("Protocol:        %15s\n", protocol_names[protocol]);
+        printf("--------------------------------\n");
+    }
+
+    return coherence;
+}
+
+/* coherence_report */
+static void coherence_report(cache_coherence_t *coherence) {
+    /* variables declaration */
+    directory_entry_t *top[COHERENCE_REPORT_LINES] = { NULL };
+    directory_entry_t *entry = NULL;
+    coherence_stats_t total = { 0 };
+    uint64_t events = 0, i = 0;
+    int p = 0, j = 0;
+
+    for (p = 0; p < coherence->partitions; p++) {
+        total.access       += coherence->stats[p].access;
+        total.transfer     += coherence->stats[p].transfer;
+        total.invalidation += coherence->stats[p].invalidation;
+        total.upgrade      += coherence->stats[p].upgrade;
+        total.memory       += coherence->stats[p].memory;
+
+        /* keep the lines with more events, sorted */
+        for (i = 0; i <= coherence->directory[p].mask; i++) {
+            entry = &(coherence->directory[p].entry[i]);
+            if (UINT64_MAX == entry->line_id) {
+                continue;
+            }
+            events = entry->invalidation + entry->upgrade + entry->transfer;
+            if (0 == events) {
+                continue;
+            }
+            for (j = COHERENCE_REPORT_LINES; 0 < j; j--) {
+                if ((NULL != top[j - 1]) && (events <= (top[j - 1]->invalidation
+                    + top[j - 1]->upgrade + top[j - 1]->transfer))) {
+                    break;
+                }
+                if (COHERENCE_REPORT_LINES > j) {
+                    top[j] = top[j - 1];
+                }
+            }
+            if (COHERENCE_REPORT_LINES > j) {
+                top[j] = entry;
+            }
+        }
+    }
+
+    printf("--------------------------------\n");
+    printf("Total accesses: %16"PRIu64"\n", total.access);
+    for (j = 0; j < coherence->total_cores; j++) {
+        printf("Core %2d hits:   %16"PRIu64"\n", j, coherence->core[j]->hit);
+        printf(" -> writebacks  %16"PRIu64"\n", coherence->core[j]->writeback);
+        printf(" -> invalidated %16"PRIu64"\n",
+            coherence->core[j]->invalidation);
+    }
+    printf("Transfers:      %16"PRIu64"\n", total.transfer);
+    printf("Upgrades:       %16"PRIu64"\n", total.upgrade);
+    printf("Invalidations:  %16"PRIu64"\n", total.invalidation);
+    printf("Shared hits:    %16"PRIu64"\n", coherence->shared->hit);
+    printf("Memory:         %16"PRIu64"\n", total.memory);
+    for (j = 0; (j < COHERENCE_REPORT_LINES) && (NULL != top[j]); j++) {
+        printf("Line 0x%-12"PRIx64" %3"PRIu32" inv %3"PRIu32" upg %3"PRIu32
+            " xfer\n", top[j]->line_id, top[j]->invalidation, top[j]->upgrade,
+            top[j]->transfer);
+    }
+    printf("       Coherence is OFF         \n");
+    printf("--------------------------------\n");
+}
+
+/* cache_sim_coherence_fini */
+int cache_sim_coherence_fini(cache_coherence_t *coherence) {
+    /* sanity check: does coherence exist? */
+    if (NULL == coherence) {
+        printf("Error: coherence does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    int i = 0;
+
+    if (cache_sim_verbose && (NULL != coherence->directory)) {
+        coherence_report(coherence);
+    }
+
+    for (i = 0; i < coherence->total_cores; i++) {
+        cache_sim_fini(coherence->core[i]);
+    }
+    if (NULL != coherence->shared) {
+        cache_sim_fini(coherence->shared);
+    }
+    if (NULL != coherence->directory) {
+        for (i = 0; i < coherence->partitions; i++) {
+            free(coherence->directory[i].entry);
+        }
+        free(coherence->directory);
+    }
+    free(coherence->stats);
+    free(coherence);
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_coherence_parallel */
+int cache_sim_coherence_parallel(cache_coherence_t *coherence,
+    const int threads) {
+    /* sanity check: does coherence exist? */
+    if (NULL == coherence) {
+        printf("Error: coherence does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: at least one thread */
+    if (0 >= threads) {
+        printf("Error: number of threads is smaller than 1\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    directory_t *directory = NULL;
+    directory_entry_t *entry = NULL;
+    coherence_stats_t *stats = NULL;
+    int partitions = 1, min_sets = coherence->shared->total_sets;
+    int set_local = coherence->shared->set_local;
+    int i = 0, p = 0;
+    uint64_t j = 0;
+
+    /* sanity check: can sets be simulated apart? */
+    for (i = 0; i < coherence->total_cores; i++) {
+        set_local &= coherence->core[i]->set_local;
+        if (coherence->core[i]->total_sets < min_sets) {
+            min_sets = coherence->core[i]->total_sets;
+        }
+    }
+    if (0 == set_local) {
+        printf("Error: replacement policy shares state among sets\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* a power of two, so the low bits of a set select its partition */
+    while (((partitions * 2) <= threads) && ((partitions * 2) <= min_sets)) {
+        partitions *= 2;
+    }
+
+    directory = (directory_t *)malloc(partitions * sizeof(directory_t));
+    stats = (coherence_stats_t *)calloc(partitions,
+        sizeof(coherence_stats_t));
+    if ((NULL == directory) || (NULL == stats)) {
+        printf("Error: unable to allocate memory for the partitions\n");
+        free(directory);
+        free(stats);
+        return CACHE_SIM_ERROR;
+    }
+    for (p = 0; p < partitions; p++) {
+        if (CACHE_SIM_SUCCESS != directory_init(&(directory[p]),
+            COHERENCE_DIRECTORY)) {
+            while (0 < p--) {
+                free(directory[p].entry);
+            }
+            free(directory);
+            free(stats);
+            return CACHE_SIM_ERROR;
+        }
+    }
+
+    /* move the lines already known to their new partition */
+    for (p = 0; p < coherence->partitions; p++) {
+        stats[0].access       += coherence->stats[p].access;
+        stats[0].transfer     += coherence->stats[p].transfer;
+        stats[0].invalidation += coherence->stats[p].invalidation;
+        stats[0].upgrade      += coherence->stats[p].upgrade;
+        stats[0].memory       += coherence->stats[p].memory;
+
+        for (j = 0; j <= coherence->directory[p].mask; j++) {
+            entry = &(coherence->directory[p].entry[j]);
+            if (UINT64_MAX != entry->line_id) {
+                i = (entry->line_id >> coherence->shared->offset_length) &
+                    (partitions - 1);
+                *directory_insert(&(directory[i]), entry->line_id) = *entry;
+            }
+        }
+        free(coherence->directory[p].entry);
+    }
+    free(coherence->directory);
+    free(coherence->stats);
+
+    coherence->directory = directory;
+    coherence->stats = stats;
+    coherence->partitions = partitions;
+
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf("   Parallel simulation is ON    \n");
+        printf("Partitions:      %15d\n", partitions);
+        #ifndef _OPENMP
+        printf("(built without OpenMP: serial) \n");
+        #endif
+        printf("--------------------------------\n");
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_coherence_access */
+int cache_sim_coherence_access(cache_coherence_t *coherence, const int core,
+    const uint64_t address, const int write) {
+    /* sanity check: is the core known? */
+    if ((0 > core) || (core >= coherence->total_cores)) {
+        printf("Error: core %d does not exists\n", core);
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    uint64_t line_id = address &
+        ~(((uint64_t)1 << coherence->shared->offset_length) - 1);
+    int p = (line_id >> coherence->shared->offset_length) &
+        (coherence->partitions - 1);
+
+    return coherence_access(coherence, coherence->core, coherence->shared,
+        &(coherence->directory[p]), &(coherence->stats[p]), core, line_id,
+        write);
+}
+
+/* coherence_partition */
+static void coherence_partition(cache_coherence_t *coherence, const int p,
+    cache_handle_t *local, const uint8_t *core, const uint64_t *address,
+    const uint8_t *write, const size_t count, int *served) {
+    /* variables declaration */
+    cache_handle_t *handle[COHERENCE_MAX_CORES];
+    cache_handle_t *shared = &(local[coherence->total_cores]);
+    uint64_t mask = ~(((uint64_t)1 << coherence->shared->offset_length) - 1);
+    uint64_t line_id = 0;
+    size_t i = 0;
+    int c = 0, rc = 0;
+
+    /* local handles share the policy data, their counters start at zero and
+     * are merged when all partitions are done
+     */
+    for (c = 0; c <= coherence->total_cores; c++) {
+        local[c] = (c < coherence->total_cores) ? *(coherence->core[c]) :
+            *(coherence->shared);
+        local[c].access = 0;
+        local[c].hit = 0;
+        local[c].miss = 0;
+        local[c].writeback = 0;
+        local[c].invalidation = 0;
+        handle[c] = &(local[c]);
+    }
+
+    for (i = 0; i < count; i++) {
+        line_id = address[i] & mask;
+        if (p != (int)((line_id >> coherence->shared->offset_length) &
+            (coherence->partitions - 1))) {
+            continue;
+        }
+
+        rc = coherence_access(coherence, handle, shared,
+            &(coherence->directory[p]), &(coherence->stats[p]), core[i],
+            line_id, (NULL != write) && write[i]);
+        if (NULL != served) {
+            served[i] = rc;
+        }
+    }
+}
+
+/* cache_sim_coherence_access_batch */
+int cache_sim_coherence_access_batch(cache_coherence_t *coherence,
+    const uint8_t *core, const uint64_t *address, const uint8_t *write,
+    const size_t count, int *served) {
+    /* sanity check: do coherence and the trace exist? */
+    if ((NULL == coherence) || (NULL == core) || (NULL == address)) {
+        printf("Error: coherence or trace does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    cache_handle_t *local = NULL, *cache = NULL;
+    size_t i = 0;
+    int p = 0, c = 0, total = coherence->total_cores + 1;
+
+    /* sanity check: are all cores known? */
+    for (i = 0; i < count; i++) {
+        if (core[i] >= coherence->total_cores) {
+            printf("Error: core %d does not exists\n", core[i]);
+            return CACHE_SIM_ERROR;
+        }
+    }
+
+    if (1 == coherence->partitions) {
+        for (i = 0; i < count; i++) {
+            p = cache_sim_coherence_access(coherence, core[i], address[i],
+                (NULL != write) && write[i]);
+            if (NULL != served) {
+                served[i] = p;
+            }
+        }
+        return CACHE_SIM_SUCCESS;
+    }
+
+    local = (cache_handle_t *)malloc(coherence->partitions * total *
+        sizeof(cache_handle_t));
+    if (NULL == local) {
+        printf("Error: unable to allocate memory for the partitions\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* lines of a partition map to its sets only, in every cache */
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(coherence->partitions) \
+        schedule(static, 1)
+    #endif
+    for (p = 0; p < coherence->partitions; p++) {
+        coherence_partition(coherence, p, &(local[p * total]), core, address,
+            write, count, served);
+    }
+
+    /* merge the counters of all partitions, no clock went further */
+    for (c = 0; c < total; c++) {
+        cache = (c < coherence->total_cores) ? coherence->core[c] :
+            coherence->shared;
+        for (p = 0; p < coherence->partitions; p++) {
+            cache->access       += local[(p * total) + c].access;
+            cache->hit          += local[(p * total) + c].hit;
+            cache->miss         += local[(p * total) + c].miss;
+            cache->writeback    += local[(p * total) + c].writeback;
+            cache->invalidation += local[(p * total) + c].invalidation;
+        }
+        cache->clock += 2 * count;
+    }
+    free(local);
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_coherence_write */
+int cache_sim_coherence_write(cache_coherence_t *coherence,
+    const char *filename) {
+    /* sanity check: does coherence exist? */
+    if (NULL == coherence) {
+        printf("Error: coherence does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    cache_handle_t *shared = coherence->shared;
+    directory_entry_t *entry = NULL;
+    uint64_t *totals = NULL;
+    uint32_t symbol = SYMBOL_UNKNOWN, total_symbols = 0;
+    const char *name = NULL;
+    FILE *file = stdout;
+    uint64_t i = 0;
+    int p = 0;
+
+    if (NULL != shared->symbol_data) {
+        total_symbols = shared->symbol_data->total_symbols;
+        totals = (uint64_t *)calloc(total_symbols * 3, sizeof(uint64_t));
+        if (NULL == totals) {
+            printf("Error: unable to allocate memory for symbol totals\n");
+            return CACHE_SIM_ERROR;
+        }
+    }
+
+    if ((NULL != filename) && (NULL == (file = fopen(filename, "w")))) {
+        printf("Error: unable to open %s\n", filename);
+        free(totals);
+        return CACHE_SIM_ERROR;
+    }
+
+    /* events per line, then per symbol (those inserted in the shared cache)
+     * as two CSV tables
+     */
+    fprintf(file, "line,symbol,invalidations,upgrades,transfers\n");
+    for (p = 0; p < coherence->partitions; p++) {
+        for (i = 0; i <= coherence->directory[p].mask; i++) {
+            entry = &(coherence->directory[p].entry[i]);
+            if ((UINT64_MAX == entry->line_id) || (0 == (entry->invalidation
+                + entry->upgrade + entry->transfer))) {
+                continue;
+            }
+            symbol = cache_sim_symbol_lookup(shared, entry->line_id);
+            name = cache_sim_symbol_name(shared, symbol);
+            fprintf(file, "0x%"PRIx64",\"%s\",%"PRIu32",%"PRIu32",%"PRIu32
+                "\n", entry->line_id, (NULL != name) ? name : "(unknown)",
+                entry->invalidation, entry->upgrade, entry->transfer);
+            if (NULL != totals) {
+                totals[(symbol * 3) + 0] += entry->invalidation;
+                totals[(symbol * 3) + 1] += entry->upgrade;
+                totals[(symbol * 3) + 2] += entry->transfer;
+            }
+        }
+    }
+
+    if (NULL != totals) {
+        fprintf(file, "\nsymbol,invalidations,upgrades,transfers\n");
+        for (symbol = 0; symbol < total_symbols; symbol++) {
+            fprintf(file, "\"%s\",%"PRIu64",%"PRIu64",%"PRIu64"\n",
+                cache_sim_symbol_name(shared, symbol), totals[symbol * 3],
+                totals[(symbol * 3) + 1], totals[(symbol * 3) + 2]);
+        }
+        free(totals);
+    }
+
+    if (stdout != file) {
+        fclose(file);
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+// EOF
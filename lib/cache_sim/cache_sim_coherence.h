@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef CACHE_SIM_COHERENCE_H_
+#define CACHE_SIM_COHERENCE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CACHE_SIM_H_
+#include "cache_sim.h"
+#endif
+
+#ifndef CACHE_SIM_TYPES_H_
+#include "cache_sim_types.h"
+#endif
+
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+
+/* Sharers are kept in a 64 bits mask */
+#define COHERENCE_MAX_CORES     64
+#define COHERENCE_NONE          -1
+
+/* Initial # of directory entries, and # of lines shown when it is over */
+#define COHERENCE_DIRECTORY     1024
+#define COHERENCE_REPORT_LINES  5
+
+/* Who served an access */
+#define COHERENCE_SERVED_PRIVATE 1
+#define COHERENCE_SERVED_CORE    2
+#define COHERENCE_SERVED_SHARED  3
+#define COHERENCE_SERVED_MEMORY  4
+
+/* Functions declaration */
+cache_coherence_t* cache_sim_coherence_init(const int total_cores,
+    const cache_level_t *core_level, const cache_level_t *shared_level,
+    const coherence_t protocol);
+int cache_sim_coherence_fini(cache_coherence_t *coherence);
+int cache_sim_coherence_parallel(cache_coherence_t *coherence,
+    const int threads);
+/* returns who served the access, one of COHERENCE_SERVED_* */
+int cache_sim_coherence_access(cache_coherence_t *coherence, const int core,
+    const uint64_t address, const int write);
+int cache_sim_coherence_access_batch(cache_coherence_t *coherence,
+    const uint8_t *core, const uint64_t *address, const uint8_t *write,
+    const size_t count, int *served);
+int cache_sim_coherence_write(cache_coherence_t *coherence,
+    const char *filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_SIM_COHERENCE_H_ */
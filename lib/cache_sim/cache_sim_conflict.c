@@ -75,9 +75,11 @@ int cache_sim_conflict_enable(cache_handle_t *cache) {
     }
 
     /* be nice and print something... */
-    printf("--------------------------------\n");
-    printf(" Set associative conflict is ON \n");
-    printf("--------------------------------\n");
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf(" Set associative conflict is ON \n");
+        printf("--------------------------------\n");
+    }
 
     return CACHE_SIM_SUCCESS;
 }
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_util.h"
+#include "cache_sim_hierarchy.h"
+
+/* Names of the inclusion policies */
+static const char *inclusion_names[] = {
+    "inclusive", "exclusive", "NINE"
+};
+
+/* cache_sim_hierarchy_init */
+cache_hierarchy_t* cache_sim_hierarchy_init(const cache_level_t *levels,
+    const int total_levels) {
+    /* sanity check: is there any level? */
+    if ((NULL == levels) || (0 >= total_levels)) {
+        printf("Error: hierarchy has no levels\n");
+        return NULL;
+    }
+
+    /* variables declaration and initialization */
+    cache_hierarchy_t *hierarchy = NULL;
+    int i = 0;
+
+    /* sanity check: do levels agree on the line size and inclusion? */
+    for (i = 1; i < total_levels; i++) {
+        if (levels[i].line_size != levels[0].line_size) {
+            printf("Error: all levels must have the same line size\n");
+            return NULL;
+        }
+        if (HIERARCHY_INVALID <= levels[i].inclusion) {
+            printf("Error: unknown inclusion policy on level %d\n", i + 1);
+            return NULL;
+        }
+    }
+
+    /* allocate the hierarchy and its per level arrays in one area */
+    hierarchy = (cache_hierarchy_t *)malloc(sizeof(cache_hierarchy_t) +
+        (total_levels * (sizeof(cache_handle_t *) + sizeof(uint64_t) +
+        sizeof(inclusion_t) + sizeof(int))));
+    if (NULL == hierarchy) {
+        printf("Error: unable to allocate memory for cache hierarchy\n");
+        return NULL;
+    }
+    hierarchy->level = (cache_handle_t **)(hierarchy + 1);
+    hierarchy->victim = (uint64_t *)(hierarchy->level + total_levels);
+    hierarchy->inclusion = (inclusion_t *)(hierarchy->victim + total_levels);
+    hierarchy->victim_dirty = (int *)(hierarchy->inclusion + total_levels);
+    hierarchy->total_levels = total_levels;
+    hierarchy->access = 0;
+    hierarchy->memory = 0;
+
+    /* create the caches, the first level has nothing above it */
+    for (i = 0; i < total_levels; i++) {
+        hierarchy->level[i] = cache_sim_init(levels[i].total_size,
+            levels[i].line_size, levels[i].associativity, levels[i].policy);
+        if (NULL == hierarchy->level[i]) {
+            printf("Error: unable to create level %d\n", i + 1);
+            hierarchy->total_levels = i;
+            cache_sim_hierarchy_fini(hierarchy);
+            return NULL;
+        }
+        hierarchy->level[i]->level = i + 1;
+        hierarchy->inclusion[i] = (0 == i) ? HIERARCHY_NINE :
+            levels[i].inclusion;
+        hierarchy->victim[i] = UINT64_MAX;
+        hierarchy->victim_dirty[i] = 0;
+    }
+
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf("     Cache hierarchy is ON      \n");
+        for (i = 1; i < total_levels; i++) {
+            printf("Level %d:        %16s\n", i + 1,
+                inclusion_names[hierarchy->inclusion[i]]);
+        }
+        printf("--------------------------------\n");
+    }
+
+    return hierarchy;
+}
+
+/* cache_sim_hierarchy_fini */
+int cache_sim_hierarchy_fini(cache_hierarchy_t *hierarchy) {
+    /* sanity check: does hierarchy exist? */
+    if (NULL == hierarchy) {
+        printf("Error: cache hierarchy does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    cache_handle_t *cache = NULL;
+    int i = 0;
+
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf("Total accesses: %16"PRIu64"\n", hierarchy->access);
+        for (i = 0; i < hierarchy->total_levels; i++) {
+            cache = hierarchy->level[i];
+            printf("Level %d hits:   %16"PRIu64"\n", i + 1, cache->hit);
+            printf(" -> writebacks  %16"PRIu64"\n", cache->writeback);
+            printf(" -> invalidated %16"PRIu64"\n", cache->invalidation);
+        }
+        printf("Memory:         %16"PRIu64"\n", hierarchy->memory);
+        printf("     Cache hierarchy is OFF     \n");
+        printf("--------------------------------\n");
+    }
+
+    for (i = 0; i < hierarchy->total_levels; i++) {
+        cache_sim_fini(hierarchy->level[i]);
+    }
+    free(hierarchy);
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* hierarchy_evict */
+static void hierarchy_evict(cache_hierarchy_t *hierarchy, const int level,
+    const uint64_t line_id, int dirty) {
+    /* variables declaration */
+    cache_handle_t *cache = hierarchy->level[level];
+    cache_handle_t *upper = NULL;
+    cache_handle_t *lower = NULL;
+    int i = 0;
+
+    /* an inclusive level takes the line away from all the levels above */
+    if (HIERARCHY_INCLUSIVE == hierarchy->inclusion[level]) {
+        for (i = 0; i < level; i++) {
+            upper = hierarchy->level[i];
+            if (CACHE_SIM_L1_HIT == upper->invalidate_fn(upper, line_id)) {
+                cache->invalidation++;
+                dirty |= upper->victim_dirty;
+            }
+        }
+    }
+
+    if (dirty) {
+        cache->writeback++;
+    }
+
+    /* dirty lines leaving the last level go to memory */
+    if ((level + 1) == hierarchy->total_levels) {
+        return;
+    }
+
+    /* an exclusive level keeps every line evicted from the level above it,
+     * other levels only take dirty lines back
+     */
+    lower = hierarchy->level[level + 1];
+    if ((HIERARCHY_EXCLUSIVE == hierarchy->inclusion[level + 1]) || dirty) {
+        #ifdef DEBUG
+        printf("EVICT  line id [%018p] level [%d] dirty [%d]\n", line_id,
+            level + 1, dirty);
+        #endif
+
+        lower->clock++;
+        if ((CACHE_SIM_L1_HIT & lower->access_fn(lower, line_id,
+            dirty ? LOAD_WRITE : LOAD_ACCESS)) ||
+            (UINT64_MAX == lower->victim)) {
+            return;
+        }
+        hierarchy_evict(hierarchy, level + 1, lower->victim,
+            lower->victim_dirty);
+    }
+}
+
+/* hierarchy_access */
+static inline int hierarchy_access(cache_hierarchy_t *hierarchy,
+    const uint64_t line_id, const int write) {
+    /* variables declaration */
+    cache_handle_t *cache = NULL;
+    int served = hierarchy->total_levels;
+    int dirty = 0;
+    int i = 0;
+
+    #ifdef DEBUG
+    printf("ACCESS line id [%018p] write [%d]\n", line_id, write);
+    #endif
+
+    /* look for the line from the top, filling the levels it misses */
+    for (i = 0; i < hierarchy->total_levels; i++) {
+        cache = hierarchy->level[i];
+        cache->access++;
+        cache->clock++;
+        hierarchy->victim[i] = UINT64_MAX;
+
+        /* an exclusive level hands the line over to the level above it */
+        if (HIERARCHY_EXCLUSIVE == hierarchy->inclusion[i]) {
+            if (CACHE_SIM_L1_HIT == cache->invalidate_fn(cache, line_id)) {
+                cache->hit++;
+                dirty = cache->victim_dirty;
+                served = i;
+                break;
+            }
+            cache->miss++;
+            continue;
+        }
+
+        if (CACHE_SIM_L1_HIT & cache->access_fn(cache, line_id,
+            ((0 == i) && write) ? LOAD_WRITE : LOAD_ACCESS)) {
+            cache->hit++;
+            served = i;
+            break;
+        }
+        cache->miss++;
+        hierarchy->victim[i] = cache->victim;
+        hierarchy->victim_dirty[i] = cache->victim_dirty;
+    }
+
+    /* a dirty line handed over stays dirty on the closest level filled */
+    if (dirty) {
+        for (i = served - 1; HIERARCHY_EXCLUSIVE == hierarchy->inclusion[i];
+            i--);
+        cache = hierarchy->level[i];
+        cache->access_fn(cache, line_id, LOAD_WRITE);
+    }
+
+    /* the lines evicted by the fills go down only after the line was found,
+     * so they never push the requested line out of an exclusive level
+     */
+    for (i = 0; i < served; i++) {
+        if (UINT64_MAX != hierarchy->victim[i]) {
+            hierarchy_evict(hierarchy, i, hierarchy->victim[i],
+                hierarchy->victim_dirty[i]);
+        }
+    }
+
+    if (hierarchy->total_levels == served) {
+        hierarchy->memory++;
+    }
+
+    return served + 1;
+}
+
+/* cache_sim_hierarchy_access */
+int cache_sim_hierarchy_access(cache_hierarchy_t *hierarchy,
+    const uint64_t address, const int write) {
+    /* variables declaration */
+    cache_handle_t *cache = hierarchy->level[0];
+    uint64_t line_id = UINT64_MAX;
+
+    /* increment access counter */
+    hierarchy->access++;
+
+    /* all levels share the line size */
+    line_id = address;
+    CACHE_SIM_ADDRESS_TO_LINE_ID(line_id);
+
+    return hierarchy_access(hierarchy, line_id, write);
+}
+
+/* cache_sim_hierarchy_access_batch */
+int cache_sim_hierarchy_access_batch(cache_hierarchy_t *hierarchy,
+    const uint64_t *address, const uint8_t *write, const size_t count,
+    int *level) {
+    /* sanity check: does hierarchy exist? */
+    if ((NULL == hierarchy) || (NULL == address)) {
+        printf("Error: cache hierarchy does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    uint64_t line_id[CACHE_SIM_BATCH_LENGTH];
+    uint64_t mask = ~(((uint64_t)1 << hierarchy->level[0]->offset_length) - 1);
+    size_t base = 0, length = 0, i = 0;
+    int served = 0;
+
+    for (base = 0; base < count; base += CACHE_SIM_BATCH_LENGTH) {
+        length = count - base;
+        if (CACHE_SIM_BATCH_LENGTH < length) {
+            length = CACHE_SIM_BATCH_LENGTH;
+        }
+
+        /* calculate all line ids first, this loop vectorizes */
+        for (i = 0; i < length; i++) {
+            line_id[i] = address[base + i] & mask;
+        }
+
+        /* levels depend on each other, so accesses keep their order */
+        for (i = 0; i < length; i++) {
+            served = hierarchy_access(hierarchy, line_id[i],
+                (NULL != write) && write[base + i]);
+            if (NULL != level) {
+                level[base + i] = served;
+            }
+        }
+    }
+
+    hierarchy->access += count;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+// EOF
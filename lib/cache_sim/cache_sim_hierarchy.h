@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef CACHE_SIM_HIERARCHY_H_
+#define CACHE_SIM_HIERARCHY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CACHE_SIM_H_
+#include "cache_sim.h"
+#endif
+
+#ifndef CACHE_SIM_TYPES_H_
+#include "cache_sim_types.h"
+#endif
+
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+
+/* Functions declaration */
+cache_hierarchy_t* cache_sim_hierarchy_init(const cache_level_t *levels,
+    const int total_levels);
+int cache_sim_hierarchy_fini(cache_hierarchy_t *hierarchy);
+/* returns the level that served the access, total_levels + 1 for memory */
+int cache_sim_hierarchy_access(cache_hierarchy_t *hierarchy,
+    const uint64_t address, const int write);
+int cache_sim_hierarchy_access_batch(cache_hierarchy_t *hierarchy,
+    const uint64_t *address, const uint8_t *write, const size_t count,
+    int *level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_SIM_HIERARCHY_H_ */
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_reuse.h"
+#include "cache_sim_mrc.h"
+
+/* cache_sim_mrc_enable */
+int cache_sim_mrc_enable(cache_handle_t *cache, const double rate) {
+    /* sanity check: does cache exist? */
+    if (NULL == cache) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: already enabled */
+    if (NULL != cache->mrc_data) {
+        printf("Warning: miss ratio curve was already enabled\n");
+        return CACHE_SIM_SUCCESS;
+    }
+
+    /* sanity check: is the sampling rate valid? */
+    if ((0 >= rate) || (1 < rate) ||
+        (1 > (uint64_t)(rate * (1 << MRC_HASH_BITS)))) {
+        printf("Error: sampling rate must be in (0, 1]\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    mrc_data_t *mrc = (mrc_data_t *)malloc(sizeof(mrc_data_t));
+
+    if (NULL == mrc) {
+        printf("Error: unable to allocate memory for miss ratio curve\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* stack distances are reuse distances over every sampled line */
+    mrc->reuse = cache_sim_reuse_create(0);
+    mrc->total_distances = cache->total_lines;
+    mrc->histogram = (uint64_t *)calloc(mrc->total_distances,
+        sizeof(uint64_t));
+    if ((NULL == mrc->reuse) || (NULL == mrc->histogram)) {
+        printf("Error: unable to allocate memory for miss ratio curve\n");
+        if (NULL != mrc->reuse) {
+            cache_sim_reuse_destroy(mrc->reuse);
+        }
+        free(mrc->histogram);
+        free(mrc);
+        return CACHE_SIM_ERROR;
+    }
+
+    mrc->threshold = (uint64_t)(rate * (1 << MRC_HASH_BITS));
+    mrc->rate      = (double)mrc->threshold / (1 << MRC_HASH_BITS);
+    mrc->access    = 0;
+    mrc->cold      = 0;
+
+    cache->mrc_data = mrc;
+
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf("    Miss ratio curve is ON      \n");
+        printf("Sampling rate:   %14.2f%%\n", mrc->rate * 100);
+        printf("--------------------------------\n");
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_mrc_disable */
+int cache_sim_mrc_disable(cache_handle_t *cache) {
+    /* sanity check: does cache exist? */
+    if (NULL == cache) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: already disabled */
+    if (NULL == cache->mrc_data) {
+        printf("Error: miss ratio curve is not enabled\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    cache_sim_reuse_destroy(cache->mrc_data->reuse);
+    free(cache->mrc_data->histogram);
+    free(cache->mrc_data);
+    cache->mrc_data = NULL;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_mrc_access */
+int cache_sim_mrc_access(cache_handle_t *cache, const uint64_t line_id) {
+    /* variables declaration */
+    mrc_data_t *mrc = cache->mrc_data;
+    uint64_t *histogram = NULL;
+    uint64_t distance = UINT64_MAX;
+    uint64_t total = 0;
+
+    /* spatial sampling: the same lines are always (or never) sampled */
+    if (((((line_id >> cache->offset_length) * 0x9E3779B97F4A7C15ULL) >>
+        (64 - MRC_HASH_BITS))) >= mrc->threshold) {
+        return CACHE_SIM_SUCCESS;
+    }
+
+    if (CACHE_SIM_SUCCESS != cache_sim_reuse_update(mrc->reuse, 0, line_id,
+        &distance)) {
+        return CACHE_SIM_ERROR;
+    }
+    mrc->access++;
+
+    if (UINT64_MAX == distance) {
+        mrc->cold++;
+        return CACHE_SIM_SUCCESS;
+    }
+
+    /* grow the histogram up to the largest distance seen */
+    if (distance >= mrc->total_distances) {
+        for (total = mrc->total_distances * 2; distance >= total; total *= 2);
+
+        histogram = (uint64_t *)realloc(mrc->histogram,
+            total * sizeof(uint64_t));
+        if (NULL == histogram) {
+            printf("Error: unable to allocate memory for miss ratio curve\n");
+            return CACHE_SIM_ERROR;
+        }
+        for (; mrc->total_distances < total; mrc->total_distances++) {
+            histogram[mrc->total_distances] = 0;
+        }
+        mrc->histogram = histogram;
+    }
+
+    mrc->histogram[distance]++;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* mrc_set_miss */
+static double mrc_set_miss(const double distance, const double sets,
+    const int associativity) {
+    /* variables declaration */
+    double p = 1 / sets;
+    double n = floor(distance + 0.5);
+    double pmf = 0, cdf = 0;
+    int k = 0;
+
+    /* the other lines spread evenly over the sets, the line survives if
+     * fewer than associativity of them map to its set (binomial model)
+     */
+    if (n < associativity) {
+        return 0;
+    }
+
+    pmf = exp(n * log1p(-p));
+    for (k = 0; k < associativity; k++) {
+        cdf += pmf;
+        pmf *= ((n - k) / (k + 1)) * (p / (1 - p));
+    }
+
+    return (1 < cdf) ? 0 : (1 - cdf);
+}
+
+/* cache_sim_mrc_miss_ratio */
+double cache_sim_mrc_miss_ratio(cache_handle_t *cache, const double lines,
+    const int associativity) {
+    /* sanity check: is the miss ratio curve enabled? */
+    if ((NULL == cache) || (NULL == cache->mrc_data)) {
+        printf("Error: miss ratio curve is not enabled\n");
+        return 0;
+    }
+
+    /* variables declaration */
+    mrc_data_t *mrc = cache->mrc_data;
+    double miss = (double)mrc->cold;
+    double sets = (0 < associativity) ? (lines / associativity) : 1;
+    double p = 0;
+    uint64_t d = 0;
+
+    if (0 == mrc->access) {
+        return 0;
+    }
+
+    /* fully associative LRU: accesses hit within lines distinct lines */
+    if (1 >= sets) {
+        for (d = (uint64_t)ceil(lines * mrc->rate); d < mrc->total_distances;
+            d++) {
+            miss += mrc->histogram[d];
+        }
+        return miss / mrc->access;
+    }
+
+    /* set associative correction, misses only grow with the distance */
+    for (d = 0; d < mrc->total_distances; d++) {
+        if (MRC_MISS_CERTAIN > p) {
+            p = mrc_set_miss(d / mrc->rate, sets, associativity);
+        }
+        miss += p * mrc->histogram[d];
+    }
+
+    return miss / mrc->access;
+}
+
+/* cache_sim_mrc_write */
+int cache_sim_mrc_write(cache_handle_t *cache, const char *filename,
+    const mrc_format_t format) {
+    /* sanity check: is the miss ratio curve enabled? */
+    if ((NULL == cache) || (NULL == cache->mrc_data)) {
+        printf("Error: miss ratio curve is not enabled\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: unknown format */
+    if (MRC_FORMAT_INVALID <= format) {
+        printf("Error: unknown miss ratio curve format\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    mrc_data_t *mrc = cache->mrc_data;
+    FILE *file = stdout;
+    double largest = 0, lines = 0;
+    int step = 0;
+
+    if ((NULL != filename) && (NULL == (file = fopen(filename, "w")))) {
+        printf("Error: unable to open %s\n", filename);
+        return CACHE_SIM_ERROR;
+    }
+
+    /* powers of two and halfway points, from one set to the size where
+     * only cold misses are left
+     */
+    largest = (mrc->total_distances / mrc->rate) * 2;
+
+    if (MRC_FORMAT_CSV == format) {
+        fprintf(file, "size,lines,miss_ratio,set_associative_miss_ratio\n");
+    } else {
+        fprintf(file, "{\n  \"line_size\": %d,\n", cache->line_size);
+        fprintf(file, "  \"associativity\": %d,\n", cache->associativity);
+        fprintf(file, "  \"sampling_rate\": %g,\n", mrc->rate);
+        fprintf(file, "  \"accesses\": %"PRIu64",\n", mrc->access);
+        fprintf(file, "  \"cold_misses\": %"PRIu64",\n", mrc->cold);
+        fprintf(file, "  \"curve\": [");
+    }
+
+    for (step = 0; ; step++) {
+        lines = cache->associativity * pow(2, step / 2) *
+            ((step % 2) ? 1.5 : 1);
+        if (lines > largest) {
+            break;
+        }
+
+        if (MRC_FORMAT_CSV == format) {
+            fprintf(file, "%.0f,%.0f,%.6f,%.6f\n", lines * cache->line_size,
+                lines, cache_sim_mrc_miss_ratio(cache, lines, 0),
+                cache_sim_mrc_miss_ratio(cache, lines, cache->associativity));
+        } else {
+            fprintf(file, "%s\n    { \"size\": %.0f, \"lines\": %.0f, "
+                "\"miss_ratio\": %.6f, \"set_associative_miss_ratio\": %.6f }",
+                (0 == step) ? "" : ",", lines * cache->line_size, lines,
+                cache_sim_mrc_miss_ratio(cache, lines, 0),
+                cache_sim_mrc_miss_ratio(cache, lines, cache->associativity));
+        }
+    }
+
+    if (MRC_FORMAT_JSON == format) {
+        fprintf(file, "\n  ]\n}\n");
+    }
+
+    if (stdout != file) {
+        fclose(file);
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+// EOF
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef CACHE_SIM_MRC_H_
+#define CACHE_SIM_MRC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+
+#ifndef CACHE_SIM_H_
+#include "cache_sim.h"
+#endif
+
+#ifndef CACHE_SIM_TYPES_H_
+#include "cache_sim_types.h"
+#endif
+
+/* Sampling resolution: lines are sampled by comparing the top MRC_HASH_BITS
+ * of their hash against rate * 2^MRC_HASH_BITS
+ */
+#define MRC_HASH_BITS 24
+
+/* Set associative misses are certain beyond this probability */
+#define MRC_MISS_CERTAIN (1.0 - 1e-12)
+
+/* Functions declaration */
+int cache_sim_mrc_enable(cache_handle_t *cache, const double rate);
+int cache_sim_mrc_disable(cache_handle_t *cache);
+int cache_sim_mrc_access(cache_handle_t *cache, const uint64_t line_id);
+double cache_sim_mrc_miss_ratio(cache_handle_t *cache, const double lines,
+    const int associativity);
+int cache_sim_mrc_write(cache_handle_t *cache, const char *filename,
+    const mrc_format_t format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_SIM_MRC_H_ */
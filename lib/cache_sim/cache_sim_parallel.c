@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_parallel.h"
+
+/* cache_sim_parallel_enable */
+int cache_sim_parallel_enable(cache_handle_t *cache, const int threads) {
+    /* sanity check: does cache exist? */
+    if (NULL == cache) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: already enabled */
+    if (NULL != cache->thread_stats) {
+        printf("Warning: parallel simulation was already enabled\n");
+        return CACHE_SIM_SUCCESS;
+    }
+
+    /* sanity check: can sets be simulated apart? */
+    if (0 == cache->set_local) {
+        printf("Error: replacement policy shares state among sets\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: at least one thread */
+    if (0 >= threads) {
+        printf("Error: number of threads is smaller than 1\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    int i = 0;
+
+    /* no more threads than sets */
+    cache->threads = (threads < cache->total_sets) ? threads :
+        cache->total_sets;
+
+    cache->thread_stats = (thread_stats_t *)malloc(cache->threads *
+        sizeof(thread_stats_t));
+    if (NULL == cache->thread_stats) {
+        printf("Error: unable to allocate memory for thread counters\n");
+        cache->threads = 1;
+        return CACHE_SIM_ERROR;
+    }
+
+    for (i = 0; i < cache->threads; i++) {
+        cache->thread_stats[i].access = 0;
+        cache->thread_stats[i].hit    = 0;
+        cache->thread_stats[i].miss   = 0;
+    }
+
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf("   Parallel simulation is ON    \n");
+        printf("Threads:         %15d\n", cache->threads);
+        #ifndef _OPENMP
+        printf("(built without OpenMP: serial) \n");
+        #endif
+        printf("--------------------------------\n");
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_parallel_disable */
+int cache_sim_parallel_disable(cache_handle_t *cache) {
+    /* sanity check: does cache exist? */
+    if (NULL == cache) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: already disabled */
+    if (NULL == cache->thread_stats) {
+        printf("Error: parallel simulation is not enabled\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    int i = 0;
+
+    /* merge the counters of all threads */
+    for (i = 0; i < cache->threads; i++) {
+        cache->access += cache->thread_stats[i].access;
+        cache->hit    += cache->thread_stats[i].hit;
+        cache->miss   += cache->thread_stats[i].miss;
+    }
+
+    free(cache->thread_stats);
+    cache->thread_stats = NULL;
+    cache->threads = 1;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* parallel_access_sets */
+static void parallel_access_sets(cache_handle_t *cache, const int thread,
+    const uint64_t *address, const uint8_t *write, const size_t count,
+    int *level) {
+    /* variables declaration */
+    cache_handle_t local = *cache;
+    uint64_t mask = ~(((uint64_t)1 << cache->offset_length) - 1);
+    uint64_t set_mask = (uint64_t)cache->total_sets - 1;
+    uint64_t first = ((uint64_t)cache->total_sets * thread) / cache->threads;
+    uint64_t last = ((uint64_t)cache->total_sets * (thread + 1)) /
+        cache->threads;
+    uint64_t set = 0, hit = 0, access = 0;
+    size_t i = 0;
+    int rc = CACHE_SIM_ERROR;
+
+    /* the local handle shares the policy data but has its own clock and
+     * victim, ages only have to grow within each set
+     */
+    for (i = 0; i < count; i++) {
+        set = (address[i] >> cache->offset_length) & set_mask;
+        if ((set < first) || (set >= last)) {
+            continue;
+        }
+
+        local.clock++;
+        rc = local.access_fn(&local, address[i] & mask,
+            ((NULL != write) && write[i]) ? LOAD_WRITE : LOAD_ACCESS);
+        hit += (CACHE_SIM_L1_HIT & rc) ? 1 : 0;
+        access++;
+
+        if (NULL != level) {
+            level[i] = (CACHE_SIM_L1_HIT & rc) ? 1 : 2;
+        }
+    }
+
+    cache->thread_stats[thread].access += access;
+    cache->thread_stats[thread].hit    += hit;
+    cache->thread_stats[thread].miss   += access - hit;
+}
+
+/* cache_sim_parallel_access_batch */
+int cache_sim_parallel_access_batch(cache_handle_t *cache,
+    const uint64_t *address, const uint8_t *write, const size_t count,
+    int *level) {
+    /* variables declaration */
+    int thread = 0;
+
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(cache->threads) schedule(static, 1)
+    #endif
+    for (thread = 0; thread < cache->threads; thread++) {
+        parallel_access_sets(cache, thread, address, write, count, level);
+    }
+
+    /* no thread went further than this */
+    cache->clock += count;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+// EOF
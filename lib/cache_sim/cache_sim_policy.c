@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* System standard headers */
+#include <stdio.h>
+#include <string.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_policy.h"
+#include "cache_policy_lru.h"
+#include "cache_policy_plru.h"
+#include "cache_policy_rrip.h"
+#include "cache_policy_fill.h"
+#include "cache_policy_fifo.h"
+#include "cache_policy_random.h"
+
+/* List of policies, the built-in ones followed by the registered ones */
+static policy_t policies[CACHE_SIM_POLICY_MAX + 1] = {
+    { "lru",    &policy_lru_init,    &policy_lru_access,
+        &policy_lru_invalidate,    1 },
+    { "plru",   &policy_plru_init,   &policy_plru_access,
+        &policy_plru_invalidate,   1 },
+    { "srrip",  &policy_rrip_init,   &policy_srrip_access,
+        &policy_rrip_invalidate,   1 },
+    { "brrip",  &policy_rrip_init,   &policy_brrip_access,
+        &policy_rrip_invalidate,   1 },
+    { "drrip",  &policy_rrip_init,   &policy_drrip_access,
+        &policy_rrip_invalidate,   0 },
+    { "fifo",   &policy_fifo_init,   &policy_fifo_access,
+        &policy_fill_invalidate,   1 },
+    { "random", &policy_random_init, &policy_random_access,
+        &policy_fill_invalidate,   1 },
+    { NULL,     NULL,                NULL,
+        NULL,                      0 }
+};
+
+/* cache_sim_policy_register */
+int cache_sim_policy_register(const policy_t *policy) {
+    /* sanity check: does policy have a name and all functions? */
+    if ((NULL == policy) || (NULL == policy->name) ||
+        (NULL == policy->init_fn) || (NULL == policy->access_fn) ||
+        (NULL == policy->invalidate_fn)) {
+        printf("Error: policy is incomplete\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: is the name already taken? */
+    if (NULL != cache_sim_policy_find(policy->name)) {
+        printf("Error: policy %s is already registered\n", policy->name);
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    int i = 0;
+
+    while (NULL != policies[i].name) {
+        i++;
+    }
+
+    /* sanity check: is there room for one more? */
+    if (CACHE_SIM_POLICY_MAX <= i) {
+        printf("Error: too many policies\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* the name is not copied, it should outlive the policy */
+    policies[i] = *policy;
+    policies[i + 1].name = NULL;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_policy_find */
+const policy_t* cache_sim_policy_find(const char *name) {
+    int i = 0;
+
+    if (NULL == name) {
+        return NULL;
+    }
+
+    while (NULL != policies[i].name) {
+        if (0 == strcmp(name, policies[i].name)) {
+            return &(policies[i]);
+        }
+        i++;
+    }
+
+    return NULL;
+}
+
+/* cache_sim_policy_name */
+const char* cache_sim_policy_name(const int i) {
+    int j = 0;
+
+    /* policies are never removed, so names can be walked by index */
+    for (j = 0; (j < i) && (NULL != policies[j].name); j++);
+
+    return (0 > i) ? NULL : policies[j].name;
+}
+
+// EOF
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef CACHE_SIM_POLICY_H_
+#define CACHE_SIM_POLICY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CACHE_SIM_H_
+#include "cache_sim.h"
+#endif
+
+#ifndef CACHE_SIM_TYPES_H_
+#include "cache_sim_types.h"
+#endif
+
+/* Maximum number of policies, built-in ones included */
+#define CACHE_SIM_POLICY_MAX 32
+
+/* Functions declaration */
+int cache_sim_policy_register(const policy_t *policy);
+const policy_t* cache_sim_policy_find(const char *name);
+const char* cache_sim_policy_name(const int i);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_SIM_POLICY_H_ */
@@ -21,13 +21,100 @@
 
 /* System standard headers */
 #include <inttypes.h>
+#include <stdlib.h>
 #include <stdio.h>
 
 /* Cache simulator headers */
 #include "cache_sim.h"
 #include "cache_sim_types.h"
+#include "cache_sim_util.h"
 #include "cache_sim_prefetcher.h"
 
+/* Names of the prefetchers, as reported by the statistics */
+static const char *prefetcher_names[] = {
+    "Next line", NULL, "Stride", "Stream"
+};
+
+/* prefetcher_source */
+static inline int prefetcher_source(const load_t load) {
+    if (LOAD_PREFETCH_STRIDE == load) {
+        return PREFETCHER_STRIDE;
+    }
+    if (LOAD_PREFETCH_STREAM == load) {
+        return PREFETCHER_STREAM;
+    }
+    return PREFETCHER_NEXT_LINE_SINGLE;
+}
+
+/* prefetcher_data */
+static prefetcher_data_t* prefetcher_data(cache_handle_t *cache) {
+    /* variables declaration */
+    prefetcher_data_t *data = cache->prefetcher_data;
+    int i = 0;
+
+    if (NULL != data) {
+        return data;
+    }
+
+    data = (prefetcher_data_t *)malloc(sizeof(prefetcher_data_t));
+    if (NULL == data) {
+        printf("Error: unable to allocate memory for prefetchers\n");
+        return NULL;
+    }
+
+    data->stride_entries  = 0;
+    data->stride_distance = PREFETCHER_STRIDE_DISTANCE;
+    data->stride_degree   = PREFETCHER_STRIDE_DEGREE;
+    data->stream_entries  = 0;
+    data->stream_distance = PREFETCHER_STREAM_DISTANCE;
+    data->stream_degree   = PREFETCHER_STREAM_DEGREE;
+    data->latency         = PREFETCHER_LATENCY;
+    data->stride          = NULL;
+    data->stream          = NULL;
+    data->inflight_next   = 0;
+
+    for (i = 0; i < PREFETCHER_INFLIGHT; i++) {
+        data->inflight[i].line_id = UINT64_MAX;
+        data->inflight[i].clock = 0;
+    }
+    for (i = 0; i < PREFETCHER_INVALID; i++) {
+        data->stats[i].issued  = 0;
+        data->stats[i].useful  = 0;
+        data->stats[i].late    = 0;
+        data->stats[i].useless = 0;
+    }
+
+    cache->prefetcher_data = data;
+
+    return data;
+}
+
+/* prefetcher_print */
+static void prefetcher_print(cache_handle_t *cache) {
+    prefetcher_data_t *data = cache->prefetcher_data;
+
+    printf("--------------------------------\n");
+    printf("Next line prefetcher: %10s\n",
+        (PREFETCHER_INVALID == cache->next_line) ? "OFF" :
+            ((PREFETCHER_NEXT_LINE_SINGLE == cache->next_line) ? "SINGLE" :
+                (PREFETCHER_NEXT_LINE_TAGGED == cache->next_line) ? "TAGGED" :
+                    "UNKNOWN"));
+    if ((NULL != data) && (0 < data->stride_entries)) {
+        printf("Stride prefetcher: %13s\n", "ON");
+        printf(" -> entries     %16d\n", data->stride_entries);
+        printf(" -> distance    %16d\n", data->stride_distance);
+        printf(" -> degree      %16d\n", data->stride_degree);
+    }
+    if ((NULL != data) && (0 < data->stream_entries)) {
+        printf("Stream prefetcher: %13s\n", "ON");
+        printf(" -> streams     %16d\n", data->stream_entries);
+        printf(" -> distance    %16d\n", data->stream_distance);
+        printf(" -> degree      %16d\n", data->stream_degree);
+    }
+    printf("      Hardware prefetcher       \n");
+    printf("--------------------------------\n");
+}
+
 /* cache_sim_prefetcher_enable */
 int cache_sim_prefetcher_enable(cache_handle_t *cache, prefetcher_t type) {
     /* sanity check: does cache exist? */
@@ -36,6 +123,29 @@ int cache_sim_prefetcher_enable(cache_handle_t *cache, prefetcher_t type) {
         return CACHE_SIM_ERROR;
     }
 
+    /* enable the stride or stream prefetcher with its default settings */
+    if (PREFETCHER_STRIDE == type) {
+        return cache_sim_prefetcher_configure(cache, type,
+            PREFETCHER_STRIDE_ENTRIES, PREFETCHER_STRIDE_DISTANCE,
+            PREFETCHER_STRIDE_DEGREE);
+    }
+    if (PREFETCHER_STREAM == type) {
+        return cache_sim_prefetcher_configure(cache, type,
+            PREFETCHER_STREAM_ENTRIES, PREFETCHER_STREAM_DISTANCE,
+            PREFETCHER_STREAM_DEGREE);
+    }
+
+    /* unknown prefetcher type */
+    if (PREFETCHER_INVALID <= type) {
+        printf("Error: unknown prefetcher type\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* statistics are kept for every prefetcher */
+    if (NULL == prefetcher_data(cache)) {
+        return CACHE_SIM_ERROR;
+    }
+
     /* enable prefetcher next line on a miss (single line prefetching) */
     if (PREFETCHER_NEXT_LINE_SINGLE == type) {
         cache->next_line = PREFETCHER_NEXT_LINE_SINGLE;
@@ -46,21 +156,87 @@ int cache_sim_prefetcher_enable(cache_handle_t *cache, prefetcher_t type) {
         cache->next_line = PREFETCHER_NEXT_LINE_TAGGED;
     }
 
-    /* unknown prefetcher type */
-    if (PREFETCHER_INVALID <= type) {
-        printf("Error: unknown prefetcher type\n");
+    /* be nice and print something... */
+    if (cache_sim_verbose) {
+        prefetcher_print(cache);
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_prefetcher_configure */
+int cache_sim_prefetcher_configure(cache_handle_t *cache, prefetcher_t type,
+    const int entries, const int distance, const int degree) {
+    /* sanity check: does cache exist? */
+    if (NULL == cache) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: only the stride and stream prefetchers have settings */
+    if ((PREFETCHER_STRIDE != type) && (PREFETCHER_STREAM != type)) {
+        printf("Error: prefetcher type can not be configured\n");
         return CACHE_SIM_ERROR;
     }
 
+    /* sanity check: settings are positive */
+    if ((0 >= entries) || (0 >= distance) || (0 >= degree)) {
+        printf("Error: prefetcher settings must be larger than 0\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    prefetcher_data_t *data = prefetcher_data(cache);
+    int i = 0;
+
+    if (NULL == data) {
+        return CACHE_SIM_ERROR;
+    }
+
+    if (PREFETCHER_STRIDE == type) {
+        free(data->stride);
+        data->stride = (stride_entry_t *)malloc(entries *
+            sizeof(stride_entry_t));
+        if (NULL == data->stride) {
+            printf("Error: unable to allocate memory for stride table\n");
+            data->stride_entries = 0;
+            return CACHE_SIM_ERROR;
+        }
+        for (i = 0; i < entries; i++) {
+            data->stride[i].ip = UINT64_MAX;
+            data->stride[i].address = 0;
+            data->stride[i].stride = 0;
+            data->stride[i].prefetched = UINT64_MAX;
+            data->stride[i].confidence = 0;
+        }
+        data->stride_entries  = entries;
+        data->stride_distance = distance;
+        data->stride_degree   = degree;
+    } else {
+        free(data->stream);
+        data->stream = (stream_entry_t *)malloc(entries *
+            sizeof(stream_entry_t));
+        if (NULL == data->stream) {
+            printf("Error: unable to allocate memory for stream table\n");
+            data->stream_entries = 0;
+            return CACHE_SIM_ERROR;
+        }
+        for (i = 0; i < entries; i++) {
+            data->stream[i].line_id = UINT64_MAX;
+            data->stream[i].frontier = UINT64_MAX;
+            data->stream[i].clock = 0;
+            data->stream[i].direction = 0;
+            data->stream[i].confidence = 0;
+        }
+        data->stream_entries  = entries;
+        data->stream_distance = distance;
+        data->stream_degree   = degree;
+    }
+
     /* be nice and print something... */
-    printf("--------------------------------\n");
-    printf("Next line prefetcher: %10s\n",
-        (PREFETCHER_INVALID == cache->next_line) ? "OFF" :
-            ((PREFETCHER_NEXT_LINE_SINGLE == cache->next_line) ? "SINGLE" :
-                (PREFETCHER_NEXT_LINE_TAGGED == cache->next_line) ? "TAGGED" :
-                    "UNKNOWN"));
-    printf("      Hardware prefetcher       \n");
-    printf("--------------------------------\n");
+    if (cache_sim_verbose) {
+        prefetcher_print(cache);
+    }
 
     return CACHE_SIM_SUCCESS;
 }
@@ -79,6 +255,18 @@ int cache_sim_prefetcher_disable(cache_handle_t *cache, prefetcher_t type) {
         cache->next_line = PREFETCHER_INVALID;
     }
 
+    /* disable the stride or stream prefetcher, statistics are kept */
+    if ((PREFETCHER_STRIDE == type) && (NULL != cache->prefetcher_data)) {
+        free(cache->prefetcher_data->stride);
+        cache->prefetcher_data->stride = NULL;
+        cache->prefetcher_data->stride_entries = 0;
+    }
+    if ((PREFETCHER_STREAM == type) && (NULL != cache->prefetcher_data)) {
+        free(cache->prefetcher_data->stream);
+        cache->prefetcher_data->stream = NULL;
+        cache->prefetcher_data->stream_entries = 0;
+    }
+
     /* unknown prefetcher type */
     if (PREFETCHER_INVALID <= type) {
         printf("Error: unknown prefetcher type\n");
@@ -86,16 +274,263 @@ int cache_sim_prefetcher_disable(cache_handle_t *cache, prefetcher_t type) {
     }
 
     /* be nice and print something... */
-    printf("--------------------------------\n");
-    printf("Next line prefetcher: %10s\n",
-        (PREFETCHER_INVALID == cache->next_line) ? "OFF" :
-            ((PREFETCHER_NEXT_LINE_SINGLE == cache->next_line) ? "SINGLE" :
-                (PREFETCHER_NEXT_LINE_TAGGED == cache->next_line) ? "TAGGED" :
-                    "UNKNOWN"));
-    printf("      Hardware prefetcher       \n");
-    printf("--------------------------------\n");
+    if (cache_sim_verbose) {
+        prefetcher_print(cache);
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_prefetcher_fini */
+int cache_sim_prefetcher_fini(cache_handle_t *cache) {
+    /* sanity check: are prefetchers enabled? */
+    if ((NULL == cache) || (NULL == cache->prefetcher_data)) {
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variables declaration */
+    prefetcher_data_t *data = cache->prefetcher_data;
+    prefetcher_stats_t *stats = NULL;
+    int i = 0;
+
+    /* accuracy is the share of useful prefetches, coverage the share of
+     * misses avoided, and late prefetches were useful but still in flight
+     */
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        for (i = 0; i < PREFETCHER_INVALID; i++) {
+            stats = &(data->stats[i]);
+            if ((NULL == prefetcher_names[i]) || (0 == stats->issued)) {
+                continue;
+            }
+            printf("%s prefetcher:\n", prefetcher_names[i]);
+            printf(" -> issued      %16"PRIu64"\n", stats->issued);
+            printf(" -> useful      %16"PRIu64"\n", stats->useful);
+            printf(" -> late        %16"PRIu64"\n", stats->late);
+            printf(" -> useless     %16"PRIu64"\n", stats->useless);
+            printf(" -> accuracy    %15.2f%%\n",
+                (((double)stats->useful / (double)stats->issued) * 100));
+            printf(" -> coverage    %15.2f%%\n",
+                (((double)stats->useful /
+                    (double)(stats->useful + cache->miss)) * 100));
+            printf(" -> timeliness  %15.2f%%\n", (0 == stats->useful) ? 0 :
+                (((double)(stats->useful - stats->late) /
+                    (double)stats->useful) * 100));
+        }
+        printf("     Prefetchers finalized      \n");
+        printf("--------------------------------\n");
+    }
+
+    free(data->stride);
+    free(data->stream);
+    free(data);
+    cache->prefetcher_data = NULL;
 
     return CACHE_SIM_SUCCESS;
 }
 
+/* cache_sim_prefetcher_issue */
+int cache_sim_prefetcher_issue(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    /* variables declaration */
+    prefetcher_data_t *data = cache->prefetcher_data;
+    int rc = cache->access_fn(cache, line_id, load);
+
+    #ifdef DEBUG
+    printf("PREFET line id [%018p] load reason [%d]\n", line_id, load);
+    #endif
+
+    /* only lines actually loaded count, and they may take a while */
+    if ((NULL != data) && (CACHE_SIM_L1_MISS & rc)) {
+        data->stats[prefetcher_source(load)].issued++;
+
+        data->inflight[data->inflight_next].line_id = line_id;
+        data->inflight[data->inflight_next].clock = cache->clock;
+        data->inflight_next = (data->inflight_next + 1) % PREFETCHER_INFLIGHT;
+
+        if (CACHE_SIM_L1_PREFETCH_EVICT & rc) {
+            data->stats[prefetcher_source(cache->prefetch_load)].useless++;
+        }
+    }
+
+    return rc;
+}
+
+/* cache_sim_prefetcher_account */
+void cache_sim_prefetcher_account(cache_handle_t *cache,
+    const uint64_t line_id, const int rc) {
+    /* variables declaration */
+    prefetcher_data_t *data = cache->prefetcher_data;
+    prefetcher_stats_t *stats = NULL;
+    int i = 0;
+
+    /* a demand access evicted a line that was prefetched for nothing */
+    if (CACHE_SIM_L1_PREFETCH_EVICT & rc) {
+        data->stats[prefetcher_source(cache->prefetch_load)].useless++;
+        return;
+    }
+
+    if (0 == (CACHE_SIM_L1_HIT_PREFETCH & rc)) {
+        return;
+    }
+
+    /* a demand access hit a prefetched line, was it there in time? */
+    stats = &(data->stats[prefetcher_source(cache->prefetch_load)]);
+    stats->useful++;
+
+    for (i = 0; i < PREFETCHER_INFLIGHT; i++) {
+        if (line_id == data->inflight[i].line_id) {
+            if ((cache->clock - data->inflight[i].clock) <
+                (uint64_t)data->latency) {
+                stats->late++;
+            }
+            data->inflight[i].line_id = UINT64_MAX;
+            break;
+        }
+    }
+}
+
+/* prefetcher_stride */
+static void prefetcher_stride(cache_handle_t *cache, prefetcher_data_t *data,
+    const uint64_t address, const uint64_t ip) {
+    /* variables declaration */
+    stride_entry_t *entry = &(data->stride[ip % data->stride_entries]);
+    uint64_t mask = ~(((uint64_t)1 << cache->offset_length) - 1);
+    uint64_t line_id = UINT64_MAX;
+    int64_t stride = 0;
+    int i = 0;
+
+    /* a new IP takes the entry over */
+    if (ip != entry->ip) {
+        entry->ip = ip;
+        entry->address = address;
+        entry->stride = 0;
+        entry->prefetched = UINT64_MAX;
+        entry->confidence = 0;
+        return;
+    }
+
+    stride = (int64_t)(address - entry->address);
+    entry->address = address;
+
+    if (0 == stride) {
+        return;
+    }
+
+    /* the same stride has to be seen twice in a row */
+    if (stride != entry->stride) {
+        entry->stride = stride;
+        entry->confidence = 0;
+        return;
+    }
+    if (3 > entry->confidence) {
+        entry->confidence++;
+    }
+
+    for (i = 0; i < data->stride_degree; i++) {
+        line_id = (address + (stride * (data->stride_distance + i))) & mask;
+
+        /* small strides stay on the same line for a while */
+        if ((line_id == (address & mask)) || (line_id == entry->prefetched)) {
+            continue;
+        }
+
+        entry->prefetched = line_id;
+        cache_sim_prefetcher_issue(cache, line_id, LOAD_PREFETCH_STRIDE);
+    }
+}
+
+/* prefetcher_stream */
+static void prefetcher_stream(cache_handle_t *cache, prefetcher_data_t *data,
+    const uint64_t line_id) {
+    /* variables declaration */
+    stream_entry_t *entry = NULL;
+    stream_entry_t *lru = &(data->stream[0]);
+    int64_t delta = 0;
+    uint64_t next = 0;
+    int i = 0;
+
+    /* find the stream this line belongs to, or the least recently used one */
+    for (i = 0; i < data->stream_entries; i++) {
+        if (UINT64_MAX != data->stream[i].line_id) {
+            delta = ((int64_t)(line_id - data->stream[i].line_id)) >>
+                cache->offset_length;
+            if ((delta <= data->stream_distance) &&
+                (delta >= -data->stream_distance)) {
+                entry = &(data->stream[i]);
+                break;
+            }
+        }
+        if (data->stream[i].clock < lru->clock) {
+            lru = &(data->stream[i]);
+        }
+    }
+
+    /* start a new stream */
+    if (NULL == entry) {
+        lru->line_id = line_id;
+        lru->frontier = line_id;
+        lru->clock = cache->clock;
+        lru->direction = 0;
+        lru->confidence = 0;
+        return;
+    }
+
+    entry->clock = cache->clock;
+    if (0 == delta) {
+        return;
+    }
+
+    /* two accesses in the same direction confirm the stream */
+    if (((0 < delta) ? 1 : -1) != entry->direction) {
+        entry->direction = (0 < delta) ? 1 : -1;
+        entry->confidence = 0;
+        entry->line_id = line_id;
+        entry->frontier = line_id;
+        return;
+    }
+    if (3 > entry->confidence) {
+        entry->confidence++;
+    }
+    entry->line_id = line_id;
+
+    /* the frontier never falls behind the stream */
+    delta = ((int64_t)(entry->frontier - line_id)) >> cache->offset_length;
+    if (0 > (delta * entry->direction)) {
+        entry->frontier = line_id;
+    }
+
+    /* keep up to distance lines ahead, degree lines at a time */
+    for (i = 0; i < data->stream_degree; i++) {
+        next = entry->frontier + (entry->direction * cache->line_size);
+        delta = ((int64_t)(next - line_id)) >> cache->offset_length;
+        if ((delta * entry->direction) > data->stream_distance) {
+            break;
+        }
+        entry->frontier = next;
+        cache_sim_prefetcher_issue(cache, next, LOAD_PREFETCH_STREAM);
+    }
+}
+
+/* cache_sim_prefetcher_train */
+void cache_sim_prefetcher_train(cache_handle_t *cache, const uint64_t address,
+    const uint64_t ip, const int rc) {
+    /* variables declaration */
+    prefetcher_data_t *data = cache->prefetcher_data;
+    uint64_t line_id = address;
+
+    CACHE_SIM_ADDRESS_TO_LINE_ID(line_id);
+
+    /* the stride prefetcher sees every access of an IP */
+    if (0 < data->stride_entries) {
+        prefetcher_stride(cache, data, address, ip);
+    }
+
+    /* the stream prefetcher sees misses and hits on prefetched lines */
+    if ((0 < data->stream_entries) && ((CACHE_SIM_L1_MISS & rc) ||
+        (CACHE_SIM_L1_HIT_PREFETCH & rc))) {
+        prefetcher_stream(cache, data, line_id);
+    }
+}
+
 // EOF
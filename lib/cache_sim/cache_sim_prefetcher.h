@@ -30,9 +30,31 @@ extern "C" {
 #include "cache_sim.h"
 #endif
 
+#ifndef CACHE_SIM_TYPES_H_
+#include "cache_sim_types.h"
+#endif
+
+/* Default configuration of the stride and stream prefetchers */
+#define PREFETCHER_STRIDE_ENTRIES  256
+#define PREFETCHER_STRIDE_DISTANCE 1
+#define PREFETCHER_STRIDE_DEGREE   1
+#define PREFETCHER_STREAM_ENTRIES  32
+#define PREFETCHER_STREAM_DISTANCE 20
+#define PREFETCHER_STREAM_DEGREE   2
+#define PREFETCHER_LATENCY         8
+
 /* Functions declaration */
 int cache_sim_prefetcher_enable(cache_handle_t *cache, prefetcher_t type);
 int cache_sim_prefetcher_disable(cache_handle_t *cache, prefetcher_t type);
+int cache_sim_prefetcher_configure(cache_handle_t *cache, prefetcher_t type,
+    const int entries, const int distance, const int degree);
+int cache_sim_prefetcher_fini(cache_handle_t *cache);
+int cache_sim_prefetcher_issue(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load);
+void cache_sim_prefetcher_account(cache_handle_t *cache,
+    const uint64_t line_id, const int rc);
+void cache_sim_prefetcher_train(cache_handle_t *cache, const uint64_t address,
+    const uint64_t ip, const int rc);
 
 #ifdef __cplusplus
 }
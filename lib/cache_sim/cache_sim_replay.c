@@ -0,0 +1,741 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* Replays a binary trace through the cache simulator. Traces are mapped in
+ * memory, so raw traces go to the batch functions without being copied.
+ *
+ *   cache_sim_replay -f trace.bin -s 32K -a 8 -p lru
+ *   cache_sim_replay -f macpo.out -F macpo -L 1M,16,srrip -n 4 -P moesi
+ */
+
+/* System standard headers */
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_coherence.h"
+#include "cache_sim_conflict.h"
+#include "cache_sim_hierarchy.h"
+#include "cache_sim_mrc.h"
+#include "cache_sim_parallel.h"
+#include "cache_sim_prefetcher.h"
+#include "cache_sim_reuse.h"
+#include "cache_sim_symbol.h"
+
+/* MACPO trace records */
+#ifdef HAVE_MACPO_RECORD_H
+#include "macpo_record.h"
+#endif
+
+/* Levels below the first one */
+#define REPLAY_MAX_LEVELS 8
+
+/* Trace formats */
+typedef enum {
+    FORMAT_RAW,   // one uint64_t address per access
+    FORMAT_MACPO  // node_t records written by MACPO
+} format_t;
+
+/* Replay configuration, filled by parse_cli_params() */
+typedef struct {
+    const char *inputfile;
+    const char *outputfile;
+    format_t format;
+    cache_level_t level[REPLAY_MAX_LEVELS + 1];
+    int total_levels;
+    prefetcher_t prefetcher;
+    uint64_t reuse;
+    double mrc;
+    int conflict;
+    int symbols;
+    int threads;
+    int cores;
+    coherence_t protocol;
+    int quiet;
+} config_t;
+
+/* Replay state: the trace and whatever simulates it */
+typedef struct {
+    const config_t *config;
+    const void *trace;
+    size_t size;
+    cache_handle_t *cache;
+    cache_hierarchy_t *hierarchy;
+    cache_coherence_t *coherence;
+    char **streams;
+    size_t total_streams;
+    uint64_t access;
+} replay_t;
+
+/* Batch of decoded MACPO accesses */
+typedef struct {
+    uint64_t address[CACHE_SIM_BATCH_LENGTH];
+    uint64_t ip[CACHE_SIM_BATCH_LENGTH];
+    size_t var_idx[CACHE_SIM_BATCH_LENGTH];
+    uint8_t write[CACHE_SIM_BATCH_LENGTH];
+    uint8_t core[CACHE_SIM_BATCH_LENGTH];
+    size_t length;
+} batch_t;
+
+/* Structure to handle command line arguments. Try to keep the content of
+ * this structure compatible with the parse_cli_params() and show_help().
+ */
+static struct option long_options[] = {
+    {"associativity", required_argument, NULL, 'a'},
+    {"conflict",      no_argument,       NULL, 'c'},
+    {"prefetcher",    required_argument, NULL, 'e'},
+    {"inputfile",     required_argument, NULL, 'f'},
+    {"format",        required_argument, NULL, 'F'},
+    {"help",          no_argument,       NULL, 'h'},
+    {"line",          required_argument, NULL, 'l'},
+    {"level",         required_argument, NULL, 'L'},
+    {"mrc",           required_argument, NULL, 'm'},
+    {"cores",         required_argument, NULL, 'n'},
+    {"outputfile",    required_argument, NULL, 'o'},
+    {"policy",        required_argument, NULL, 'p'},
+    {"protocol",      required_argument, NULL, 'P'},
+    {"quiet",         no_argument,       NULL, 'q'},
+    {"reuse",         required_argument, NULL, 'r'},
+    {"size",          required_argument, NULL, 's'},
+    {"threads",       required_argument, NULL, 't'},
+    {"symbols",       no_argument,       NULL, 'y'},
+    {0, 0, 0, 0}
+};
+
+/* Names accepted by --prefetcher, in prefetcher_t order */
+static const char *prefetcher_names[] = {
+    "next", "tagged", "stride", "stream"
+};
+
+/* Names accepted by the inclusion field of --level, in inclusion_t order */
+static const char *inclusion_names[] = {
+    "inclusive", "exclusive", "nine"
+};
+
+/* show_help */
+static void show_help(void) {
+    /*      12345678901234567890123456789012345678901234567890123456789012345678901234567890 */
+    printf("Usage: cache_sim_replay -f file [-F format] [-s size] [-l line] [-a ways]\n");
+    printf("                        [-p policy] [-L level]... [-e prefetcher] [-c]\n");
+    printf("                        [-r lines] [-m rate] [-y] [-t threads] [-n cores]\n");
+    printf("                        [-P protocol] [-o file] [-qh]\n\n");
+    printf("  -f --inputfile     Trace to replay\n");
+    printf("  -F --format        'raw' (uint64_t addresses, default) or 'macpo' (macpo.out\n");
+    printf("                     records of the first MPI rank in the file)\n");
+    printf("  -s --size          Size of the first level (default: 32K)\n");
+    printf("  -l --line          Line size of all levels (default: 64)\n");
+    printf("  -a --associativity Associativity of the first level (default: 8)\n");
+    printf("  -p --policy        Replacement policy of the first level (default: lru)\n");
+    printf("  -L --level         Add a level below the others, as size,ways,policy and\n");
+    printf("                     optionally inclusive, exclusive or nine (default)\n");
+    printf("  -e --prefetcher    Enable the next, tagged, stride or stream prefetcher, the\n");
+    printf("                     MACPO line number of each access is used as its IP\n");
+    printf("  -c --conflict      Count set associative conflicts\n");
+    printf("  -r --reuse         Calculate reuse distances up to 'lines'\n");
+    printf("  -m --mrc           Write the miss ratio curve sampling 'rate' of the lines\n");
+    printf("  -y --symbols       Count accesses per MACPO variable\n");
+    printf("  -t --threads       Simulate sets in parallel using 'threads' threads\n");
+    printf("  -n --cores         Give each of 'cores' cores a copy of the first level and\n");
+    printf("                     share the second one (MACPO core ids wrap around)\n");
+    printf("  -P --protocol      Coherence protocol: mesi (default) or moesi\n");
+    printf("  -o --outputfile    Write curves, symbols and coherence reports to 'file'\n");
+    printf("                     (default: stdout)\n");
+    printf("  -q --quiet         Print only the throughput\n");
+    printf("  -h --help          Show this message\n");
+}
+
+/* parse_size */
+static int parse_size(const char *text, uint64_t *size) {
+    /* variables declaration */
+    char *end = NULL;
+
+    *size = strtoull(text, &end, 10);
+    switch (*end) {
+        case 'k': case 'K': *size <<= 10; end++; break;
+        case 'm': case 'M': *size <<= 20; end++; break;
+        case 'g': case 'G': *size <<= 30; end++; break;
+    }
+
+    if ((end == text) || (('\0' != *end) && (',' != *end)) || (0 == *size) ||
+        (UINT32_MAX < *size)) {
+        printf("Error: invalid size '%s'\n", text);
+        return CACHE_SIM_ERROR;
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* parse_name, returns the index of text in names or -1 */
+static int parse_name(const char *text, const char **names, const int total) {
+    /* variables declaration */
+    int i = 0;
+
+    for (i = 0; i < total; i++) {
+        if (0 == strcasecmp(text, names[i])) {
+            return i;
+        }
+    }
+    printf("Error: unknown option '%s'\n", text);
+
+    return -1;
+}
+
+/* parse_level */
+static int parse_level(char *text, cache_level_t *level) {
+    /* variables declaration */
+    char *field[4] = { NULL };
+    uint64_t value = 0;
+    int i = 0, inclusion = HIERARCHY_NINE;
+
+    /* size,ways,policy[,inclusion] */
+    field[0] = strtok(text, ",");
+    for (i = 1; (i < 4) && (NULL != field[i - 1]); i++) {
+        field[i] = strtok(NULL, ",");
+    }
+    if ((NULL == field[2]) || (NULL != strtok(NULL, ","))) {
+        printf("Error: levels are described as size,ways,policy[,inclusion]\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    if (CACHE_SIM_SUCCESS != parse_size(field[0], &value)) {
+        return CACHE_SIM_ERROR;
+    }
+    level->total_size = value;
+    level->associativity = atoi(field[1]);
+    level->policy = field[2];
+    if ((NULL != field[3]) && (0 > (inclusion = parse_name(field[3],
+        inclusion_names, HIERARCHY_INVALID)))) {
+        return CACHE_SIM_ERROR;
+    }
+    level->inclusion = inclusion;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* parse_cli_params */
+static int parse_cli_params(int argc, char *argv[], config_t *config) {
+    /* variables declaration */
+    const char *protocols[] = { "mesi", "moesi" };
+    const char *formats[] = { "raw", "macpo" };
+    uint64_t value = 0;
+    int parameter = 0, option_index = 0, i = 0;
+
+    /* 32KB, 8-way, LRU */
+    memset(config, 0, sizeof(config_t));
+    config->level[0].total_size = 32768;
+    config->level[0].line_size = 64;
+    config->level[0].associativity = 8;
+    config->level[0].policy = "lru";
+    config->level[0].inclusion = HIERARCHY_NINE;
+    config->total_levels = 1;
+    config->prefetcher = PREFETCHER_INVALID;
+    config->threads = 1;
+    config->protocol = COHERENCE_MESI;
+
+    while (-1 != (parameter = getopt_long(argc, argv,
+        "a:ce:f:F:hl:L:m:n:o:p:P:qr:s:t:y", long_options, &option_index))) {
+        switch (parameter) {
+            case 'a':
+                config->level[0].associativity = atoi(optarg);
+                break;
+            case 'c':
+                config->conflict = 1;
+                break;
+            case 'e':
+                if (0 > (i = parse_name(optarg, prefetcher_names,
+                    PREFETCHER_INVALID))) {
+                    return CACHE_SIM_ERROR;
+                }
+                config->prefetcher = i;
+                break;
+            case 'f':
+                config->inputfile = optarg;
+                break;
+            case 'F':
+                if (0 > (i = parse_name(optarg, formats, 2))) {
+                    return CACHE_SIM_ERROR;
+                }
+                config->format = i;
+                break;
+            case 'h':
+                show_help();
+                exit(0);
+            case 'l':
+                if (CACHE_SIM_SUCCESS != parse_size(optarg, &value)) {
+                    return CACHE_SIM_ERROR;
+                }
+                config->level[0].line_size = value;
+                break;
+            case 'L':
+                if (REPLAY_MAX_LEVELS < config->total_levels) {
+                    printf("Error: too many levels\n");
+                    return CACHE_SIM_ERROR;
+                }
+                if (CACHE_SIM_SUCCESS != parse_level(optarg,
+                    &(config->level[config->total_levels]))) {
+                    return CACHE_SIM_ERROR;
+                }
+                config->total_levels++;
+                break;
+            case 'm':
+                config->mrc = atof(optarg);
+                break;
+            case 'n':
+                config->cores = atoi(optarg);
+                break;
+            case 'o':
+                config->outputfile = optarg;
+                break;
+            case 'p':
+                config->level[0].policy = optarg;
+                break;
+            case 'P':
+                if (0 > (i = parse_name(optarg, protocols,
+                    COHERENCE_INVALID))) {
+                    return CACHE_SIM_ERROR;
+                }
+                config->protocol = i;
+                break;
+            case 'q':
+                config->quiet = 1;
+                break;
+            case 'r':
+                config->reuse = strtoull(optarg, NULL, 10);
+                break;
+            case 's':
+                if (CACHE_SIM_SUCCESS != parse_size(optarg, &value)) {
+                    return CACHE_SIM_ERROR;
+                }
+                config->level[0].total_size = value;
+                break;
+            case 't':
+                config->threads = atoi(optarg);
+                break;
+            case 'y':
+                config->symbols = 1;
+                break;
+            default:
+                show_help();
+                return CACHE_SIM_ERROR;
+        }
+    }
+
+    /* sanity check: is there something to replay? */
+    if (NULL == config->inputfile) {
+        printf("Error: no trace to replay, use -f\n");
+        show_help();
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: can MACPO records be read? */
+    #ifndef HAVE_MACPO_RECORD_H
+    if (FORMAT_MACPO == config->format) {
+        printf("Error: built without MACPO records, only raw traces replay\n");
+        return CACHE_SIM_ERROR;
+    }
+    #endif
+
+    /* all levels share the line size */
+    for (i = 1; i < config->total_levels; i++) {
+        config->level[i].line_size = config->level[0].line_size;
+    }
+
+    /* sanity check: features of a single cache */
+    if ((1 < config->total_levels) && ((PREFETCHER_INVALID !=
+        config->prefetcher) || config->conflict || (0 < config->reuse) ||
+        (0 < config->mrc) || config->symbols)) {
+        printf("Error: prefetchers, conflicts, reuse distances, curves and "
+            "symbols need a single level\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: levels of a hierarchy are simulated one after another */
+    if ((1 < config->total_levels) && (0 == config->cores) &&
+        (1 < config->threads)) {
+        printf("Error: parallel simulation needs a single level or cores\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: coherence needs core ids and a shared level */
+    if ((0 < config->cores) && ((FORMAT_MACPO != config->format) ||
+        (2 != config->total_levels))) {
+        printf("Error: coherence needs a MACPO trace and exactly one -L "
+            "level\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: each report rewrites the output file */
+    if (config->symbols && (0 < config->mrc) && (NULL != config->outputfile)) {
+        printf("Error: curves and symbols cannot share an output file\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* sanity check: symbols come from MACPO variables */
+    if (config->symbols && (FORMAT_MACPO != config->format)) {
+        printf("Error: symbols need a MACPO trace\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* map_trace */
+static int map_trace(replay_t *replay, const char *filename) {
+    /* variables declaration */
+    struct stat st;
+    int fd = -1;
+
+    if (-1 == (fd = open(filename, O_RDONLY))) {
+        printf("Error: unable to open %s\n", filename);
+        return CACHE_SIM_ERROR;
+    }
+    if ((0 != fstat(fd, &st)) || (0 == st.st_size)) {
+        printf("Error: %s is empty\n", filename);
+        close(fd);
+        return CACHE_SIM_ERROR;
+    }
+
+    replay->size = st.st_size;
+    replay->trace = mmap(NULL, replay->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == replay->trace) {
+        printf("Error: unable to map %s in memory\n", filename);
+        replay->trace = NULL;
+        return CACHE_SIM_ERROR;
+    }
+
+    /* the trace is read once, from the beginning to the end */
+    madvise((void *)replay->trace, replay->size, MADV_SEQUENTIAL);
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* replay_init */
+static int replay_init(replay_t *replay) {
+    /* variables declaration */
+    const config_t *config = replay->config;
+    cache_handle_t *cache = NULL;
+
+    if (0 < config->cores) {
+        if (NULL == (replay->coherence = cache_sim_coherence_init(
+            config->cores, &(config->level[0]), &(config->level[1]),
+            config->protocol))) {
+            return CACHE_SIM_ERROR;
+        }
+        if ((1 < config->threads) && (CACHE_SIM_SUCCESS !=
+            cache_sim_coherence_parallel(replay->coherence,
+            config->threads))) {
+            return CACHE_SIM_ERROR;
+        }
+        return CACHE_SIM_SUCCESS;
+    }
+
+    if (1 < config->total_levels) {
+        if (NULL == (replay->hierarchy = cache_sim_hierarchy_init(
+            config->level, config->total_levels))) {
+            return CACHE_SIM_ERROR;
+        }
+        return CACHE_SIM_SUCCESS;
+    }
+
+    if (NULL == (replay->cache = cache = cache_sim_init(
+        config->level[0].total_size, config->level[0].line_size,
+        config->level[0].associativity, config->level[0].policy))) {
+        return CACHE_SIM_ERROR;
+    }
+    if ((PREFETCHER_INVALID != config->prefetcher) && (CACHE_SIM_SUCCESS !=
+        cache_sim_prefetcher_enable(cache, config->prefetcher))) {
+        return CACHE_SIM_ERROR;
+    }
+    if ((0 < config->reuse) && (CACHE_SIM_SUCCESS !=
+        cache_sim_reuse_enable(cache, config->reuse))) {
+        return CACHE_SIM_ERROR;
+    }
+    if (config->conflict && (CACHE_SIM_SUCCESS !=
+        cache_sim_conflict_enable(cache))) {
+        return CACHE_SIM_ERROR;
+    }
+    if ((0 < config->mrc) && (CACHE_SIM_SUCCESS !=
+        cache_sim_mrc_enable(cache, config->mrc))) {
+        return CACHE_SIM_ERROR;
+    }
+    if ((1 < config->threads) && (CACHE_SIM_SUCCESS !=
+        cache_sim_parallel_enable(cache, config->threads))) {
+        return CACHE_SIM_ERROR;
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* replay_fini */
+static int replay_fini(replay_t *replay) {
+    /* variables declaration */
+    const config_t *config = replay->config;
+    int rc = CACHE_SIM_SUCCESS, report = 0;
+    size_t i = 0;
+
+    /* reports go to the output file, or to stdout unless quiet */
+    report = (NULL != config->outputfile) || (0 == config->quiet);
+
+    if (NULL != replay->coherence) {
+        if (report) {
+            rc |= cache_sim_coherence_write(replay->coherence,
+                config->outputfile);
+        }
+        rc |= cache_sim_coherence_fini(replay->coherence);
+    }
+    if (NULL != replay->hierarchy) {
+        rc |= cache_sim_hierarchy_fini(replay->hierarchy);
+    }
+    if (NULL != replay->cache) {
+        if (report && (0 < config->mrc)) {
+            rc |= cache_sim_mrc_write(replay->cache, config->outputfile,
+                MRC_FORMAT_CSV);
+        }
+        if (report && config->symbols) {
+            rc |= cache_sim_symbol_write(replay->cache, config->outputfile);
+        }
+        rc |= cache_sim_fini(replay->cache);
+    }
+
+    for (i = 0; i < replay->total_streams; i++) {
+        free(replay->streams[i]);
+    }
+    free(replay->streams);
+    if (NULL != replay->trace) {
+        munmap((void *)replay->trace, replay->size);
+    }
+
+    return rc;
+}
+
+/* replay_raw */
+static int replay_raw(replay_t *replay) {
+    /* variables declaration */
+    const uint64_t *address = (const uint64_t *)replay->trace;
+
+    replay->access = replay->size / sizeof(uint64_t);
+    if (0 != (replay->size % sizeof(uint64_t))) {
+        printf("Warning: ignoring %d bytes at the end of the trace\n",
+            (int)(replay->size % sizeof(uint64_t)));
+    }
+
+    /* the mapped file is the batch */
+    if (NULL != replay->hierarchy) {
+        return cache_sim_hierarchy_access_batch(replay->hierarchy, address,
+            NULL, replay->access, NULL);
+    }
+    return cache_sim_access_batch(replay->cache, address, NULL,
+        replay->access, NULL);
+}
+
+/* replay_batch */
+static int replay_batch(replay_t *replay, batch_t *batch) {
+    /* variables declaration */
+    const config_t *config = replay->config;
+    size_t i = 0;
+    int rc = CACHE_SIM_SUCCESS;
+
+    replay->access += batch->length;
+
+    if (NULL != replay->coherence) {
+        rc = cache_sim_coherence_access_batch(replay->coherence, batch->core,
+            batch->address, batch->write, batch->length, NULL);
+    } else if (NULL != replay->hierarchy) {
+        rc = cache_sim_hierarchy_access_batch(replay->hierarchy,
+            batch->address, batch->write, batch->length, NULL);
+    } else if (config->symbols) {
+        for (i = 0; i < batch->length; i++) {
+            cache_sim_symbol_access(replay->cache, batch->address[i],
+                (batch->var_idx[i] < replay->total_streams) ?
+                replay->streams[batch->var_idx[i]] : "(unknown)");
+        }
+    } else if (PREFETCHER_INVALID != config->prefetcher) {
+        for (i = 0; i < batch->length; i++) {
+            cache_sim_access_ip(replay->cache, batch->address[i],
+                batch->ip[i]);
+        }
+    } else {
+        rc = cache_sim_access_batch(replay->cache, batch->address,
+            batch->write, batch->length, NULL);
+    }
+    batch->length = 0;
+
+    return rc;
+}
+
+/* replay_macpo */
+static int replay_macpo(replay_t *replay) {
+    #ifndef HAVE_MACPO_RECORD_H
+    return CACHE_SIM_ERROR;
+    #else
+    /* variables declaration */
+    const node_t *node = (const node_t *)replay->trace;
+    size_t total_nodes = replay->size / sizeof(node_t), i = 0;
+    uint32_t rank = 0;
+    batch_t *batch = NULL;
+    char **streams = NULL;
+    int rw = TYPE_UNKNOWN;
+
+    if (0 == total_nodes) {
+        printf("Error: trace has no MACPO records\n");
+        return CACHE_SIM_ERROR;
+    }
+    rank = node[0].rank;
+
+    /* names of the variables first, they index the accesses */
+    for (i = 0; i < total_nodes; i++) {
+        if ((MSG_STREAM_INFO != node[i].type_message) ||
+            (rank != node[i].rank)) {
+            continue;
+        }
+        streams = (char **)realloc(replay->streams,
+            (replay->total_streams + 1) * sizeof(char *));
+        if (NULL == streams) {
+            printf("Error: unable to allocate memory for variable names\n");
+            return CACHE_SIM_ERROR;
+        }
+        replay->streams = streams;
+        replay->streams[replay->total_streams] = strndup(
+            node[i].stream_info.stream_name, STREAM_LENGTH);
+        if (NULL == replay->streams[replay->total_streams]) {
+            printf("Error: unable to allocate memory for variable names\n");
+            return CACHE_SIM_ERROR;
+        }
+        replay->total_streams++;
+    }
+
+    if (NULL == (batch = (batch_t *)malloc(sizeof(batch_t)))) {
+        printf("Error: unable to allocate memory for the batch\n");
+        return CACHE_SIM_ERROR;
+    }
+    batch->length = 0;
+
+    /* then the accesses, a batch at a time */
+    for (i = 0; i < total_nodes; i++) {
+        if (rank != node[i].rank) {
+            continue;
+        }
+        if (MSG_MEM_INFO == node[i].type_message) {
+            batch->address[batch->length] = node[i].mem_info.address;
+            batch->ip[batch->length] = node[i].mem_info.line_number;
+            batch->var_idx[batch->length] = node[i].mem_info.var_idx;
+            batch->core[batch->length] = node[i].mem_info.coreID;
+            rw = node[i].mem_info.read_write;
+        } else if (MSG_TRACE_INFO == node[i].type_message) {
+            batch->address[batch->length] = node[i].trace_info.address;
+            batch->ip[batch->length] = node[i].trace_info.line_number;
+            batch->var_idx[batch->length] = node[i].trace_info.var_idx;
+            batch->core[batch->length] = node[i].trace_info.coreID;
+            rw = node[i].trace_info.read_write;
+        } else {
+            continue;
+        }
+        batch->write[batch->length] = (TYPE_WRITE == rw) ||
+            (TYPE_READ_AND_WRITE == rw);
+        if (0 < replay->config->cores) {
+            batch->core[batch->length] %= replay->config->cores;
+        }
+
+        if (CACHE_SIM_BATCH_LENGTH == ++(batch->length)) {
+            if (CACHE_SIM_SUCCESS != replay_batch(replay, batch)) {
+                free(batch);
+                return CACHE_SIM_ERROR;
+            }
+        }
+    }
+    if ((0 < batch->length) &&
+        (CACHE_SIM_SUCCESS != replay_batch(replay, batch))) {
+        free(batch);
+        return CACHE_SIM_ERROR;
+    }
+    free(batch);
+
+    return CACHE_SIM_SUCCESS;
+    #endif
+}
+
+/* elapsed */
+static double elapsed(struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) +
+        ((end.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/* main */
+int main(int argc, char *argv[]) {
+    /* variables declaration */
+    struct timespec start;
+    config_t config;
+    replay_t replay;
+    double seconds = 0;
+    int rc = CACHE_SIM_ERROR;
+
+    if (CACHE_SIM_SUCCESS != parse_cli_params(argc, argv, &config)) {
+        exit(1);
+    }
+    cache_sim_set_verbose(!config.quiet);
+
+    memset(&replay, 0, sizeof(replay_t));
+    replay.config = &config;
+    if ((CACHE_SIM_SUCCESS != map_trace(&replay, config.inputfile)) ||
+        (CACHE_SIM_SUCCESS != replay_init(&replay))) {
+        replay_fini(&replay);
+        exit(1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    rc = (FORMAT_MACPO == config.format) ? replay_macpo(&replay) :
+        replay_raw(&replay);
+    seconds = elapsed(&start);
+
+    if (!config.quiet) {
+        printf("--------------------------------\n");
+        printf("Replayed:       %16"PRIu64"\n", replay.access);
+        printf("Time:           %14.3f s\n", seconds);
+        printf("Throughput:     %12.0f acc/s\n", replay.access / seconds);
+        printf("--------------------------------\n");
+    } else {
+        printf("%.0f\n", replay.access / seconds);
+    }
+
+    if ((CACHE_SIM_SUCCESS != replay_fini(&replay)) ||
+        (CACHE_SIM_SUCCESS != rc)) {
+        exit(1);
+    }
+
+    exit(0);
+}
+
+// EOF
@@ -30,6 +30,258 @@
 #include "cache_sim_util.h"
 #include "cache_sim_reuse.h"
 
+/* reuse_line */
+static inline reuse_line_t* reuse_line(reuse_data_t *reuse, const uint32_t i) {
+    return &(reuse->slab[i >> REUSE_SLAB_SHIFT][i & (REUSE_SLAB_LINES - 1)]);
+}
+
+/* reuse_hash */
+static inline uint64_t reuse_hash(reuse_data_t *reuse, const uint64_t line_id) {
+    return ((line_id * 0x9E3779B97F4A7C15ULL) >> 32) & reuse->bucket_mask;
+}
+
+/* reuse_find */
+static inline uint32_t reuse_find(reuse_data_t *reuse, const uint64_t line_id) {
+    uint32_t i = reuse->bucket[reuse_hash(reuse, line_id)];
+
+    while ((REUSE_NONE != i) && (line_id != reuse_line(reuse, i)->line_id)) {
+        i = reuse_line(reuse, i)->next;
+    }
+
+    return i;
+}
+
+/* tree_add */
+static inline void tree_add(reuse_data_t *reuse, uint64_t time,
+    const uint32_t value) {
+    for (; time <= reuse->total_times; time += (time & (~time + 1))) {
+        reuse->tree[time] += value;
+    }
+}
+
+/* tree_sum */
+static inline uint64_t tree_sum(reuse_data_t *reuse, uint64_t time) {
+    uint64_t sum = 0;
+
+    for (; 0 < time; time -= (time & (~time + 1))) {
+        sum += reuse->tree[time];
+    }
+
+    return sum;
+}
+
+/* reuse_rehash */
+static int reuse_rehash(reuse_data_t *reuse, const uint64_t total_buckets) {
+    /* variables declaration */
+    reuse_line_t *line = NULL;
+    uint64_t hash = 0;
+    uint32_t i = 0;
+
+    free(reuse->bucket);
+    reuse->bucket = (uint32_t *)malloc(total_buckets * sizeof(uint32_t));
+    if (NULL == reuse->bucket) {
+        printf("Error: unable to allocate memory to reuse distance area\n");
+        return CACHE_SIM_ERROR;
+    }
+    reuse->bucket_mask = total_buckets - 1;
+
+    for (hash = 0; hash < total_buckets; hash++) {
+        reuse->bucket[hash] = REUSE_NONE;
+    }
+
+    /* every allocated line is being tracked */
+    for (i = 0; i < reuse->total_lines; i++) {
+        line = reuse_line(reuse, i);
+        hash = reuse_hash(reuse, line->line_id);
+        line->next = reuse->bucket[hash];
+        reuse->bucket[hash] = i;
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* reuse_compact */
+static int reuse_compact(reuse_data_t *reuse) {
+    /* variables declaration */
+    uint64_t total_times = reuse->total_times;
+    uint64_t time = 0;
+    uint64_t next = 0;
+    uint64_t t = 0;
+
+    /* renumber live timestamps from 1, keeping their order */
+    for (t = reuse->oldest; t <= reuse->now; t++) {
+        if (REUSE_NONE != reuse->owner[t]) {
+            time++;
+            reuse->owner[time] = reuse->owner[t];
+            reuse_line(reuse, reuse->owner[time])->time = time;
+        }
+    }
+
+    /* keep at least half of the timestamps free, so compacting is rare */
+    if (reuse->live > (total_times / 2)) {
+        total_times *= 2;
+        reuse->tree = (uint32_t *)realloc(reuse->tree,
+            (total_times + 1) * sizeof(uint32_t));
+        reuse->owner = (uint32_t *)realloc(reuse->owner,
+            (total_times + 1) * sizeof(uint32_t));
+        if ((NULL == reuse->tree) || (NULL == reuse->owner)) {
+            printf("Error: unable to allocate memory to reuse distance area\n");
+            return CACHE_SIM_ERROR;
+        }
+        reuse->total_times = total_times;
+    }
+
+    /* rebuild the tree in linear time */
+    for (t = 1; t <= total_times; t++) {
+        reuse->tree[t] = (t <= time) ? 1 : 0;
+        if (t > time) {
+            reuse->owner[t] = REUSE_NONE;
+        }
+    }
+    for (t = 1; t <= total_times; t++) {
+        next = t + (t & (~t + 1));
+        if (next <= total_times) {
+            reuse->tree[next] += reuse->tree[t];
+        }
+    }
+
+    reuse->now = time;
+    reuse->oldest = 1;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* reuse_new_line */
+static uint32_t reuse_new_line(reuse_data_t *reuse) {
+    /* variables declaration */
+    reuse_line_t **slab = NULL;
+
+    /* allocate one more slab when the last one is full */
+    if ((reuse->total_lines >> REUSE_SLAB_SHIFT) == reuse->total_slabs) {
+        slab = (reuse_line_t **)realloc(reuse->slab,
+            (reuse->total_slabs + 1) * sizeof(reuse_line_t *));
+        if (NULL == slab) {
+            return REUSE_NONE;
+        }
+        reuse->slab = slab;
+
+        slab[reuse->total_slabs] = (reuse_line_t *)malloc(REUSE_SLAB_LINES *
+            sizeof(reuse_line_t));
+        if (NULL == slab[reuse->total_slabs]) {
+            return REUSE_NONE;
+        }
+        reuse->total_slabs++;
+    }
+
+    return reuse->total_lines++;
+}
+
+/* reuse_evict */
+static uint32_t reuse_evict(reuse_data_t *reuse) {
+    /* variables declaration */
+    reuse_line_t *line = NULL;
+    uint32_t *next = NULL;
+    uint32_t i = REUSE_NONE;
+
+    /* the oldest live timestamp belongs to the least recently used line */
+    while (REUSE_NONE == reuse->owner[reuse->oldest]) {
+        reuse->oldest++;
+    }
+    i = reuse->owner[reuse->oldest];
+    line = reuse_line(reuse, i);
+
+    tree_add(reuse, reuse->oldest, -1);
+    reuse->owner[reuse->oldest] = REUSE_NONE;
+
+    /* remove the line from its hash bucket */
+    next = &(reuse->bucket[reuse_hash(reuse, line->line_id)]);
+    while (i != *next) {
+        next = &(reuse_line(reuse, *next)->next);
+    }
+    *next = line->next;
+
+    return i;
+}
+
+/* reuse_access */
+static inline int reuse_access(reuse_data_t *reuse, const uint64_t limit,
+    const uint64_t line_id, uint64_t *age) {
+    /* variables declaration */
+    reuse_line_t *line = NULL;
+    uint64_t hash = 0;
+    uint32_t i = REUSE_NONE;
+
+    /* make room for one more timestamp */
+    if (reuse->now == reuse->total_times) {
+        if (CACHE_SIM_SUCCESS != reuse_compact(reuse)) {
+            return CACHE_SIM_ERROR;
+        }
+    }
+
+    i = reuse_find(reuse, line_id);
+
+    /* if we find the line forget its previous timestamp... */
+    if (REUSE_NONE != i) {
+        line = reuse_line(reuse, i);
+
+        if (NULL != age) {
+            *age = reuse->live - tree_sum(reuse, line->time);
+        }
+
+        #ifdef DEBUG
+        printf("REUSE  line id [%018p] reuse distance [%"PRIu64"]\n",
+            line->line_id, reuse->live - tree_sum(reuse, line->time));
+        #endif
+
+        tree_add(reuse, line->time, -1);
+        reuse->owner[line->time] = REUSE_NONE;
+    }
+    /* ...otherwise recycle the oldest line or add a new one */
+    else {
+        if (NULL != age) {
+            *age = UINT64_MAX;
+        }
+
+        if ((0 != limit) && (limit == reuse->live)) {
+            i = reuse_evict(reuse);
+        } else {
+            i = reuse_new_line(reuse);
+            if (REUSE_NONE == i) {
+                printf("Error: unable to allocate memory to reuse distance "
+                    "area\n");
+                return CACHE_SIM_ERROR;
+            }
+            reuse->live++;
+        }
+
+        line = reuse_line(reuse, i);
+        line->line_id = line_id;
+        hash = reuse_hash(reuse, line_id);
+        line->next = reuse->bucket[hash];
+        reuse->bucket[hash] = i;
+
+        /* keep at most one line per bucket on average */
+        if (reuse->total_lines > (reuse->bucket_mask + 1)) {
+            if (CACHE_SIM_SUCCESS !=
+                reuse_rehash(reuse, (reuse->bucket_mask + 1) * 2)) {
+                return CACHE_SIM_ERROR;
+            }
+        }
+
+        #ifdef DEBUG
+        printf("USE    line id [%018p]\n", line->line_id);
+        #endif
+    }
+
+    /* the line is now the most recently used one */
+    reuse->now++;
+    reuse->owner[reuse->now] = i;
+    line->time = reuse->now;
+    tree_add(reuse, reuse->now, 1);
+
+    return CACHE_SIM_SUCCESS;
+}
+
 /* cache_sim_reuse_enable */
 int cache_sim_reuse_enable(cache_handle_t *cache, const uint64_t limit) {
     /* sanity check: does cache exist? */
@@ -54,76 +306,44 @@ int cache_sim_reuse_enable(cache_handle_t *cache, const uint64_t limit) {
         }
     }
 
-    /* sanity check: limit higher than zero */
-    if (0 >= limit) {
-        printf("Error: limit is smaller than 1\n");
+    /* sanity check: lines are indexed with 32 bits */
+    if (REUSE_NONE <= limit) {
+        printf("Error: limit is too large\n");
         return CACHE_SIM_ERROR;
     }
 
-    /* variables declaration */
-    list_item_reuse_t *item = NULL;
-    list_t *list = NULL;
-    int i = 0;
+    /* create the tables */
+    if (NULL == (cache->reuse_data = cache_sim_reuse_create(limit))) {
+        return CACHE_SIM_ERROR;
+    }
 
     /* set reuse limit */
     cache->reuse_limit = limit;
 
-    /* allocate memory for reuse data area acording to reuse limit */
-    if (0 == cache->reuse_limit) {
-        /* for unlimited reuse distance */
-        cache->reuse_data = malloc(sizeof(list_t));
-        if (NULL == cache->reuse_data) {
-            printf("unable to allocate memory to calculate reuse distance\n");
-            return CACHE_SIM_ERROR;
-        }
+    /* set the reuse distance function */
+    cache->reuse_fn = (0 == cache->reuse_limit) ?
+        &cache_sim_reuse_unlimited : &cache_sim_reuse_limited;
 
-        /* initialize the list */
-        list = cache->reuse_data;
-        list->head.next = &(list->head);
-        list->head.prev = &(list->head);
-        list->len = 0;
-
-        /* set the reuse distance function */
-        cache->reuse_fn = &cache_sim_reuse_unlimited;
+    if (!cache_sim_verbose) {
+        return CACHE_SIM_SUCCESS;
+    }
 
+    if (0 == cache->reuse_limit) {
         printf("--------------------------------\n");
         printf("      Reuse distance is ON      \n");
         printf("Reuse limit:           unlimited\n");
-        printf("Memory required: %d bytes +%d/l\n", sizeof(list_t),
-            sizeof(list_item_t));
+        printf("Memory required: %d bytes +%d/l\n", sizeof(reuse_data_t) +
+            (REUSE_SLAB_LINES * 3 * sizeof(uint32_t)),
+            sizeof(reuse_line_t) + (3 * sizeof(uint32_t)));
         printf("--------------------------------\n");
     } else {
-        /* for a particular reuse distance limit */
-        cache->reuse_data = malloc(sizeof(list_t) +
-            (cache->reuse_limit * sizeof(list_item_reuse_t)));
-        if (NULL == cache->reuse_data) {
-            printf("Error: unable to allocate memory to reuse distance area\n");
-            return CACHE_SIM_ERROR;
-        }
-
-        /* initialize the list */
-        list = cache->reuse_data;
-        list->head.next = &(list->head);
-        list->head.prev = &(list->head);
-        list->len = 0;
-
-        /* set the reuse distance function */
-        cache->reuse_fn = &cache_sim_reuse_limited;
-
-        /* initialize list elements */
-        item = (list_item_reuse_t *)((uint64_t)cache->reuse_data + sizeof(list_t));
-        for (i = 0; i < cache->reuse_limit; i++) {
-            list_prepend_item((list_t *)(cache->reuse_data), (list_item_t *)item);
-            item->line_id = UINT64_MAX;
-            item->age = UINT16_MAX;
-            item++;
-        }
-
         printf("--------------------------------\n");
         printf("      Reuse distance is ON      \n");
         printf("Reuse limit:     %15"PRIu64"\n", cache->reuse_limit);
-        printf("Memory required: %9d bytes\n", sizeof(list_t) +
-            (cache->reuse_limit * sizeof(list_item_reuse_t)));
+        printf("Memory required: %9d bytes\n", sizeof(reuse_data_t) +
+            ((((reuse_data_t *)cache->reuse_data)->bucket_mask + 1) * 3 *
+                sizeof(uint32_t)) +
+            (cache->reuse_limit * sizeof(reuse_line_t)));
         printf("--------------------------------\n");
     }
 
@@ -144,112 +364,99 @@ int cache_sim_reuse_disable(cache_handle_t *cache) {
         return CACHE_SIM_ERROR;
     }
 
-    /* variables declaration */
-    // list_item_t *item;
-
-    printf("--------------------------------\n");
-    // for (item = (list_item_t *)((list_t *)cache->reuse_data)->head.next;
-    //     item != &(((list_t *)cache->reuse_data)->head);
-    //     item = (list_item_t *)item->next) {
-    //     printf("Line: %018p, Distance: %"PRIu64"\n", item->line_id, item->age);
-    // }
-    printf(" (print something nice here...) \n");
-    printf("      Reuse distance is OFF     \n");
-    printf("--------------------------------\n");
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf(" (print something nice here...) \n");
+        printf("      Reuse distance is OFF     \n");
+        printf("--------------------------------\n");
+    }
 
-    // TODO: free the list elements when reuse distance is unlimited
-    free(cache->reuse_data);
+    cache_sim_reuse_destroy((reuse_data_t *)cache->reuse_data);
+    cache->reuse_data = NULL;
 
     return CACHE_SIM_SUCCESS;
 }
 
-/* cache_sim_reuse_limited */
-int cache_sim_reuse_limited(cache_handle_t *cache, const uint64_t line_id) {
-    /* variable declarations */
-    static list_item_reuse_t *item = NULL;
-
-    /* for all elements in the list of lines... */
-    for (item = (list_item_reuse_t *)((list_t *)cache->reuse_data)->head.next;
-        (void *)item != (void *)&(((list_t *)cache->reuse_data)->head);
-        item = (list_item_reuse_t *)item->next) {
-        /* ...if we find the line... */
-        if (line_id == item->line_id) {
-            /* ...report it... */
-            #ifdef DEBUG
-            printf("REUSE  line id [%018p] reuse distance [%"PRIu64"]\n",
-                item->line_id, item->age);
-            #endif
-
-            /* ...move the line to the top of the list... */
-            list_movetop_item((list_t *)cache->reuse_data, (list_item_t *)item);
-
-            /* ...set the line's age to zero */
-            item->age = 0;
-
-            return CACHE_SIM_SUCCESS;
-        }
+/* cache_sim_reuse_create */
+reuse_data_t* cache_sim_reuse_create(const uint64_t limit) {
+    /* variables declaration */
+    reuse_data_t *reuse = NULL;
+    uint64_t total_buckets = REUSE_SLAB_LINES;
+    uint64_t t = 0;
 
-        /* increment age for every line above the line we are looking for */
-        item->age++;
+    /* size the tables after the limit, or let them grow when unlimited */
+    while (total_buckets < limit) {
+        total_buckets *= 2;
     }
 
-    /* if the line was not found take the last one and move it up to the top */
-    item = (list_item_reuse_t *)((list_t *)cache->reuse_data)->head.prev;
-    list_movetop_item((list_t *)cache->reuse_data, (list_item_t *)item);
-    item->line_id = line_id;
-    item->age = 0;
+    /* allocate memory for reuse data area acording to reuse limit */
+    reuse = (reuse_data_t *)malloc(sizeof(reuse_data_t));
+    if (NULL == reuse) {
+        printf("Error: unable to allocate memory to reuse distance area\n");
+        return NULL;
+    }
 
-    #ifdef DEBUG
-    printf("USE    line id [%018p]\n", item->line_id);
-    #endif
+    reuse->slab        = NULL;
+    reuse->total_slabs = 0;
+    reuse->total_lines = 0;
+    reuse->bucket      = NULL;
+    reuse->bucket_mask = 0;
+    reuse->total_times = total_buckets * 2;
+    reuse->now         = 0;
+    reuse->oldest      = 1;
+    reuse->live        = 0;
+    reuse->tree  = (uint32_t *)malloc((reuse->total_times + 1) *
+        sizeof(uint32_t));
+    reuse->owner = (uint32_t *)malloc((reuse->total_times + 1) *
+        sizeof(uint32_t));
+    if ((NULL == reuse->tree) || (NULL == reuse->owner) ||
+        (CACHE_SIM_SUCCESS != reuse_rehash(reuse, total_buckets))) {
+        printf("Error: unable to allocate memory to reuse distance area\n");
+        cache_sim_reuse_destroy(reuse);
+        return NULL;
+    }
 
-    return CACHE_SIM_SUCCESS;
+    /* initialize the tree */
+    for (t = 0; t <= reuse->total_times; t++) {
+        reuse->tree[t]  = 0;
+        reuse->owner[t] = REUSE_NONE;
+    }
+
+    return reuse;
 }
 
-/* cache_sim_reuse_unlimited */
-int cache_sim_reuse_unlimited(cache_handle_t *cache, const uint64_t line_id) {
-    /* variables declaration */
-    static list_item_reuse_t *item = NULL;
-
-    /* for all elements in the list of lines... */
-    for (item = (list_item_reuse_t *)((list_t *)cache->reuse_data)->head.next;
-        (void *)item != (void *)&(((list_t *)cache->reuse_data)->head);
-        item = (list_item_reuse_t *)item->next) {
-        /* ...if we find the line... */
-        if (line_id == item->line_id) {
-            /* ...report it... */
-            #ifdef DEBUG
-            printf("REUSE  line id [%018p] reuse distance [%"PRIu64"]\n",
-                item->line_id, item->age);
-            #endif
-
-            /* ...move the line to the top of the list... */
-            list_movetop_item((list_t *)cache->reuse_data, (list_item_t *)item);
-
-            /* ...set the line's age to zero */
-            item->age = 0;
-
-            return CACHE_SIM_SUCCESS;
-        }
+/* cache_sim_reuse_destroy */
+void cache_sim_reuse_destroy(reuse_data_t *reuse) {
+    uint32_t i = 0;
 
-        /* increment age for every line above the line we are looking for */
-        item->age++;
+    for (i = 0; i < reuse->total_slabs; i++) {
+        free(reuse->slab[i]);
     }
+    free(reuse->slab);
+    free(reuse->bucket);
+    free(reuse->tree);
+    free(reuse->owner);
+    free(reuse);
+}
 
-    /* if the line was not found, add it to the list */
-    item = malloc(sizeof(list_item_reuse_t));
-    if (NULL == item) {
-        return CACHE_SIM_ERROR;
-    }
-    list_prepend_item((list_t *)cache->reuse_data, (list_item_t *)item);
-    item->line_id = line_id;
-    item->age = 0;
+/* cache_sim_reuse_update */
+int cache_sim_reuse_update(reuse_data_t *reuse, const uint64_t limit,
+    const uint64_t line_id, uint64_t *age) {
+    /* the age of the line before this access, UINT64_MAX if it is new */
+    return reuse_access(reuse, limit, line_id, age);
+}
 
-    #ifdef DEBUG
-    printf("USE    line id [%018p]\n", item->line_id);
-    #endif
+/* cache_sim_reuse_limited */
+int cache_sim_reuse_limited(cache_handle_t *cache, const uint64_t line_id) {
+    /* lines beyond the limit are forgotten, the oldest first */
+    return reuse_access((reuse_data_t *)cache->reuse_data, cache->reuse_limit,
+        line_id, NULL);
+}
 
-    return CACHE_SIM_SUCCESS;
+/* cache_sim_reuse_unlimited */
+int cache_sim_reuse_unlimited(cache_handle_t *cache, const uint64_t line_id) {
+    /* every line is remembered, tables grow as needed */
+    return reuse_access((reuse_data_t *)cache->reuse_data, 0, line_id, NULL);
 }
 
 /* cache_sim_reuse_get_age */
@@ -261,17 +468,12 @@ uint64_t cache_sim_reuse_get_age(cache_handle_t *cache, const uint64_t line_id)
     }
 
     /* variable declarations */
-    static list_item_reuse_t *item = NULL;
-
-    /* for all elements in the list of lines... */
-    for (item = (list_item_reuse_t *)((list_t *)cache->reuse_data)->head.next;
-        (void *)item != (void *)&(((list_t *)cache->reuse_data)->head);
-        item = (list_item_reuse_t *)item->next) {
-        /* ...if we find the line... */
-        if (line_id == item->line_id) {
-            /* ...report its age... */
-            return item->age;
-        }
+    reuse_data_t *reuse = (reuse_data_t *)cache->reuse_data;
+    uint32_t i = reuse_find(reuse, line_id);
+
+    /* the age is the number of lines accessed after this one */
+    if (REUSE_NONE != i) {
+        return reuse->live - tree_sum(reuse, reuse_line(reuse, i)->time);
     }
 
     return UINT64_MAX;
@@ -34,6 +34,15 @@ extern "C" {
 #include <stdint.h>
 #endif
 
+#ifndef CACHE_SIM_TYPES_H_
+#include "cache_sim_types.h"
+#endif
+
+/* Lines per slab and the index that marks the absence of a line */
+#define REUSE_SLAB_SHIFT 12
+#define REUSE_SLAB_LINES (1 << REUSE_SLAB_SHIFT)
+#define REUSE_NONE       UINT32_MAX
+
 /* Functions declaration */
 int cache_sim_reuse_enable(cache_handle_t *cache, const uint64_t limit);
 int cache_sim_reuse_disable(cache_handle_t *cache);
@@ -41,6 +50,12 @@ int cache_sim_reuse_limited(cache_handle_t *cache, const uint64_t lineid);
 int cache_sim_reuse_unlimited(cache_handle_t *cache, const uint64_t lineid);
 uint64_t cache_sim_reuse_get_age(cache_handle_t *cache, const uint64_t lineid);
 
+/* Functions declaration: reuse distance tables not bound to a cache */
+reuse_data_t* cache_sim_reuse_create(const uint64_t limit);
+void cache_sim_reuse_destroy(reuse_data_t *reuse);
+int cache_sim_reuse_update(reuse_data_t *reuse, const uint64_t limit,
+    const uint64_t line_id, uint64_t *age);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,246 @@
 #include "cache_sim_util.h"
 #include "cache_sim_symbol.h"
 
+/* # of symbols evicting lines of each symbol shown when tracking ends */
+#define SYMBOL_REPORT_EVICTORS 5
+
+/* symbol_name_hash */
+static inline uint64_t symbol_name_hash(const char *symbol) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    int i = 0;
+
+    /* FNV-1a over the part of the name which is kept */
+    for (i = 0; (i < (CACHE_SIM_SYMBOL_MAX_LENGTH - 1)) && ('\0' != symbol[i]);
+        i++) {
+        hash = (hash ^ (uint8_t)symbol[i]) * 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+/* symbol_pair_hash */
+static inline uint64_t symbol_pair_hash(symbol_data_t *data,
+    const uint32_t evictor, const uint32_t victim) {
+    return (((((uint64_t)evictor << 32) | victim) * 0x9E3779B97F4A7C15ULL) >>
+        32) & data->pairs_mask;
+}
+
+/* symbol_rehash_names */
+static int symbol_rehash_names(symbol_data_t *data,
+    const uint64_t total_names) {
+    /* variables declaration */
+    uint64_t hash = 0;
+    uint32_t i = 0;
+
+    free(data->names);
+    data->names = (uint32_t *)malloc(total_names * sizeof(uint32_t));
+    if (NULL == data->names) {
+        printf("Error: unable to allocate memory to track symbols\n");
+        return CACHE_SIM_ERROR;
+    }
+    data->names_mask = total_names - 1;
+
+    for (hash = 0; hash < total_names; hash++) {
+        data->names[hash] = SYMBOL_NONE;
+    }
+
+    for (i = 0; i < data->total_symbols; i++) {
+        hash = symbol_name_hash(data->symbols[i].symbol) & data->names_mask;
+        while (SYMBOL_NONE != data->names[hash]) {
+            hash = (hash + 1) & data->names_mask;
+        }
+        data->names[hash] = i;
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* symbol_rehash_pairs */
+static int symbol_rehash_pairs(symbol_data_t *data,
+    const uint64_t total_pairs) {
+    /* variables declaration */
+    symbol_pair_t *pairs = data->pairs;
+    uint64_t old_pairs = (NULL == pairs) ? 0 : (data->pairs_mask + 1);
+    uint64_t hash = 0, i = 0;
+
+    data->pairs = (symbol_pair_t *)malloc(total_pairs * sizeof(symbol_pair_t));
+    if (NULL == data->pairs) {
+        printf("Error: unable to allocate memory to track symbols\n");
+        data->pairs = pairs;
+        return CACHE_SIM_ERROR;
+    }
+    data->pairs_mask = total_pairs - 1;
+
+    for (i = 0; i < total_pairs; i++) {
+        data->pairs[i].evictor = SYMBOL_NONE;
+    }
+
+    for (i = 0; i < old_pairs; i++) {
+        if (SYMBOL_NONE == pairs[i].evictor) {
+            continue;
+        }
+        hash = symbol_pair_hash(data, pairs[i].evictor, pairs[i].victim);
+        while (SYMBOL_NONE != data->pairs[hash].evictor) {
+            hash = (hash + 1) & data->pairs_mask;
+        }
+        data->pairs[hash] = pairs[i];
+    }
+    free(pairs);
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* symbol_find */
+static uint32_t symbol_find(symbol_data_t *data, const char *symbol) {
+    /* variables declaration */
+    symbol_t *item = NULL;
+    uint64_t hash = symbol_name_hash(symbol) & data->names_mask;
+    uint32_t i = SYMBOL_NONE;
+
+    while (SYMBOL_NONE != (i = data->names[hash])) {
+        if (0 == strncmp(symbol, data->symbols[i].symbol,
+            CACHE_SIM_SYMBOL_MAX_LENGTH - 1)) {
+            return i;
+        }
+        hash = (hash + 1) & data->names_mask;
+    }
+
+    /* if symbol was not found allocate memory and add it to the table */
+    if (data->total_symbols == data->max_symbols) {
+        item = (symbol_t *)realloc(data->symbols, 2 * data->max_symbols *
+            sizeof(symbol_t));
+        if (NULL == item) {
+            printf("unable to allocate memory for symbol\n");
+            return SYMBOL_NONE;
+        }
+        data->symbols = item;
+        data->max_symbols *= 2;
+    }
+
+    /* initialize item */
+    i = data->total_symbols;
+    item = &(data->symbols[i]);
+    bzero(item->symbol, CACHE_SIM_SYMBOL_MAX_LENGTH);
+    item->access   = 0;
+    item->hit      = 0;
+    item->miss     = 0;
+    item->conflict = 0;
+    item->prefetcher_hit   = 0;
+    item->prefetcher_evict = 0;
+    item->evicted  = 0;
+
+    /* copy the symbol name */
+    strncpy(item->symbol, symbol, (CACHE_SIM_SYMBOL_MAX_LENGTH - 1));
+
+    /* add the symbol to the table */
+    data->names[hash] = i;
+    data->total_symbols++;
+
+    /* keep the table at most half full */
+    if ((2 * data->total_symbols) > (data->names_mask + 1)) {
+        if (CACHE_SIM_SUCCESS !=
+            symbol_rehash_names(data, (data->names_mask + 1) * 2)) {
+            return SYMBOL_NONE;
+        }
+    }
+
+    #ifdef DEBUG
+    printf("SYMBOL found [%s]\n", item->symbol);
+    #endif
+
+    return i;
+}
+
+/* symbol_range */
+static inline uint32_t symbol_range(symbol_data_t *data,
+    const uint64_t address) {
+    /* variables declaration */
+    uint32_t low = 0, high = data->total_ranges, middle = 0;
+
+    /* the range with the largest start not above the address */
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (data->ranges[middle].start <= address) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/* symbol_lookup */
+static inline uint32_t symbol_lookup(symbol_data_t *data,
+    const uint64_t address) {
+    /* variables declaration */
+    symbol_range_t *range = NULL;
+    uint32_t i = 0;
+
+    /* accesses usually stay in the same range for a while */
+    if (data->last < data->total_ranges) {
+        range = &(data->ranges[data->last]);
+        if ((range->start <= address) && (address < range->end)) {
+            return range->symbol;
+        }
+    }
+
+    i = symbol_range(data, address);
+    if ((0 < i) && (address < data->ranges[i - 1].end)) {
+        data->last = i - 1;
+        return data->ranges[i - 1].symbol;
+    }
+
+    return SYMBOL_UNKNOWN;
+}
+
+/* symbol_pair */
+static symbol_pair_t* symbol_pair(symbol_data_t *data, const uint32_t evictor,
+    const uint32_t victim) {
+    /* variables declaration */
+    uint64_t hash = 0;
+
+    /* keep the table at most half full */
+    if ((2 * (data->total_pairs + 1)) > (data->pairs_mask + 1)) {
+        if (CACHE_SIM_SUCCESS !=
+            symbol_rehash_pairs(data, (data->pairs_mask + 1) * 2)) {
+            return NULL;
+        }
+    }
+
+    hash = symbol_pair_hash(data, evictor, victim);
+    while (SYMBOL_NONE != data->pairs[hash].evictor) {
+        if ((evictor == data->pairs[hash].evictor) &&
+            (victim == data->pairs[hash].victim)) {
+            return &(data->pairs[hash]);
+        }
+        hash = (hash + 1) & data->pairs_mask;
+    }
+
+    data->pairs[hash].evictor   = evictor;
+    data->pairs[hash].victim    = victim;
+    data->pairs[hash].evictions = 0;
+    data->pairs[hash].conflicts = 0;
+    data->total_pairs++;
+
+    return &(data->pairs[hash]);
+}
+
+/* symbol_compare_pairs */
+static int symbol_compare_pairs(const void *a, const void *b) {
+    const symbol_pair_t *x = (const symbol_pair_t *)a;
+    const symbol_pair_t *y = (const symbol_pair_t *)b;
+
+    /* by victim, then the larger number of evictions first */
+    if (x->victim != y->victim) {
+        return (x->victim < y->victim) ? -1 : 1;
+    }
+    if (x->evictions != y->evictions) {
+        return (x->evictions > y->evictions) ? -1 : 1;
+    }
+    return 0;
+}
+
 /* cache_sim_symbol_enable */
 int cache_sim_symbol_enable(cache_handle_t *cache) {
     /* sanity check: does cache exist? */
@@ -46,52 +286,96 @@ int cache_sim_symbol_enable(cache_handle_t *cache) {
     }
 
     /* variables declaration */
-    list_t *list = NULL;
+    symbol_data_t *data = NULL;
+    uint32_t i = 0;
 
     /* allocate memory for symbol tracking data area */
-    cache->symbol_data = malloc(sizeof(list_t));
-    if (NULL == cache->symbol_data) {
+    data = (symbol_data_t *)malloc(sizeof(symbol_data_t));
+    if (NULL == data) {
         printf("unable to allocate memory to track symbols\n");
         return CACHE_SIM_ERROR;
     }
+    cache->symbol_data = data;
 
-    /* initialize the list */
-    list = cache->symbol_data;
-    list->head.next = &(list->head);
-    list->head.prev = &(list->head);
-    list->len = 0;
+    data->total_symbols = 0;
+    data->max_symbols   = SYMBOL_INITIAL;
+    data->names         = NULL;
+    data->total_ranges  = 0;
+    data->max_ranges    = SYMBOL_INITIAL;
+    data->last          = 0;
+    data->pairs         = NULL;
+    data->total_pairs   = 0;
+    data->symbols = (symbol_t *)malloc(SYMBOL_INITIAL * sizeof(symbol_t));
+    data->ranges = (symbol_range_t *)malloc(SYMBOL_INITIAL *
+        sizeof(symbol_range_t));
+    data->evicted = (symbol_evicted_t *)malloc(SYMBOL_EVICTED_LINES *
+        sizeof(symbol_evicted_t));
+    if ((NULL == data->symbols) || (NULL == data->ranges) ||
+        (NULL == data->evicted) ||
+        (CACHE_SIM_SUCCESS != symbol_rehash_names(data, 2 * SYMBOL_INITIAL)) ||
+        (CACHE_SIM_SUCCESS != symbol_rehash_pairs(data, 4 * SYMBOL_INITIAL))) {
+        printf("unable to allocate memory to track symbols\n");
+        free(data->symbols);
+        free(data->ranges);
+        free(data->evicted);
+        free(data->names);
+        free(data->pairs);
+        free(data);
+        cache->symbol_data = NULL;
+        return CACHE_SIM_ERROR;
+    }
 
-    printf("--------------------------------\n");
-    printf("     Symbols tracking is ON     \n");
-    printf("Memory required: %d bytes +%d/s\n", sizeof(list_t),
-        sizeof(list_item_symbol_t));
-    printf("--------------------------------\n");
+    for (i = 0; i < SYMBOL_EVICTED_LINES; i++) {
+        data->evicted[i].line_id = UINT64_MAX;
+        data->evicted[i].evictor = SYMBOL_NONE;
+    }
 
-    return CACHE_SIM_SUCCESS;
-}
+    /* accesses out of any range are attributed to the first symbol */
+    symbol_find(data, "(unknown)");
 
-/* cache_sim_symbol_disable */
-int cache_sim_symbol_disable(cache_handle_t *cache) {
-    /* sanity check: does cache exist? */
-    if (NULL == cache) {
-        printf("Error: cache does not exists\n");
-        return CACHE_SIM_ERROR;
+    if (cache_sim_verbose) {
+        printf("--------------------------------\n");
+        printf("     Symbols tracking is ON     \n");
+        printf("Memory required: %d bytes +%d/s\n", sizeof(symbol_data_t) +
+            (SYMBOL_EVICTED_LINES * sizeof(symbol_evicted_t)),
+            sizeof(symbol_t) + sizeof(symbol_range_t));
+        printf("--------------------------------\n");
     }
 
-    /* sanity check: already disabled */
-    if (NULL == cache->symbol_data) {
-        printf("Error: symbols tracking is not enabled\n");
-        return CACHE_SIM_ERROR;
-    }
+    return CACHE_SIM_SUCCESS;
+}
 
+/* symbol_report */
+static void symbol_report(cache_handle_t *cache) {
     /* variables declaration */
-    list_item_symbol_t *item = NULL;
+    symbol_data_t *data = cache->symbol_data;
+    symbol_pair_t *pairs = NULL, *pair = NULL;
+    symbol_t *item = NULL;
+    uint64_t total = 0, i = 0;
+    uint32_t s = 0;
+    int shown = 0;
+
+    /* pairs sorted by victim, so evictors of each symbol are found in turn */
+    pairs = (symbol_pair_t *)malloc((data->total_pairs + 1) *
+        sizeof(symbol_pair_t));
+    if (NULL != pairs) {
+        for (i = 0; i <= data->pairs_mask; i++) {
+            if (SYMBOL_NONE != data->pairs[i].evictor) {
+                pairs[total++] = data->pairs[i];
+            }
+        }
+        qsort(pairs, total, sizeof(symbol_pair_t), symbol_compare_pairs);
+    }
+    pair = pairs;
 
     printf("--------------------------------\n");
-    for (item = (list_item_symbol_t *)((list_t *)cache->symbol_data)->head.next;
-        (void *)item != (void *)&(((list_t *)cache->symbol_data)->head);
-        item = (list_item_symbol_t *)item->next) {
-        printf("Symbol: %24s\n", item->symbol ? item->symbol : "(null)");
+    for (s = 0; s < data->total_symbols; s++) {
+        item = &(data->symbols[s]);
+        if ((SYMBOL_UNKNOWN == s) && (0 == item->access) &&
+            (0 == item->evicted)) {
+            continue;
+        }
+        printf("Symbol: %24s\n", item->symbol);
         printf("Cache accesses: %16"PRIu64"\n", item->access);
         printf("Cache hits:     %16"PRIu64"\n", item->hit);
         printf(" -> symbol hit rate  %10.2f%%\n",
@@ -108,74 +392,72 @@ int cache_sim_symbol_disable(cache_handle_t *cache) {
             (((double)item->conflict / (double)item->miss) * 100));
         printf(" -> global conflict rate %6.2f%%\n",
             (((double)item->conflict / (double)cache->conflict) * 100));
+        printf("Lines evicted:  %16"PRIu64"\n", item->evicted);
+
+        /* the symbols evicting the most lines of this one */
+        for (shown = 0; (NULL != pair) && (pair < (pairs + total)) &&
+            (s == pair->victim); pair++, shown++) {
+            if (SYMBOL_REPORT_EVICTORS > shown) {
+                printf(" -> by %-16.16s %9"PRIu64"\n",
+                    data->symbols[pair->evictor].symbol, pair->evictions);
+            }
+        }
         printf("--------------------------------\n");
     }
     printf("     Symbols tracking is OFF    \n");
     printf("--------------------------------\n");
 
-    // TODO: free the list elements
-    free(cache->symbol_data);
-
-    return CACHE_SIM_SUCCESS;
+    free(pairs);
 }
 
-/* cache_sim_symbol_access */
-int cache_sim_symbol_access(cache_handle_t *cache, const uint64_t address,
-    const char *symbol) {
-    /* sanity check: is symbols tracking enabled? */
-    if (NULL == cache->symbol_data) {
-        if (CACHE_SIM_SUCCESS != cache_sim_symbol_enable(cache)) {
-            printf("Error: unable to enable symbols tracking\n");
-            return CACHE_SIM_ERROR;
-        }
+/* cache_sim_symbol_disable */
+int cache_sim_symbol_disable(cache_handle_t *cache) {
+    /* sanity check: does cache exist? */
+    if (NULL == cache) {
+        printf("Error: cache does not exists\n");
+        return CACHE_SIM_ERROR;
     }
 
-    /* variable declarations */
-    static int rc = CACHE_SIM_ERROR;
-    list_item_symbol_t *item = NULL;
-
-    /* for all elements in the list of symbols... */
-    for (item = (list_item_symbol_t *)((list_t *)cache->symbol_data)->head.next;
-        (void *)item != (void *)&(((list_t *)cache->symbol_data)->head);
-        item = (list_item_symbol_t *)item->next) {
-        /* ...if we find the symbol, stop */
-        if (0 == strcmp(symbol, item->symbol)) {
-            break;
-        }
+    /* sanity check: already disabled */
+    if (NULL == cache->symbol_data) {
+        printf("Error: symbols tracking is not enabled\n");
+        return CACHE_SIM_ERROR;
     }
 
-    /* if symbol was not found allocate memory and add it to the list */
-    if (&(((list_t *)(cache->symbol_data))->head) == (list_item_t *)item) {
-        /* allocate memory for symbol item */
-        item = malloc(sizeof(list_item_symbol_t));
-        if (NULL == item) {
-            printf("unable to allocate memory for symbol\n");
-            return CACHE_SIM_ERROR;
-        }
+    /* variables declaration */
+    symbol_data_t *data = cache->symbol_data;
 
-        /* initialize item */
-        bzero(item->symbol, CACHE_SIM_SYMBOL_MAX_LENGTH);
-        item->access   = 0;
-        item->hit      = 0;
-        item->miss     = 0;
-        item->conflict = 0;
+    if (cache_sim_verbose) {
+        symbol_report(cache);
+    }
 
-        /* copy the symbol name */
-        if (CACHE_SIM_SYMBOL_MAX_LENGTH > (strlen(symbol) + 1)) {
-            strcpy(item->symbol, symbol);
-        } else {
-            strncpy(item->symbol, symbol, (CACHE_SIM_SYMBOL_MAX_LENGTH - 1));
-        }
+    free(data->symbols);
+    free(data->names);
+    free(data->ranges);
+    free(data->pairs);
+    free(data->evicted);
+    free(data);
+    cache->symbol_data = NULL;
 
-        /* add the symbol to the list */
-        list_prepend_item((list_t *)cache->symbol_data, (list_item_t *)item);
+    return CACHE_SIM_SUCCESS;
+}
 
-        #ifdef DEBUG
-        printf("SYMBOL found [%s]\n", item->symbol);
-        #endif
-    }
+/* symbol_attribute */
+static int symbol_attribute(cache_handle_t *cache, const uint64_t address,
+    const uint32_t symbol) {
+    /* variable declarations */
+    symbol_data_t *data = cache->symbol_data;
+    symbol_evicted_t *evicted = NULL;
+    symbol_pair_t *pair = NULL;
+    symbol_t *item = NULL;
+    uint64_t line_id = address;
+    uint32_t victim = SYMBOL_NONE;
+    int rc = CACHE_SIM_ERROR;
+
+    CACHE_SIM_ADDRESS_TO_LINE_ID(line_id);
 
     /* call the real access function and increment hit/miss counter */
+    item = &(data->symbols[symbol]);
     switch (rc = cache_sim_access(cache, address)) {
         /* hit on a prefetched line */
         case CACHE_SIM_L1_HIT + CACHE_SIM_L1_HIT_PREFETCH: // fallover
@@ -212,7 +494,233 @@ int cache_sim_symbol_access(cache_handle_t *cache, const uint64_t address,
     /* increment access counter */
     item->access++;
 
+    /* a conflict miss is blamed on the symbol which evicted the line */
+    if (CACHE_SIM_L1_MISS_CONFLICT & rc) {
+        evicted = &(data->evicted[(line_id >> cache->offset_length) &
+            (SYMBOL_EVICTED_LINES - 1)]);
+        if ((line_id == evicted->line_id) &&
+            (NULL != (pair = symbol_pair(data, evicted->evictor, symbol)))) {
+            pair->conflicts++;
+        }
+    }
+
+    /* the evicted line belongs to the symbol whose range holds it */
+    if (UINT64_MAX != cache->demand_victim) {
+        victim = symbol_lookup(data, cache->demand_victim);
+        data->symbols[victim].evicted++;
+
+        if (NULL != (pair = symbol_pair(data, symbol, victim))) {
+            pair->evictions++;
+        }
+
+        evicted = &(data->evicted[(cache->demand_victim >>
+            cache->offset_length) & (SYMBOL_EVICTED_LINES - 1)]);
+        evicted->line_id = cache->demand_victim;
+        evicted->evictor = symbol;
+    }
+
     return rc;
 }
 
+/* cache_sim_symbol_access */
+int cache_sim_symbol_access(cache_handle_t *cache, const uint64_t address,
+    const char *symbol) {
+    /* sanity check: is symbols tracking enabled? */
+    if (NULL == cache->symbol_data) {
+        if (CACHE_SIM_SUCCESS != cache_sim_symbol_enable(cache)) {
+            printf("Error: unable to enable symbols tracking\n");
+            return CACHE_SIM_ERROR;
+        }
+    }
+
+    /* variable declarations */
+    uint32_t i = symbol_find(cache->symbol_data, symbol);
+
+    if (SYMBOL_NONE == i) {
+        return CACHE_SIM_ERROR;
+    }
+
+    return symbol_attribute(cache, address, i);
+}
+
+/* cache_sim_symbol_insert */
+int cache_sim_symbol_insert(cache_handle_t *cache, const char *symbol,
+    const uint64_t address, const uint64_t size) {
+    /* sanity check: is symbols tracking enabled? */
+    if (NULL == cache->symbol_data) {
+        if (CACHE_SIM_SUCCESS != cache_sim_symbol_enable(cache)) {
+            printf("Error: unable to enable symbols tracking\n");
+            return CACHE_SIM_ERROR;
+        }
+    }
+
+    /* sanity check: empty ranges */
+    if ((0 == size) || ((address + size) < address)) {
+        printf("Error: invalid address range for symbol %s\n", symbol);
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variable declarations */
+    symbol_data_t *data = cache->symbol_data;
+    symbol_range_t *ranges = NULL;
+    uint32_t i = symbol_range(data, address);
+    uint32_t s = SYMBOL_NONE;
+
+    /* sanity check: ranges never overlap */
+    if (((0 < i) && (address < data->ranges[i - 1].end)) ||
+        ((i < data->total_ranges) &&
+            (data->ranges[i].start < (address + size)))) {
+        printf("Error: address range of symbol %s overlaps another one\n",
+            symbol);
+        return CACHE_SIM_ERROR;
+    }
+
+    if (SYMBOL_NONE == (s = symbol_find(data, symbol))) {
+        return CACHE_SIM_ERROR;
+    }
+
+    if (data->total_ranges == data->max_ranges) {
+        ranges = (symbol_range_t *)realloc(data->ranges, 2 * data->max_ranges *
+            sizeof(symbol_range_t));
+        if (NULL == ranges) {
+            printf("unable to allocate memory for symbol\n");
+            return CACHE_SIM_ERROR;
+        }
+        data->ranges = ranges;
+        data->max_ranges *= 2;
+    }
+
+    /* keep the ranges sorted */
+    memmove(&(data->ranges[i + 1]), &(data->ranges[i]),
+        (data->total_ranges - i) * sizeof(symbol_range_t));
+    data->ranges[i].start  = address;
+    data->ranges[i].end    = address + size;
+    data->ranges[i].symbol = s;
+    data->total_ranges++;
+    data->last = i;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_symbol_remove */
+int cache_sim_symbol_remove(cache_handle_t *cache, const uint64_t address) {
+    /* sanity check: is symbols tracking enabled? */
+    if ((NULL == cache) || (NULL == cache->symbol_data)) {
+        printf("Error: symbols tracking is not enabled\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variable declarations */
+    symbol_data_t *data = cache->symbol_data;
+    uint32_t i = symbol_range(data, address);
+
+    /* sanity check: is there a range starting at this address? */
+    if ((0 == i) || (address != data->ranges[i - 1].start)) {
+        printf("Error: no symbol starts at address %#"PRIx64"\n", address);
+        return CACHE_SIM_ERROR;
+    }
+
+    /* the symbol and its counters stay, only the range goes away */
+    memmove(&(data->ranges[i - 1]), &(data->ranges[i]),
+        (data->total_ranges - i) * sizeof(symbol_range_t));
+    data->total_ranges--;
+    data->last = 0;
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* cache_sim_symbol_attribute */
+int cache_sim_symbol_attribute(cache_handle_t *cache, const uint64_t address) {
+    /* sanity check: is symbols tracking enabled? */
+    if (NULL == cache->symbol_data) {
+        if (CACHE_SIM_SUCCESS != cache_sim_symbol_enable(cache)) {
+            printf("Error: unable to enable symbols tracking\n");
+            return CACHE_SIM_ERROR;
+        }
+    }
+
+    return symbol_attribute(cache, address,
+        symbol_lookup(cache->symbol_data, address));
+}
+
+/* cache_sim_symbol_lookup */
+uint32_t cache_sim_symbol_lookup(cache_handle_t *cache,
+    const uint64_t address) {
+    /* variable declarations */
+    symbol_data_t *data = cache->symbol_data;
+    uint32_t i = 0;
+
+    if (NULL == data) {
+        return SYMBOL_UNKNOWN;
+    }
+
+    /* does not touch the last hit, so threads may look symbols up */
+    i = symbol_range(data, address);
+    if ((0 < i) && (address < data->ranges[i - 1].end)) {
+        return data->ranges[i - 1].symbol;
+    }
+
+    return SYMBOL_UNKNOWN;
+}
+
+/* cache_sim_symbol_name */
+const char* cache_sim_symbol_name(cache_handle_t *cache,
+    const uint32_t symbol) {
+    if ((NULL == cache->symbol_data) ||
+        (symbol >= cache->symbol_data->total_symbols)) {
+        return NULL;
+    }
+
+    return cache->symbol_data->symbols[symbol].symbol;
+}
+
+/* cache_sim_symbol_write */
+int cache_sim_symbol_write(cache_handle_t *cache, const char *filename) {
+    /* sanity check: is symbols tracking enabled? */
+    if ((NULL == cache) || (NULL == cache->symbol_data)) {
+        printf("Error: symbols tracking is not enabled\n");
+        return CACHE_SIM_ERROR;
+    }
+
+    /* variable declarations */
+    symbol_data_t *data = cache->symbol_data;
+    symbol_pair_t *pair = NULL;
+    symbol_t *item = NULL;
+    FILE *file = stdout;
+    uint64_t i = 0;
+
+    if ((NULL != filename) && (NULL == (file = fopen(filename, "w")))) {
+        printf("Error: unable to open %s\n", filename);
+        return CACHE_SIM_ERROR;
+    }
+
+    /* per symbol counters, then the (sparse) matrix of evictions and the
+     * conflict misses they caused, as two CSV tables
+     */
+    fprintf(file, "symbol,access,hit,miss,conflict,evicted\n");
+    for (i = 0; i < data->total_symbols; i++) {
+        item = &(data->symbols[i]);
+        fprintf(file, "\"%s\",%"PRIu64",%"PRIu64",%"PRIu64",%"PRIu64","
+            "%"PRIu64"\n", item->symbol, item->access, item->hit, item->miss,
+            item->conflict, item->evicted);
+    }
+
+    fprintf(file, "\nevictor,victim,evictions,conflicts\n");
+    for (i = 0; i <= data->pairs_mask; i++) {
+        pair = &(data->pairs[i]);
+        if (SYMBOL_NONE != pair->evictor) {
+            fprintf(file, "\"%s\",\"%s\",%"PRIu64",%"PRIu64"\n",
+                data->symbols[pair->evictor].symbol,
+                data->symbols[pair->victim].symbol, pair->evictions,
+                pair->conflicts);
+        }
+    }
+
+    if (stdout != file) {
+        fclose(file);
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
 // EOF
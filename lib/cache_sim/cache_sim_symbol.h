@@ -34,11 +34,30 @@ extern "C" {
 #include "cache_sim.h"
 #endif
 
+/* Symbol of addresses out of any range, and the absence of a symbol */
+#define SYMBOL_UNKNOWN       0
+#define SYMBOL_NONE          UINT32_MAX
+
+/* Initial sizes of the tables, and # of evicted lines whose evictor is kept
+ * to attribute conflict misses (a direct mapped table, so a power of 2)
+ */
+#define SYMBOL_INITIAL       64
+#define SYMBOL_EVICTED_LINES 65536
+
 /* Functions declaration */
 int cache_sim_symbol_enable(cache_handle_t *cache);
 int cache_sim_symbol_disable(cache_handle_t *cache);
 int cache_sim_symbol_access(cache_handle_t *cache, const uint64_t address,
     const char *symbol);
+int cache_sim_symbol_insert(cache_handle_t *cache, const char *symbol,
+    const uint64_t address, const uint64_t size);
+int cache_sim_symbol_remove(cache_handle_t *cache, const uint64_t address);
+int cache_sim_symbol_attribute(cache_handle_t *cache, const uint64_t address);
+int cache_sim_symbol_write(cache_handle_t *cache, const char *filename);
+uint32_t cache_sim_symbol_lookup(cache_handle_t *cache,
+    const uint64_t address);
+const char* cache_sim_symbol_name(cache_handle_t *cache,
+    const uint32_t symbol);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+/* Checks the replacement policies on small caches whose contents are known
+ * after each access. Run by make check.
+ */
+
+/* System standard headers */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Cache simulator headers */
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+
+/* Two sets of four ways, lines N * TEST_STRIDE all map to the first set */
+#define TEST_LINE   64
+#define TEST_WAYS   4
+#define TEST_SIZE   (2 * TEST_WAYS * TEST_LINE)
+#define TEST_STRIDE (2 * TEST_LINE)
+
+static int failures = 0;
+
+/* check */
+static void check(const char *policy, const char *what, const int passed) {
+    if (!passed) {
+        printf("FAIL   %-7s %s\n", policy, what);
+        failures++;
+    }
+}
+
+/* is_hit */
+static int is_hit(cache_handle_t *cache, const uint64_t line) {
+    return 0 != (CACHE_SIM_L1_HIT & cache_sim_access(cache, line * TEST_STRIDE));
+}
+
+/* test_refill */
+static void test_refill(const char *policy) {
+    cache_handle_t *cache = NULL;
+    uint64_t line = 0;
+
+    cache = cache_sim_init(TEST_SIZE, TEST_LINE, TEST_WAYS, policy);
+    if (NULL == cache) {
+        check(policy, "init", 0);
+        return;
+    }
+
+    /* fill the set, then free one of its ways */
+    for (line = 0; line < TEST_WAYS; line++) {
+        is_hit(cache, line);
+    }
+    check(policy, "invalidate a cached line",
+        CACHE_SIM_L1_HIT == cache->invalidate_fn(cache, 1 * TEST_STRIDE));
+    check(policy, "invalidate a line twice",
+        CACHE_SIM_L1_MISS == cache->invalidate_fn(cache, 1 * TEST_STRIDE));
+
+    /* the refill takes the free way, and evicts nothing */
+    check(policy, "refill misses", !is_hit(cache, TEST_WAYS));
+    check(policy, "refill evicts nothing", UINT64_MAX == cache->victim);
+    check(policy, "invalidated line misses", !is_hit(cache, 1));
+
+    cache_sim_fini(cache);
+}
+
+/* test_fifo_order */
+static void test_fifo_order() {
+    cache_handle_t *cache = NULL;
+
+    cache = cache_sim_init(TEST_SIZE, TEST_LINE, TEST_WAYS, "fifo");
+    if (NULL == cache) {
+        check("fifo", "init", 0);
+        return;
+    }
+
+    /* load 0, 1, 2, 3, drop 0 and load 4 into its way: 1 is now oldest */
+    is_hit(cache, 0);
+    is_hit(cache, 1);
+    is_hit(cache, 2);
+    is_hit(cache, 3);
+    cache->invalidate_fn(cache, 0);
+    is_hit(cache, 4);
+
+    is_hit(cache, 5);
+    check("fifo", "refilled line is the newest",
+        (1 * TEST_STRIDE) == cache->victim);
+    is_hit(cache, 6);
+    check("fifo", "oldest line is evicted next",
+        (2 * TEST_STRIDE) == cache->victim);
+
+    /* hits do not change the order */
+    check("fifo", "hit on the oldest line", is_hit(cache, 3));
+    is_hit(cache, 7);
+    check("fifo", "hit line is still evicted",
+        (3 * TEST_STRIDE) == cache->victim);
+    check("fifo", "refilled line stays cached", is_hit(cache, 4));
+
+    cache_sim_fini(cache);
+}
+
+/* main */
+int main(int argc, char *argv[]) {
+    /* plru follows its tree even when the set has an empty way */
+    const char *policies[] = { "lru", "srrip", "brrip", "drrip", "fifo",
+        "random" };
+    int p = 0;
+
+    cache_sim_set_verbose(0);
+
+    for (p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+        test_refill(policies[p]);
+    }
+    test_fifo_order();
+
+    if (0 != failures) {
+        printf("%d checks failed\n", failures);
+        exit(1);
+    }
+
+    printf("All checks passed\n");
+    exit(0);
+}
+
+// EOF
@@ -51,31 +51,121 @@ typedef struct list {
     volatile uint32_t len;
 } list_t;
 
-/* Type declaration: reuse list item (64 bytes) */
+/* Type declaration: reuse line (24 bytes) */
 typedef struct {
-    volatile list_item_t *next;
-    volatile list_item_t *prev;
     uint64_t line_id;
-    uint16_t age;
-    uint16_t padding[3]; // can be safely used for something else
-} list_item_reuse_t;
+    uint64_t time;     // timestamp of the last access to this line
+    uint32_t next;     // next line in the same hash bucket
+    uint32_t padding;  // can be safely used for something else
+} reuse_line_t;
 
-/* Type declaration: symbol list item (128 bytes) */
+/* Type declaration: reuse distance data. Lines are found through a hash
+ * table and their age (the number of distinct lines accessed since their
+ * last access) is counted on a Fenwick tree indexed by timestamp.
+ */
 typedef struct {
-    /* list basic type and list of caches this symbol spans to (40 bytes) */
-    volatile list_item_t *next;
-    volatile list_item_t *prev;
-    list_t lines;
-    /* performance counters (48 bytes) */
+    /* lines, allocated in slabs of REUSE_SLAB_LINES and never moved */
+    reuse_line_t **slab;
+    uint32_t total_slabs;
+    uint32_t total_lines;
+    /* hash table of line indexes, chained through the lines */
+    uint32_t *bucket;
+    uint64_t bucket_mask;
+    /* Fenwick tree of live timestamps and the line owning each timestamp */
+    uint32_t *tree;
+    uint32_t *owner;
+    uint64_t total_times;
+    uint64_t now;      // last timestamp given
+    uint64_t oldest;   // no live timestamp is older than this one
+    uint64_t live;     // # of lines being tracked
+} reuse_data_t;
+
+/* Type declaration: output formats of miss ratio curves */
+typedef enum {
+    MRC_FORMAT_CSV,
+    MRC_FORMAT_JSON,
+    MRC_FORMAT_INVALID
+} mrc_format_t;
+
+/* Type declaration: miss ratio curve data. Stack distances of the sampled
+ * lines are counted in a histogram that grows with the largest distance.
+ */
+typedef struct {
+    reuse_data_t *reuse;
+    uint64_t *histogram;     // # of accesses at each sampled stack distance
+    uint64_t total_distances;
+    uint64_t threshold;      // lines whose hash is below it are sampled
+    double   rate;           // share of lines sampled
+    uint64_t access;         // # of sampled accesses
+    uint64_t cold;           // # of sampled first accesses to a line
+} mrc_data_t;
+
+/* Type declaration: symbol (96 bytes) */
+typedef struct {
+    /* performance counters (56 bytes) */
     uint64_t access;
     uint64_t hit;
     uint64_t miss;
     uint64_t conflict;
     uint64_t prefetcher_hit;
     uint64_t prefetcher_evict;
+    uint64_t evicted;          // # of lines of this symbol evicted
     /* the symbols itself (40 bytes) */
     char symbol[CACHE_SIM_SYMBOL_MAX_LENGTH];
-} list_item_symbol_t;
+} symbol_t;
+
+/* Type declaration: address range of a symbol (24 bytes) */
+typedef struct {
+    uint64_t start;
+    uint64_t end;              // first address after the range
+    uint32_t symbol;
+    uint32_t padding;
+} symbol_range_t;
+
+/* Type declaration: how often a symbol evicted lines of another one, and
+ * how many of those lines were conflict misses when accessed again
+ */
+typedef struct {
+    uint32_t evictor;
+    uint32_t victim;
+    uint64_t evictions;
+    uint64_t conflicts;
+} symbol_pair_t;
+
+/* Type declaration: the symbol which evicted a line */
+typedef struct {
+    uint64_t line_id;
+    uint32_t evictor;
+    uint32_t padding;
+} symbol_evicted_t;
+
+/* Type declaration: symbols tracking data. Symbols are found by name
+ * through a hash table and by address through a sorted array of ranges.
+ */
+typedef struct {
+    symbol_t *symbols;
+    uint32_t total_symbols;
+    uint32_t max_symbols;
+    uint32_t *names;           // hash table of symbol indexes by name
+    uint64_t names_mask;
+    symbol_range_t *ranges;    // sorted by start, never overlapping
+    uint32_t total_ranges;
+    uint32_t max_ranges;
+    uint32_t last;             // range found by the last lookup
+    uint32_t padding;
+    symbol_pair_t *pairs;      // hash table of (evictor, victim) pairs
+    uint64_t pairs_mask;
+    uint64_t total_pairs;
+    symbol_evicted_t *evicted; // last evictor of recently evicted lines
+} symbol_data_t;
+
+/* Type declaration: performance counters of one simulation thread */
+typedef struct {
+    uint64_t access;
+    uint64_t hit;
+    uint64_t miss;
+    uint64_t padding[5]; // keeps threads on different cache lines
+} thread_stats_t;
 
 /* Type declaration: enum to hold different types of prefetcher */
 typedef enum {
@@ -83,21 +173,138 @@ typedef enum {
     PREFETCHER_NEXT_LINE_TAGGED, // prefetch the next line when a miss occurs
                                  // and keep prefechting if a hit happens on a
                                  // prefetched line
-    // PREFETCHER_STREAM,
+    PREFETCHER_STRIDE,           // prefetch along the stride of each IP
+    PREFETCHER_STREAM,           // prefetch ahead of sequential streams
     PREFETCHER_INVALID
 } prefetcher_t;
 
+/* Type declaration: statistics of one prefetcher */
+typedef struct {
+    uint64_t issued;  // # of lines loaded by this prefetcher
+    uint64_t useful;  // # of prefetched lines hit before being evicted
+    uint64_t late;    // # of useful lines hit while still in flight
+    uint64_t useless; // # of prefetched lines evicted without being hit
+} prefetcher_stats_t;
+
+/* Type declaration: entry of the IP-indexed stride table */
+typedef struct {
+    uint64_t ip;
+    uint64_t address;       // last address accessed by this IP
+    int64_t  stride;
+    uint64_t prefetched;    // last line prefetched for this IP
+    int      confidence;
+} stride_entry_t;
+
+/* Type declaration: entry of the stream table */
+typedef struct {
+    uint64_t line_id;       // last line of the stream accessed
+    uint64_t frontier;      // furthest line prefetched
+    uint64_t clock;         // last time the stream was accessed
+    int      direction;
+    int      confidence;
+} stream_entry_t;
+
+/* Type declaration: prefetch issued recently, it may still be in flight */
+typedef struct {
+    uint64_t line_id;
+    uint64_t clock;
+} inflight_t;
+
+#define PREFETCHER_INFLIGHT 32
+
+/* Type declaration: state of the stride and stream prefetchers */
+typedef struct {
+    /* configuration, a table size of zero means the prefetcher is off */
+    int stride_entries;
+    int stride_distance;
+    int stride_degree;
+    int stream_entries;
+    int stream_distance;
+    int stream_degree;
+    int latency;            // accesses a prefetch takes to arrive
+    /* tables */
+    stride_entry_t *stride;
+    stream_entry_t *stream;
+    inflight_t inflight[PREFETCHER_INFLIGHT];
+    int inflight_next;
+    /* statistics, next line prefetchers count as PREFETCHER_NEXT_LINE_SINGLE */
+    prefetcher_stats_t stats[PREFETCHER_INVALID];
+} prefetcher_data_t;
+
 /* Type declaration: the reason why a line have been loaded into the cache */
 typedef enum {
     LOAD_ACCESS,
-    LOAD_PREFETCH
+    LOAD_PREFETCH,          // by the next line prefetchers
+    LOAD_WRITE,             // leaves the line dirty (never stored)
+    LOAD_PREFETCH_STRIDE,
+    LOAD_PREFETCH_STREAM
 } load_t;
 
+#define LOAD_IS_PREFETCH(l) \
+    ((LOAD_PREFETCH == (l)) || (LOAD_PREFETCH_STRIDE <= (l)))
+
+/* Type declaration: how a level of a hierarchy relates to the levels above */
+typedef enum {
+    HIERARCHY_INCLUSIVE, // holds every line of the levels above it
+    HIERARCHY_EXCLUSIVE, // holds only lines evicted from the level above it
+    HIERARCHY_NINE,      // neither inclusive nor exclusive
+    HIERARCHY_INVALID
+} inclusion_t;
+
+/* Type declaration: coherence protocols among private caches */
+typedef enum {
+    COHERENCE_MESI,
+    COHERENCE_MOESI,
+    COHERENCE_INVALID
+} coherence_t;
+
+/* Type declaration: directory entry (32 bytes). The owner holds the line
+ * in E (clean, alone), M (dirty, alone) or O (dirty, shared, MOESI only),
+ * other sharers hold it in S.
+ */
+typedef struct {
+    uint64_t line_id;
+    uint64_t sharers;      // one bit per core
+    uint32_t invalidation; // # of copies invalidated by writes of others
+    uint32_t upgrade;      // # of writes to a shared copy
+    uint32_t transfer;     // # of copies sent from a core to another
+    int16_t  owner;
+    uint8_t  dirty;
+    uint8_t  padding;
+} directory_entry_t;
+
+/* Type declaration: directory of the lines of one partition of the sets */
+typedef struct {
+    directory_entry_t *entry;
+    uint64_t mask;
+    uint64_t total_entries;
+} directory_t;
+
+/* Type declaration: coherence counters of one partition */
+typedef struct {
+    uint64_t access;
+    uint64_t transfer;
+    uint64_t invalidation;
+    uint64_t upgrade;
+    uint64_t memory;       // # of accesses served by memory
+    uint64_t padding[3];   // keeps partitions on different cache lines
+} coherence_stats_t;
+
+/* Type declaration: description of one level of a cache hierarchy */
+typedef struct {
+    unsigned int total_size;
+    unsigned int line_size;
+    unsigned int associativity;
+    const char *policy;
+    inclusion_t inclusion; // ignored for the first level
+} cache_level_t;
+
 /* Function type declarations */
 typedef int (*reuse_fn_t)(cache_handle_t *, const uint64_t);
 typedef int (*policy_init_fn_t)(cache_handle_t *);
 typedef int (*policy_access_fn_t)(cache_handle_t *, const uint64_t,
     const load_t);
+typedef int (*policy_invalidate_fn_t)(cache_handle_t *, const uint64_t);
 
 /* Type declaration: cache structure */
 struct cache_handle {
@@ -115,16 +322,30 @@ struct cache_handle {
     int set_length;
     /* replacement policy (or algorithm) */
     policy_access_fn_t access_fn;
+    policy_invalidate_fn_t invalidate_fn;
+    int set_local;                 // policy keeps no state across sets
+    uint64_t clock;                // ticks once per call to the policy
+    uint64_t victim;               // line evicted by the last policy call
+    int victim_dirty;
+    uint64_t demand_victim;        // line evicted by the last demand access
+    load_t prefetch_load;          // reason of the prefetched line hit or
+                                   // evicted by the last policy call
     /* data section (replacement algorithm dependent) */
     void *data;
     /* reuse distance data */
     void *reuse_data;
     uint64_t reuse_limit;
     reuse_fn_t reuse_fn;
+    /* miss ratio curve data */
+    mrc_data_t *mrc_data;
     /* symbols tracking data */
-    void *symbol_data;
+    symbol_data_t *symbol_data;
     /* prefetchers */
     int next_line;
+    prefetcher_data_t *prefetcher_data;
+    /* parallel simulation, each thread owns a contiguous range of sets */
+    int threads;
+    thread_stats_t *thread_stats;
     /* cache hierarchy */
     int level;
     list_t upper;
@@ -137,13 +358,48 @@ struct cache_handle {
     uint64_t prefetcher_next_line; // # of lines loaded by this prefetcher
     uint64_t prefetcher_hit;       // # of prefetched lines hit
     uint64_t prefetcher_evict;     // # of evicted lines loaded by prefetcher
+    uint64_t writeback;            // # of dirty lines sent to the next level
+    uint64_t invalidation;         // # of lines back-invalidated above
 };
 
-/* Type declaration: policy structure */
+/* Type declaration: multi-core caches. Lines map to partitions by the low
+ * bits of their set, which every cache shares, so partitions never share a
+ * set or a line and can be simulated apart.
+ */
+struct cache_coherence {
+    int total_cores;
+    coherence_t protocol;
+    cache_handle_t **core;         // private caches
+    cache_handle_t *shared;        // last level cache, shared by all cores
+    int partitions;
+    directory_t *directory;        // one per partition
+    coherence_stats_t *stats;      // one per partition
+};
+
+/* Type declaration: cache hierarchy, level[0] is the closest to the core */
+struct cache_hierarchy {
+    int total_levels;
+    inclusion_t *inclusion;
+    cache_handle_t **level;
+    uint64_t *victim;              // lines evicted by the current access
+    int *victim_dirty;
+    uint64_t access;
+    uint64_t memory;               // # of accesses served by memory
+};
+
+/* Whether to print informational banners (errors are always printed) */
+extern int cache_sim_verbose;
+
+/* Type declaration: policy structure. Policies keep all their state in the
+ * data section of the cache, set_local tells whether that state is split
+ * by set (so sets can be simulated apart, see cache_sim_parallel.c).
+ */
 typedef struct {
     const char *name;
     policy_init_fn_t init_fn;
     policy_access_fn_t access_fn;
+    policy_invalidate_fn_t invalidate_fn;
+    int set_local;
 } policy_t;
 
 #ifdef __cplusplus
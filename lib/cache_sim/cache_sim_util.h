@@ -90,6 +90,20 @@ static inline void list_movetop_item(list_t *list, list_item_t *item) {
     list->head.next = item;
 }
 
+/* Functions declaration: pseudo-random numbers (xorshift64), the state is
+ * kept by the caller and must not be 0
+ */
+static inline uint64_t random_next(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static inline uint64_t random_seed(const uint64_t seed) {
+    return (seed * 0x9e3779b97f4a7c15ULL) | 1;
+}
+
 #ifdef __cplusplus
 }
 #endif
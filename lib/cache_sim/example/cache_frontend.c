@@ -22,11 +22,32 @@
 /* headers */
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
 #include "cache_sim.h"
 
+/* Replaying the same trace through cache_sim_access_batch instead of one
+ * cache_sim_access call per address (32KB, 8-way LRU, 32M accesses, no
+ * reuse distance or prefetcher) went from 42-86M to 50-88M accesses per
+ * second across runs, 1.05x to 1.3x: without the call overhead the policy
+ * itself dominates. PLRU runs at the same speed either way.
+ */
+#define TRACE_LENGTH (32 * 1024 * 1024)
+
+/* elapsed */
+static double elapsed(struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) +
+        ((end.tv_nsec - start->tv_nsec) / 1e9);
+}
+
 /* main */
 int main(int argc, char *argv[]) {
     cache_handle_t *cache;
+    struct timespec start;
+    uint64_t *trace = NULL;
     uint64_t i = 0;
 
     if (NULL == (cache = cache_sim_init(32768, 64, 8, "lru"))) {
@@ -53,6 +74,35 @@ int main(int argc, char *argv[]) {
 
     cache_sim_fini(cache);
 
+    /* compare the throughput of single and batched accesses */
+    trace = (uint64_t *)malloc(TRACE_LENGTH * sizeof(uint64_t));
+    if (NULL == trace) {
+        printf("Error\n");
+        exit(1);
+    }
+    for (i = 0; i < TRACE_LENGTH; i++) {
+        trace[i] = (i % 4) ? (trace[i - 1] + 8) :
+            (((uint64_t)rand() * 8) % (4 * 1024 * 1024));
+    }
+
+    cache_sim_set_verbose(0);
+
+    cache = cache_sim_init(32768, 64, 8, "lru");
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < TRACE_LENGTH; i++) {
+        cache_sim_access(cache, trace[i]);
+    }
+    printf("Single: %12.0f accesses/s\n", TRACE_LENGTH / elapsed(&start));
+    cache_sim_fini(cache);
+
+    cache = cache_sim_init(32768, 64, 8, "lru");
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    cache_sim_access_batch(cache, trace, NULL, TRACE_LENGTH, NULL);
+    printf("Batch:  %12.0f accesses/s\n", TRACE_LENGTH / elapsed(&start));
+    cache_sim_fini(cache);
+
+    free(trace);
+
     exit(0);
 }
 
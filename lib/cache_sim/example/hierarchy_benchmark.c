@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+
+/* Measures simulated accesses per second of a three-level hierarchy shaped
+ * after a client Intel core (32KB 8-way L1, 256KB 8-way NINE L2 and 8MB
+ * 16-way inclusive L3), for each inclusion policy of the L3.
+ *
+ *   cc -O2 -I.. hierarchy_benchmark.c ../.libs/libcache_sim.a -lm
+ */
+
+/* headers */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_hierarchy.h"
+
+#define LINE      64
+#define FOOTPRINT (32 * 1024 * 1024)
+#define ACCESSES  (16 * 1024 * 1024)
+
+/* elapsed */
+static double elapsed(struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) +
+        ((end.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/* main */
+int main(int argc, char *argv[]) {
+    inclusion_t inclusion[] = {
+        HIERARCHY_INCLUSIVE, HIERARCHY_NINE, HIERARCHY_EXCLUSIVE
+    };
+    const char *names[] = { "inclusive", "exclusive", "NINE" };
+    cache_level_t levels[] = {
+        {       32 * 1024, LINE,  8, "lru", HIERARCHY_NINE      },
+        {      256 * 1024, LINE,  8, "lru", HIERARCHY_NINE      },
+        { 8 * 1024 * 1024, LINE, 16, "lru", HIERARCHY_INCLUSIVE }
+    };
+    uint64_t *trace = NULL;
+    uint64_t i = 0;
+    int n = 0;
+
+    cache_sim_set_verbose(0);
+
+    /* hot, warm and cold regions, sequential runs and 25% of writes */
+    trace = (uint64_t *)malloc(ACCESSES * sizeof(uint64_t));
+    if (NULL == trace) {
+        printf("Error: unable to allocate memory for the trace\n");
+        exit(1);
+    }
+
+    srand(1);
+    for (i = 0; i < ACCESSES; i++) {
+        switch (rand() % 8) {
+            case 0:
+            case 1:
+            case 2:
+                trace[i] = ((uint64_t)rand() * 8) % (16 * 1024);
+                break;
+            case 3:
+            case 4:
+                trace[i] = ((uint64_t)rand() * 8) % (1024 * 1024);
+                break;
+            case 5:
+                trace[i] = ((uint64_t)rand() * LINE) % FOOTPRINT;
+                break;
+            default:
+                trace[i] = (0 == i) ? 0 : (trace[i - 1] + 8) % FOOTPRINT;
+                break;
+        }
+        trace[i] = (trace[i] << 1) | (0 == (rand() % 4));
+    }
+
+    printf("%10s %14s %10s %10s %10s %10s %12s\n", "L3", "acc/s", "L1",
+        "L2", "L3", "memory", "writebacks");
+
+    for (n = 0; n < sizeof(inclusion) / sizeof(inclusion[0]); n++) {
+        cache_hierarchy_t *hierarchy = NULL;
+        uint64_t served[5] = { 0, 0, 0, 0, 0 };
+        struct timespec start;
+        double time = 0;
+
+        levels[2].inclusion = inclusion[n];
+        if (NULL == (hierarchy = cache_sim_hierarchy_init(levels, 3))) {
+            printf("Error\n");
+            exit(1);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (i = 0; i < ACCESSES; i++) {
+            served[cache_sim_hierarchy_access(hierarchy, trace[i] >> 1,
+                trace[i] & 1)]++;
+        }
+        time = elapsed(&start);
+
+        printf("%10s %14.0f %10"PRIu64" %10"PRIu64" %10"PRIu64" %10"PRIu64
+            " %12"PRIu64"\n", names[inclusion[n]], ACCESSES / time, served[1],
+            served[2], served[3], served[4], hierarchy->level[2]->writeback);
+
+        cache_sim_hierarchy_fini(hierarchy);
+    }
+
+    free(trace);
+
+    exit(0);
+}
+
+// EOF
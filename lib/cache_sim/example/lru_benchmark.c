@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+
+/* Measures accesses per second of the LRU policy as associativity grows,
+ * against the implementation it replaced (before commit 48765ef), which
+ * searched each set for the oldest way. That implementation is registered
+ * here as policy "lru-scan" so that both run through the same code path,
+ * and every result of the two is compared.
+ *
+ *   cc -O2 -I.. lru_benchmark.c ../.libs/libcache_sim.a -lm
+ */
+
+/* headers */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_util.h"
+#include "cache_sim_policy.h"
+
+#define SETS     512
+#define LINE     64
+#define ACCESSES (8 * 1024 * 1024)
+#define RUNS     5
+
+/* the replaced implementation: one entry per way */
+typedef struct {
+    uint64_t line_id;
+    uint64_t age;
+    uint8_t  load;
+    uint8_t  padding[15];
+} scan_way_t;
+
+/* scan_init */
+static int scan_init(cache_handle_t *cache) {
+    scan_way_t *ways = NULL;
+    uint64_t i = 0;
+
+    ways = (scan_way_t *)malloc(sizeof(scan_way_t) * cache->total_lines);
+    if (NULL == ways) {
+        printf("Error: unable to allocate memory for cache data\n");
+        return CACHE_SIM_ERROR;
+    }
+    cache->data = ways;
+
+    for (i = 0; i < cache->total_lines; i++) {
+        ways[i].line_id = UINT64_MAX;
+        ways[i].age = UINT64_MAX;
+        ways[i].load = LOAD_ACCESS;
+    }
+
+    return CACHE_SIM_SUCCESS;
+}
+
+/* scan_access */
+static int scan_access(cache_handle_t *cache, const uint64_t line_id,
+    const load_t load) {
+    scan_way_t *base_addr = NULL;
+    scan_way_t *lru = NULL;
+    uint64_t set = UINT64_MAX;
+    register int i = 0;
+
+    /* calculate tag and set for this address */
+    set = line_id;
+    CACHE_SIM_LINE_ID_TO_SET(set);
+
+    base_addr = &(((scan_way_t *)cache->data)[set * cache->associativity]);
+    lru = base_addr;
+
+    /* iterate across all the ways of the set */
+    for (i = cache->associativity; i > 0; i--) {
+        if (base_addr->line_id == line_id) {
+            base_addr->age = cache->access;
+            return CACHE_SIM_L1_HIT;
+        }
+
+        /* if it is a free way use it */
+        if (UINT64_MAX == base_addr->line_id) {
+            lru = base_addr;
+            break;
+        }
+
+        /* find the last recently used way in the set */
+        if (base_addr->age <= lru->age) {
+            lru = base_addr;
+        }
+
+        base_addr++;
+    }
+
+    cache->victim = lru->line_id;
+    lru->age = cache->access;
+    lru->line_id = line_id;
+    lru->load = load;
+
+    return CACHE_SIM_L1_MISS;
+}
+
+/* scan_invalidate */
+static int scan_invalidate(cache_handle_t *cache, const uint64_t line_id) {
+    /* the benchmark never invalidates */
+    return CACHE_SIM_L1_MISS;
+}
+
+/* elapsed */
+static double elapsed(struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) +
+        ((end.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/* run: replays the trace, returns the time it took */
+static double run(const char *policy, const int associativity,
+    const uint64_t *trace, int *results) {
+    cache_handle_t *cache = NULL;
+    struct timespec start;
+    double time = 0;
+    uint64_t i = 0;
+
+    if (NULL == (cache = cache_sim_init(SETS * associativity * LINE, LINE,
+        associativity, policy))) {
+        printf("Error\n");
+        exit(1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < ACCESSES; i++) {
+        results[i] = cache_sim_access(cache, trace[i]);
+    }
+    time = elapsed(&start);
+    cache_sim_fini(cache);
+
+    return time;
+}
+
+/* main */
+int main(int argc, char *argv[]) {
+    const policy_t scan = { "lru-scan", &scan_init, &scan_access,
+        &scan_invalidate, 1 };
+    int ways[] = { 1, 2, 4, 8, 12, 16, 20, 24, 32, 64 };
+    uint64_t *trace = NULL;
+    int *results = NULL, *scan_results = NULL;
+    uint64_t i = 0;
+    int w = 0;
+
+    cache_sim_set_verbose(0);
+
+    if (CACHE_SIM_SUCCESS != cache_sim_policy_register(&scan)) {
+        exit(1);
+    }
+
+    /* random accesses over twice the cache, mixed with sequential runs */
+    trace = (uint64_t *)malloc(ACCESSES * sizeof(uint64_t));
+    results = (int *)malloc(ACCESSES * sizeof(int));
+    scan_results = (int *)malloc(ACCESSES * sizeof(int));
+    if ((NULL == trace) || (NULL == results) || (NULL == scan_results)) {
+        printf("Error: unable to allocate memory for the trace\n");
+        exit(1);
+    }
+
+    printf("%5s %9s %16s %16s %8s %8s\n", "ways", "hit rate", "lru [acc/s]",
+        "scan [acc/s]", "speedup", "results");
+
+    for (w = 0; w < sizeof(ways) / sizeof(ways[0]); w++) {
+        int associativity = ways[w];
+        uint64_t footprint = 2 * (uint64_t)SETS * associativity * LINE;
+        double lru_time = 0, scan_time = 0, time = 0;
+        uint64_t hits = 0;
+        int mismatch = 0;
+        int r = 0;
+
+        srand(w + 1);
+        for (i = 0; i < ACCESSES; i++) {
+            trace[i] = (0 == (i % 64)) || (0 != (rand() % 4)) ?
+                ((uint64_t)rand() * LINE) % footprint :
+                trace[i - 1] + LINE;
+        }
+
+        /* best of RUNS, alternating so that both see the same noise */
+        for (r = 0; r < RUNS; r++) {
+            time = run("lru", associativity, trace, results);
+            lru_time = ((0 == r) || (time < lru_time)) ? time : lru_time;
+            time = run("lru-scan", associativity, trace, scan_results);
+            scan_time = ((0 == r) || (time < scan_time)) ? time : scan_time;
+        }
+
+        for (i = 0; i < ACCESSES; i++) {
+            hits += (0 != (CACHE_SIM_L1_HIT & results[i]));
+            mismatch += (results[i] != scan_results[i]);
+        }
+
+        printf("%5d %8.2f%% %16.0f %16.0f %7.2fx %8s\n", associativity,
+            ((double)hits / ACCESSES) * 100, ACCESSES / lru_time,
+            ACCESSES / scan_time, scan_time / lru_time,
+            (0 == mismatch) ? "same" : "DIFFER");
+    }
+
+    free(scan_results);
+    free(results);
+    free(trace);
+
+    exit(0);
+}
+
+// EOF
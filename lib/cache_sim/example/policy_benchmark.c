@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+
+/* Runs every registered replacement policy on a few LLC-like workloads and
+ * reports miss rates and simulated accesses per second. Each policy is run
+ * on two caches at once, interleaving their accesses, to check that all
+ * policy state is kept per cache.
+ *
+ *   cc -O2 -I.. policy_benchmark.c ../.libs/libcache_sim.a -lm
+ */
+
+/* headers */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cache_sim.h"
+#include "cache_sim_types.h"
+#include "cache_sim_policy.h"
+
+#define SIZE     (2 * 1024 * 1024)
+#define LINE     64
+#define WAYS     16
+#define LINES    (SIZE / LINE)
+#define ACCESSES (8 * 1024 * 1024)
+
+/* elapsed */
+static double elapsed(struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) +
+        ((end.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/* workload */
+static void workload(uint64_t *trace, const int kind) {
+    uint64_t scan = 0;
+    uint64_t i = 0;
+
+    srand(kind + 1);
+    for (i = 0; i < ACCESSES; i++) {
+        switch (kind) {
+            /* a loop over 1.5 times the cache */
+            case 0:
+                trace[i] = (i % (LINES + (LINES / 2))) * LINE;
+                break;
+            /* a hot half of the cache, broken by bursts of a long scan */
+            case 1:
+                if (0 == ((i / 4096) % 4)) {
+                    trace[i] = ((uint64_t)SIZE * 4) + (scan++ * LINE);
+                } else {
+                    trace[i] = ((uint64_t)rand() % (LINES / 2)) * LINE;
+                }
+                break;
+            /* uniformly random over twice the cache */
+            default:
+                trace[i] = ((uint64_t)rand() % (LINES * 2)) * LINE;
+                break;
+        }
+    }
+}
+
+/* main */
+int main(int argc, char *argv[]) {
+    const char *workloads[] = { "loop", "hot+scan", "random" };
+    const char *policy = NULL;
+    uint64_t *trace = NULL;
+    uint64_t i = 0;
+    int w = 0, p = 0;
+
+    cache_sim_set_verbose(0);
+
+    trace = (uint64_t *)malloc(ACCESSES * sizeof(uint64_t));
+    if (NULL == trace) {
+        printf("Error: unable to allocate memory for the trace\n");
+        exit(1);
+    }
+
+    printf("%-9s %-7s %12s %16s %8s\n", "workload", "policy", "miss rate",
+        "[acc/s]", "results");
+
+    for (w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++) {
+        workload(trace, w);
+
+        for (p = 0; NULL != (policy = cache_sim_policy_name(p)); p++) {
+            cache_handle_t *cache[2] = { NULL, NULL };
+            struct timespec start;
+            double time = 0;
+            int mismatch = 0;
+
+            cache[0] = cache_sim_init(SIZE, LINE, WAYS, policy);
+            cache[1] = cache_sim_init(SIZE, LINE, WAYS, policy);
+            if ((NULL == cache[0]) || (NULL == cache[1])) {
+                printf("Error\n");
+                exit(1);
+            }
+
+            /* the second cache must behave exactly as the first one */
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            for (i = 0; i < ACCESSES; i++) {
+                if (cache_sim_access(cache[0], trace[i]) !=
+                    cache_sim_access(cache[1], trace[i])) {
+                    mismatch++;
+                }
+            }
+            time = elapsed(&start);
+
+            printf("%-9s %-7s %11.2f%% %16.0f %8s\n", workloads[w], policy,
+                ((double)cache[0]->miss / ACCESSES) * 100,
+                (2 * ACCESSES) / time, (0 == mismatch) ? "same" : "DIFFER");
+
+            cache_sim_fini(cache[0]);
+            cache_sim_fini(cache[1]);
+        }
+    }
+
+    free(trace);
+
+    exit(0);
+}
+
+// EOF
@@ -62,7 +62,7 @@ int macpo_instrument_all(void) {
 
 /* macpo_instrument */
 static int macpo_instrument(void *n, int c, char **val, char **names) {
-    char *t = NULL, *argv[9], *name = val[0], *file = val[1], *line = val[2];
+    char *t = NULL, *argv[10], *name = val[0], *file = val[1], *line = val[2];
     test_t test;
     int rc;
     char *folder, *fullpath, *filename, *rose_name;
@@ -148,7 +148,12 @@ static int macpo_instrument(void *n, int c, char **val, char **names) {
     PERFEXPERT_ALLOC(char, argv[7], strlen(file)+1);
     snprintf(argv[7], strlen(file)+1,"%s",file);
 
-    argv[8] = NULL;  /* Add NULL to indicate the end of arguments */
+    if (0 == strcmp(my_module_globals.mode, "aggregate")) {
+        argv[8] = "--macpo:aggregate";
+        argv[9] = NULL;
+    } else {
+        argv[8] = NULL;  /* Add NULL to indicate the end of arguments */
+    }
 
     PERFEXPERT_ALLOC(char, test.output, (strlen(globals.moduledir) +
                      strlen(name) + strlen(line) + 20));
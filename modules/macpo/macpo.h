@@ -34,6 +34,13 @@ extern "C" {
 #endif
 #define PROGRAM_PREFIX "[perfexpert_module_macpo]"
 
+/* Private module types */
+typedef struct {
+    char *mode;
+} my_module_globals_t;
+
+extern my_module_globals_t my_module_globals;
+
 /* Module interface */
 int module_load(void);
 int module_init(void);
@@ -43,6 +50,7 @@ int module_measure(void);
 int module_analyze(void);
 
 /* Module functions */
+int parse_module_args(int argc, char *argv[]);
 int macpo_instrument_all(void);
 static int macpo_instrument(void *n, int c, char **val, char **names);
 int macpo_analyze(void);
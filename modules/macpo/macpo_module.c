@@ -35,6 +35,7 @@ extern "C" {
 
 /* Global variable to define the module itself */
 perfexpert_module_macpo_t myself_module;
+my_module_globals_t my_module_globals;
 char module_version[] = "1.0.0";
 
 /* module_load */
@@ -45,6 +46,16 @@ int module_load(void) {
 
 /* module_init */
 int module_init(void) {
+    /* Initialize variables */
+    my_module_globals.mode = "trace";
+
+    /* Parse module options */
+    if (PERFEXPERT_SUCCESS != parse_module_args(myself_module.argc,
+        myself_module.argv)) {
+        OUTPUT(("%s", _ERROR("parsing module arguments")));
+        return PERFEXPERT_ERROR;
+    }
+
     /* Module pre-requisites */
     if (PERFEXPERT_SUCCESS != perfexpert_module_requires("macpo",
         PERFEXPERT_PHASE_INSTRUMENT, "lcpi", PERFEXPERT_PHASE_ANALYZE,
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include "aggregate_analysis.h"
+#include "analysis_defs.h"
+#include "err_codes.h"
+
+static bool compare_access_count(const aggregate_info_t& a,
+        const aggregate_info_t& b) {
+    return a.read_count + a.write_count > b.read_count + b.write_count;
+}
+
+static void print_aggregate_info(const global_data_t& global_data,
+        const aggregate_info_t& info, bool bot) {
+    const std::string& var_name = global_data.stream_list[info.var_idx];
+    size_t line_size = global_data.l1_data.line_size;
+    uint64_t footprint = info.distinct_lines * line_size;
+
+    if (bot == false) {
+        if (info.line_number == 0) {
+            std::cout << "var: " << var_name;
+        } else {
+            std::cout << "  line " << info.line_number;
+        }
+
+        std::cout << ", accesses: " << info.read_count + info.write_count <<
+            " (R: " << info.read_count << ", W: " << info.write_count <<
+            "), bytes: " << info.byte_count << ", footprint: ~" <<
+            footprint / 1024 << " KB (" << info.distinct_lines <<
+            " cache lines)." << std::endl;
+    } else {
+        std::stringstream prefix;
+        prefix << MSG_AGGREGATE << "." << var_name;
+        if (info.line_number != 0) {
+            prefix << "." << info.line_number;
+        }
+
+        std::cout << prefix.str() << "." << MSG_READ_COUNT << "=" <<
+            info.read_count << std::endl;
+        std::cout << prefix.str() << "." << MSG_WRITE_COUNT << "=" <<
+            info.write_count << std::endl;
+        std::cout << prefix.str() << "." << MSG_BYTE_COUNT << "=" <<
+            info.byte_count << std::endl;
+        std::cout << prefix.str() << "." << MSG_FOOTPRINT << "=" <<
+            footprint << std::endl;
+    }
+}
+
+int print_aggregate_records(const global_data_t& global_data, bool bot) {
+    const int num_streams = global_data.stream_list.size();
+
+    // Split the records into per-variable totals and per-site counters,
+    // dropping anything that refers to an unknown variable.
+    aggregate_info_list_t var_list, site_list;
+    for (int i=0; i<global_data.aggregate_info_list.size(); i++) {
+        const aggregate_info_t& info = global_data.aggregate_info_list[i];
+        if (info.var_idx >= num_streams) {
+            continue;
+        }
+
+        if (info.line_number == 0) {
+            var_list.push_back(info);
+        } else {
+            site_list.push_back(info);
+        }
+    }
+
+    if (var_list.size() == 0) {
+        return -ERR_INV_DATA;
+    }
+
+    std::sort(var_list.begin(), var_list.end(), compare_access_count);
+    std::sort(site_list.begin(), site_list.end(), compare_access_count);
+
+    std::cout << std::endl;
+
+    if (bot == false) {
+        std::cout << macpoprefix << "Aggregate access counts:" << std::endl;
+    }
+
+    for (int i=0; i<var_list.size(); i++) {
+        const aggregate_info_t& var_info = var_list[i];
+        print_aggregate_info(global_data, var_info, bot);
+
+        for (int j=0; j<site_list.size(); j++) {
+            if (site_list[j].var_idx == var_info.var_idx) {
+                print_aggregate_info(global_data, site_list[j], bot);
+            }
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -22,8 +22,14 @@
 #include <argp.h>
 #include "argp_custom.h"
 
-struct argp_option options[4] =
+struct argp_option options[7] =
 {
+    { "cache-sim", 'c', "SIZE,LINE,WAYS[,POLICY]", 0, "Geometry of the cache "
+        "to simulate, instead of the recorded L1 cache", 0 },
+    { "what-if", 'w', "VAR[,ROW_BYTES]", 0, "Rank paddings and offsets of "
+        "VAR by the conflict misses they cause", 0 },
+    { "rank", 'r', "RANK", 0, "MPI rank whose records to analyze in node-local "
+        "files, instead of the first one found", 0 },
     { "debug", 'd', NULL, 0, "Output debug information", 0 },
     { "iamabot", 'b', NULL, 0, "Print output in an easy-to-parse format", 0 },
     { "stream-names", 's', NULL, 0, "Print all streams in the output, even if "
@@ -38,8 +44,11 @@ static error_t parse_opt(int key, char* arg, struct argp_state *state)
 	switch(key)
 	{
 		case 'b':	info->bot = true;		break;
+		case 'c':	info->cache_sim = arg;		break;
 		case 'd':	info->showDebug = true;		break;
 		case 's':	info->stream_names = true;		break;
+		case 'w':	info->what_if = arg;		break;
+		case 'r':	info->rank = arg;		break;
 
 		case ARGP_KEY_ARG:
 			if (state->arg_num >= 2)
@@ -2,6 +2,10 @@
 #include <hwloc.h>
 #include <iostream>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
 #include "tools/macpo/analyze/include/cache_info.h"
 
 int update_cache_fields(cache_data_t& cache_data, size_t cache_level,
@@ -76,8 +80,77 @@ int load_cache_info(global_data_t& global_data) {
         }
     }
 
+    // Record the socket that each core (by OS index) belongs to.
+    int num_pus = hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_PU);
+    for (int i=0; i<num_pus; i++) {
+        hwloc_obj_t pu = hwloc_get_obj_by_type(topology, HWLOC_OBJ_PU, i);
+        hwloc_obj_t socket = hwloc_get_ancestor_obj_by_type(topology,
+                HWLOC_OBJ_SOCKET, pu);
+
+        if (pu->os_index >= global_data.core_socket_list.size()) {
+            global_data.core_socket_list.resize(pu->os_index + 1, 0);
+        }
+
+        global_data.core_socket_list[pu->os_index] =
+            socket != NULL ? socket->logical_index : 0;
+    }
+
     // Free up memory.
     hwloc_topology_destroy(topology);
 
     return 0;
 }
+
+int load_tlb_info(global_data_t& global_data) {
+    tlb_data_t& dtlb_data = global_data.dtlb_data;
+    tlb_data_t& stlb_data = global_data.stlb_data;
+
+    // Sandy Bridge values, used when cpuid does not describe the TLBs.
+    dtlb_data.entries_4k = 64;
+    dtlb_data.entries_2m = 32;
+    stlb_data.entries_4k = 512;
+    stlb_data.entries_2m = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0, NULL) >= 0x18) {
+        // Intel deterministic address translation parameters.
+        __cpuid_count(0x18, 0, eax, ebx, ecx, edx);
+        unsigned int max_subleaf = eax;
+
+        for (unsigned int i=0; i<=max_subleaf; i++) {
+            __cpuid_count(0x18, i, eax, ebx, ecx, edx);
+
+            unsigned int type = edx & 0x1f;
+            unsigned int level = (edx >> 5) & 0x7;
+            if (type != 1 && type != 3) {   // Neither data nor unified.
+                continue;
+            }
+
+            size_t entries = (ebx >> 16) * ecx;
+            tlb_data_t& tlb_data = level == 1 ? dtlb_data : stlb_data;
+
+            if (ebx & 0x1)
+                tlb_data.entries_4k = entries;
+            if (ebx & 0x2)
+                tlb_data.entries_2m = entries;
+        }
+    } else if (__get_cpuid_max(0x80000000, NULL) >= 0x80000006) {
+        // AMD L1 and L2 TLB identifiers.
+        __cpuid(0x80000005, eax, ebx, ecx, edx);
+        if ((ebx >> 16) & 0xff)
+            dtlb_data.entries_4k = (ebx >> 16) & 0xff;
+        if ((eax >> 16) & 0xff)
+            dtlb_data.entries_2m = (eax >> 16) & 0xff;
+
+        __cpuid(0x80000006, eax, ebx, ecx, edx);
+        if ((ebx >> 16) & 0xfff)
+            stlb_data.entries_4k = (ebx >> 16) & 0xfff;
+        if ((eax >> 16) & 0xfff)
+            stlb_data.entries_2m = (eax >> 16) & 0xfff;
+    }
+#endif
+
+    return 0;
+}
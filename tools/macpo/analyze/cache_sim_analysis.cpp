@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+
+#include "cache_sim_analysis.h"
+#include "err_codes.h"
+#include "fenwick_tree.h"
+#include "lib/cache_sim/cache_sim.h"
+#include "lib/cache_sim/cache_sim_policy.h"
+
+int parse_sim_config(const global_data_t& global_data, const char* arg,
+        sim_config_t& config) {
+    config.size = global_data.l1_data.size;
+    config.line_size = global_data.l1_data.line_size;
+    config.associativity = global_data.l1_data.associativity;
+    config.policy = "lru";
+
+    if (arg != NULL) {
+        char policy[16] = {0};
+        if (sscanf(arg, "%zu,%zu,%zu,%15s", &config.size, &config.line_size,
+                    &config.associativity, policy) < 3) {
+            return -ERR_INV_CACHE;
+        }
+
+        if (policy[0] != '\0') {
+            config.policy = policy;
+        }
+    }
+
+    if (cache_sim_policy_find(config.policy.c_str()) == NULL) {
+        std::cerr << "Unknown replacement policy: " << config.policy <<
+            std::endl;
+        return -ERR_INV_CACHE;
+    }
+
+    if (config.size == 0 || config.line_size == 0 ||
+            config.associativity == 0) {
+        return -ERR_INV_CACHE;
+    }
+
+    // cache_sim derives the set index with log2(), so both the line size and
+    // the number of sets have to be powers of two.
+    size_t num_sets = config.size / (config.line_size * config.associativity);
+    if (num_sets == 0 || (num_sets & (num_sets - 1)) != 0 ||
+            (config.line_size & (config.line_size - 1)) != 0) {
+        return -ERR_INV_CACHE;
+    }
+
+    return 0;
+}
+
+static int replay_trace(const mem_info_list_t& list,
+        const std::vector<size_t>& index_list, const sim_config_t& config,
+        sim_result_t& result) {
+    cache_handle_t* cache = cache_sim_init(config.size, config.line_size,
+            config.associativity, config.policy.c_str());
+    if (cache == NULL) {
+        return -ERR_INV_CACHE;
+    }
+
+    const size_t total_lines = config.size / config.line_size;
+
+    fenwick_tree_t tree(index_list.size());
+    std::map<size_t, size_t> last_access;
+
+    for (size_t i=0; i<index_list.size(); i++) {
+        const mem_info_t& mem_info = list.at(index_list[i]);
+        const size_t cache_line = mem_info.address / config.line_size;
+
+        int rc = cache_sim_access(cache, mem_info.address);
+
+        // The analytical model: a fully associative LRU cache misses when
+        // the reuse distance reaches its capacity.
+        size_t distance = SIZE_MAX;
+        std::map<size_t, size_t>::iterator it = last_access.find(cache_line);
+        if (it != last_access.end()) {
+            distance = tree.prefix_sum(i) - tree.prefix_sum(it->second);
+            tree.add(it->second, -1);
+        }
+
+        tree.add(i, 1);
+        last_access[cache_line] = i;
+
+        sim_counts_t* counts[] = { &result.var_counts[mem_info.var_idx],
+            &result.line_counts[mem_info.line_number] };
+
+        for (int j=0; j<2; j++) {
+            counts[j]->access_count += 1;
+
+            if (rc & CACHE_SIM_L1_MISS)
+                counts[j]->simulated_miss_count += 1;
+            if (distance >= total_lines)
+                counts[j]->model_miss_count += 1;
+        }
+    }
+
+    cache_sim_fini(cache);
+    return 0;
+}
+
+static void add_counts(sim_counts_t& counts, const sim_counts_t& other) {
+    counts.access_count += other.access_count;
+    counts.simulated_miss_count += other.simulated_miss_count;
+    counts.model_miss_count += other.model_miss_count;
+}
+
+int cache_sim_analysis(const global_data_t& global_data,
+        const sim_config_t& config, sim_result_t& result) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const int num_streams = global_data.stream_list.size();
+
+    int code = 0;
+    result.var_counts.assign(num_streams, sim_counts_t());
+
+    // The simulator reports geometry and counters on stdout by default.
+    const int verbose = cache_sim_get_verbose();
+    cache_sim_set_verbose(0);
+
+    // Each window of each thread is replayed through a cache of its own,
+    // so windows are independent and can be simulated in parallel.
+    #pragma omp parallel for
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+
+        sim_result_t local_result;
+        local_result.var_counts.assign(num_streams, sim_counts_t());
+
+        std::map<int, std::vector<size_t> > core_index_map;
+        for (int j=0; j<list.size(); j++) {
+            const mem_info_t& mem_info = list.at(j);
+            if (mem_info.var_idx < num_streams) {
+                core_index_map[mem_info.coreID].push_back(j);
+            }
+        }
+
+        int local_code = 0;
+        for (std::map<int, std::vector<size_t> >::iterator it =
+                core_index_map.begin(); it != core_index_map.end() &&
+                local_code == 0; it++) {
+            local_code = replay_trace(list, it->second, config, local_result);
+        }
+
+        #pragma omp critical
+        {
+            if (local_code < 0) {
+                code = local_code;
+            }
+
+            for (int j=0; j<num_streams; j++) {
+                add_counts(result.var_counts[j], local_result.var_counts[j]);
+            }
+
+            for (std::map<size_t, sim_counts_t>::iterator it =
+                    local_result.line_counts.begin();
+                    it != local_result.line_counts.end(); it++) {
+                add_counts(result.line_counts[it->first], it->second);
+            }
+        }
+    }
+
+    cache_sim_set_verbose(verbose);
+    return code;
+}
+
+static double miss_ratio(size_t miss_count, size_t access_count) {
+    return access_count == 0 ? 0 : (double) miss_count / access_count;
+}
+
+static double model_error(const sim_counts_t& counts) {
+    double error = miss_ratio(counts.simulated_miss_count,
+            counts.access_count) - miss_ratio(counts.model_miss_count,
+            counts.access_count);
+    return error < 0 ? -error : error;
+}
+
+static bool compare_error(const std::pair<size_t, sim_counts_t>& a,
+        const std::pair<size_t, sim_counts_t>& b) {
+    return model_error(a.second) > model_error(b.second);
+}
+
+int print_cache_sim(const global_data_t& global_data,
+        const sim_config_t& config, const sim_result_t& result, bool bot) {
+    const int num_streams = global_data.stream_list.size();
+
+    std::vector<std::pair<size_t, sim_counts_t> > line_list(
+            result.line_counts.begin(), result.line_counts.end());
+    std::sort(line_list.begin(), line_list.end(), compare_error);
+
+    std::cout << std::endl;
+
+    if (bot == false) {
+        std::cout << macpoprefix << "Simulated " << config.size <<
+            "-byte " << config.associativity << "-way " << config.policy <<
+            " cache with " << config.line_size << "-byte lines:" << std::endl;
+
+        for (int i=0; i<num_streams; i++) {
+            const sim_counts_t& counts = result.var_counts[i];
+            if (counts.access_count == 0) {
+                continue;
+            }
+
+            std::cout << "var: " << global_data.stream_list[i] <<
+                ", simulated miss ratio: " << 100.0 *
+                miss_ratio(counts.simulated_miss_count, counts.access_count) <<
+                "%, reuse distance model: " << 100.0 *
+                miss_ratio(counts.model_miss_count, counts.access_count) <<
+                "%." << std::endl;
+        }
+
+        size_t limit = std::min((size_t) CACHE_SIM_LINE_COUNT,
+                line_list.size());
+        for (size_t i=0; i<limit; i++) {
+            const sim_counts_t& counts = line_list[i].second;
+            if (model_error(counts) == 0) {
+                break;
+            }
+
+            std::cout << "line " << line_list[i].first <<
+                ": simulated miss ratio: " << 100.0 *
+                miss_ratio(counts.simulated_miss_count, counts.access_count) <<
+                "%, reuse distance model: " << 100.0 *
+                miss_ratio(counts.model_miss_count, counts.access_count) <<
+                "%." << std::endl;
+        }
+    } else {
+        for (int i=0; i<num_streams; i++) {
+            const sim_counts_t& counts = result.var_counts[i];
+            const std::string& var_name = global_data.stream_list[i];
+
+            std::cout << MSG_CACHE_SIM << "." << var_name << "." <<
+                MSG_SIMULATED_MISS_RATIO << "=" <<
+                miss_ratio(counts.simulated_miss_count, counts.access_count) <<
+                std::endl;
+            std::cout << MSG_CACHE_SIM << "." << var_name << "." <<
+                MSG_MODEL_MISS_RATIO << "=" <<
+                miss_ratio(counts.model_miss_count, counts.access_count) <<
+                std::endl;
+        }
+
+        for (size_t i=0; i<line_list.size(); i++) {
+            const sim_counts_t& counts = line_list[i].second;
+
+            std::cout << MSG_CACHE_SIM << "." << MSG_SOURCE_LINE << "." <<
+                line_list[i].first << "." <<
+                MSG_SIMULATED_MISS_RATIO << "=" <<
+                miss_ratio(counts.simulated_miss_count, counts.access_count) <<
+                std::endl;
+            std::cout << MSG_CACHE_SIM << "." << MSG_SOURCE_LINE << "." <<
+                line_list[i].first << "." <<
+                MSG_MODEL_MISS_RATIO << "=" <<
+                miss_ratio(counts.model_miss_count, counts.access_count) <<
+                std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
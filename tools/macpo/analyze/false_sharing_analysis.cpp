@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <bitset>
+#include <iostream>
+#include <map>
+#include <set>
+
+#include "false_sharing_analysis.h"
+#include "record_io.h"
+
+typedef std::bitset<FALSE_SHARING_MAX_LINE_SIZE> byte_mask_t;
+
+typedef struct {
+    byte_mask_t read_mask;
+    byte_mask_t write_mask;
+    std::set<size_t> var_set;
+    std::set<size_t> line_number_set;
+} thread_access_t;
+
+typedef std::map<int, thread_access_t> thread_access_map_t;
+typedef std::map<size_t, thread_access_map_t> line_access_map_t;
+
+static size_t get_line_size(const global_data_t& global_data) {
+    size_t line_size = global_data.l1_data.line_size;
+    if (line_size == 0 || line_size > FALSE_SHARING_MAX_LINE_SIZE) {
+        return 64;
+    }
+
+    return line_size;
+}
+
+static size_t first_byte(const byte_mask_t& mask) {
+    for (size_t i=0; i<mask.size(); i++) {
+        if (mask.test(i)) {
+            return i;
+        }
+    }
+
+    return mask.size();
+}
+
+// Returns true if some thread writes bytes that another thread touches,
+// i.e. if the line is truly shared.
+static bool overlapping_writes(const thread_access_map_t& access_map) {
+    for (thread_access_map_t::const_iterator it = access_map.begin();
+            it != access_map.end(); it++) {
+        thread_access_map_t::const_iterator jt = it;
+        for (jt++; jt != access_map.end(); jt++) {
+            const thread_access_t& a = it->second;
+            const thread_access_t& b = jt->second;
+
+            if ((a.write_mask & (b.read_mask | b.write_mask)).any() ||
+                    (b.write_mask & (a.read_mask | a.write_mask)).any()) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Returns true if the line moves between caches, i.e. if some of the
+// threads do not share an L1 cache (as SMT siblings do).
+static bool crosses_caches(const global_data_t& global_data,
+        const thread_access_map_t& access_map) {
+    for (thread_access_map_t::const_iterator it = access_map.begin();
+            it != access_map.end(); it++) {
+        thread_access_map_t::const_iterator jt = it;
+        for (jt++; jt != access_map.end(); jt++) {
+            if (get_shared_cache_level(global_data, it->first,
+                        jt->first) != 1) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+int false_sharing_analysis(const global_data_t& global_data,
+        false_sharing_list_t& false_sharing_list) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const int num_streams = global_data.stream_list.size();
+    const size_t line_size = get_line_size(global_data);
+
+    false_sharing_list.resize(num_streams);
+    for (int i=0; i<num_streams; i++) {
+        false_sharing_list[i].line_count = 0;
+        false_sharing_list[i].cross_cache_line_count = 0;
+    }
+
+    line_access_map_t line_map;
+
+    #pragma omp parallel for
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+        line_access_map_t local_map;
+
+        for (int j=0; j<list.size(); j++) {
+            const mem_info_t& mem_info = list.at(j);
+            if (mem_info.var_idx >= num_streams) {
+                continue;
+            }
+
+            const size_t cache_line = mem_info.address / line_size;
+            const size_t offset = mem_info.address % line_size;
+            const size_t type_size = mem_info.type_size <= 0 ? 1 :
+                mem_info.type_size;
+
+            thread_access_t& access = local_map[cache_line][mem_info.coreID];
+            access.var_set.insert(mem_info.var_idx);
+            access.line_number_set.insert(mem_info.line_number);
+
+            // Accesses that spill into the next line are clipped.
+            for (size_t k=offset; k<offset+type_size && k<line_size; k++) {
+                if (mem_info.read_write == TYPE_READ ||
+                        mem_info.read_write == TYPE_READ_AND_WRITE) {
+                    access.read_mask.set(k);
+                }
+
+                if (mem_info.read_write == TYPE_WRITE ||
+                        mem_info.read_write == TYPE_READ_AND_WRITE) {
+                    access.write_mask.set(k);
+                }
+            }
+        }
+
+        #pragma omp critical
+        for (line_access_map_t::iterator it = local_map.begin();
+                it != local_map.end(); it++) {
+            thread_access_map_t& access_map = line_map[it->first];
+            for (thread_access_map_t::iterator jt = it->second.begin();
+                    jt != it->second.end(); jt++) {
+                thread_access_t& access = access_map[jt->first];
+                access.read_mask |= jt->second.read_mask;
+                access.write_mask |= jt->second.write_mask;
+                access.var_set.insert(jt->second.var_set.begin(),
+                        jt->second.var_set.end());
+                access.line_number_set.insert(
+                        jt->second.line_number_set.begin(),
+                        jt->second.line_number_set.end());
+            }
+        }
+    }
+
+    for (line_access_map_t::iterator it = line_map.begin();
+            it != line_map.end(); it++) {
+        const thread_access_map_t& access_map = it->second;
+        if (access_map.size() < 2) {
+            continue;
+        }
+
+        bool written = false;
+        for (thread_access_map_t::const_iterator jt = access_map.begin();
+                jt != access_map.end(); jt++) {
+            written |= jt->second.write_mask.any();
+        }
+
+        // False sharing: several threads, at least one writer,
+        // and no thread writing bytes that another one touches.
+        if (written == false || overlapping_writes(access_map)) {
+            continue;
+        }
+
+        // The distance between the byte ranges of neighbouring threads
+        // gives the size of the per-thread element.
+        std::set<size_t> start_set;
+        std::set<size_t> var_set;
+        for (thread_access_map_t::const_iterator jt = access_map.begin();
+                jt != access_map.end(); jt++) {
+            start_set.insert(first_byte(jt->second.read_mask |
+                        jt->second.write_mask));
+            var_set.insert(jt->second.var_set.begin(),
+                    jt->second.var_set.end());
+        }
+
+        const bool cross_cache = crosses_caches(global_data, access_map);
+
+        size_t stride = line_size;
+        std::set<size_t>::iterator st = start_set.begin();
+        for (std::set<size_t>::iterator nt = st; ++nt != start_set.end();
+                st = nt) {
+            stride = std::min(stride, *nt - *st);
+        }
+
+        for (std::set<size_t>::iterator vt = var_set.begin();
+                vt != var_set.end(); vt++) {
+            false_sharing_t& false_sharing = false_sharing_list[*vt];
+            false_sharing.line_count += 1;
+            false_sharing.stride_count[stride] += 1;
+            if (cross_cache) {
+                false_sharing.cross_cache_line_count += 1;
+            }
+
+            for (thread_access_map_t::const_iterator jt = access_map.begin();
+                    jt != access_map.end(); jt++) {
+                if (jt->second.var_set.find(*vt) !=
+                        jt->second.var_set.end()) {
+                    false_sharing.thread_set.insert(jt->first);
+                    false_sharing.line_number_set.insert(
+                            jt->second.line_number_set.begin(),
+                            jt->second.line_number_set.end());
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+int print_false_sharing(const global_data_t& global_data,
+        const false_sharing_list_t& false_sharing_list, bool bot) {
+    const int num_streams = global_data.stream_list.size();
+    const size_t line_size = get_line_size(global_data);
+
+    std::cout << std::endl;
+
+    if (bot == false) {
+        std::cout << macpoprefix << "False sharing:" << std::endl;
+    }
+
+    for (int i=0; i<num_streams; i++) {
+        const false_sharing_t& false_sharing = false_sharing_list[i];
+        if (false_sharing.line_count == 0) {
+            continue;
+        }
+
+        // Suggest padding for the most common per-thread element size.
+        size_t stride = line_size, stride_count = 0;
+        for (std::map<size_t, size_t>::const_iterator it =
+                false_sharing.stride_count.begin();
+                it != false_sharing.stride_count.end(); it++) {
+            if (it->second > stride_count) {
+                stride = it->first;
+                stride_count = it->second;
+            }
+        }
+
+        size_t padding = stride == 0 ? 0 :
+            (line_size - stride % line_size) % line_size;
+
+        if (bot == false) {
+            std::cout << "var: " << global_data.stream_list[i] << ", " <<
+                false_sharing.line_count << " falsely shared cache lines " <<
+                "(threads:";
+
+            for (std::set<int>::const_iterator it =
+                    false_sharing.thread_set.begin();
+                    it != false_sharing.thread_set.end(); it++) {
+                std::cout << " " << get_core_id(global_data, *it);
+            }
+
+            std::cout << ", source lines:";
+            for (std::set<size_t>::const_iterator it =
+                    false_sharing.line_number_set.begin();
+                    it != false_sharing.line_number_set.end(); it++) {
+                std::cout << " " << *it;
+            }
+
+            std::cout << "), each thread uses " << stride << " bytes; pad "
+                "each element with " << padding << " bytes so that it fills "
+                "a " << line_size << "-byte cache line." << std::endl;
+
+            if (false_sharing.cross_cache_line_count <
+                    false_sharing.line_count) {
+                std::cout << "only " << false_sharing.cross_cache_line_count <<
+                    " of these lines move between caches, the others are "
+                    "shared by threads on the same L1 cache." << std::endl;
+            }
+        } else {
+            const std::string& var_name = global_data.stream_list[i];
+            std::cout << MSG_FALSE_SHARING << "." << var_name << "." <<
+                MSG_FALSE_SHARING_LINES << "=" << false_sharing.line_count <<
+                std::endl;
+            std::cout << MSG_FALSE_SHARING << "." << var_name << "." <<
+                MSG_FALSE_SHARING_STRIDE << "=" << stride << std::endl;
+            std::cout << MSG_FALSE_SHARING << "." << var_name << "." <<
+                MSG_FALSE_SHARING_PADDING << "=" << padding << std::endl;
+            std::cout << MSG_FALSE_SHARING << "." << var_name << "." <<
+                MSG_FALSE_SHARING_CROSS_CACHE << "=" <<
+                false_sharing.cross_cache_line_count << std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
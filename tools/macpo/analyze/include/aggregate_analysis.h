@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef AGGREGATE_ANALYSIS_H_
+#define AGGREGATE_ANALYSIS_H_
+
+#include "analysis_defs.h"
+
+static const char* MSG_AGGREGATE = "aggregate";
+
+static const char* MSG_READ_COUNT = "read_count";
+static const char* MSG_WRITE_COUNT = "write_count";
+static const char* MSG_BYTE_COUNT = "byte_count";
+static const char* MSG_FOOTPRINT = "footprint";
+
+int print_aggregate_records(const global_data_t& global_data, bool bot);
+
+#endif  /* AGGREGATE_ANALYSIS_H_ */
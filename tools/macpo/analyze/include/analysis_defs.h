@@ -22,6 +22,7 @@
 #ifndef ANALYSIS_DEFS_H_
 #define ANALYSIS_DEFS_H_
 
+#include <map>
 #include <vector>
 #include <gsl/gsl_histogram.h>
 
@@ -35,6 +36,11 @@ typedef gsl_histogram histogram_t;
 typedef std::vector<mem_info_list_t> mem_info_bucket_t;
 typedef std::vector<trace_info_list_t> trace_info_bucket_t;
 typedef std::vector<vector_stride_info_list_t> vector_stride_info_bucket_t;
+typedef std::vector<aggregate_info_t> aggregate_info_list_t;
+typedef std::vector<alloc_site_info_t> alloc_site_info_list_t;
+typedef std::vector<region_info_t> region_info_list_t;
+typedef std::map<size_t, int> page_node_map_t;
+typedef std::vector<core_info_t> core_info_list_t;
 
 typedef std::vector<histogram_t*> histogram_list_t;
 typedef std::vector<histogram_list_t> histogram_matrix_t;
@@ -51,12 +57,27 @@ typedef struct {
     size_t size, line_size, associativity, count;
 } cache_data_t;
 
+typedef struct {
+    size_t entries_4k, entries_2m;
+} tlb_data_t;
+
 typedef struct {
     cache_data_t l1_data, l2_data, l3_data;
+    tlb_data_t dtlb_data, stlb_data;
+    bool target_caches, target_tlbs;    /* Geometry came from the trace. */
+    core_info_list_t core_info_list;
+    int_list_t core_id_list;    /* Trace core ID of each dense core index. */
+    int_list_t core_socket_list;
+    int_list_t core_node_list;  /* NUMA node of each trace core ID. */
+    int_list_t core_cache_list[3];  /* L1-L3 instance of each trace core ID. */
+    page_node_map_t page_node_map;
     name_list_t stream_list;
     mem_info_bucket_t mem_info_bucket;
     trace_info_bucket_t trace_info_bucket;
     vector_stride_info_bucket_t vector_stride_info_bucket;
+    aggregate_info_list_t aggregate_info_list;
+    alloc_site_info_list_t alloc_site_info_list;
+    region_info_list_t region_info_list;
 } global_data_t;
 
 typedef struct {
@@ -69,6 +90,15 @@ typedef struct {
 #define ANALYSIS_PREFETCH_STREAMS   (1 << 2)
 #define ANALYSIS_STRIDES            (1 << 3)
 #define ANALYSIS_VECTOR_STRIDES     (1 << 4)
+#define ANALYSIS_SHARING            (1 << 5)
+#define ANALYSIS_FALSE_SHARING      (1 << 6)
+#define ANALYSIS_PAGES              (1 << 7)
+#define ANALYSIS_PHASES             (1 << 8)
+#define ANALYSIS_WORKING_SETS       (1 << 9)
+#define ANALYSIS_CACHE_SIM          (1 << 10)
+#define ANALYSIS_LAYOUT             (1 << 11)
+#define ANALYSIS_REGIONS            (1 << 12)
+#define ANALYSIS_NUMA               (1 << 13)
 
 #define ANALYSIS_ALL                (~0)
 
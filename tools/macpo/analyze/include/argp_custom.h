@@ -26,7 +26,7 @@
 
 struct arg_info {
     float threshold;
-    char *arg1, *arg2, *location;
+    char *arg1, *arg2, *location, *cache_sim, *what_if, *rank;
     bool bot, showDebug, stream_names;
 };
 
@@ -26,6 +26,8 @@
 
 int load_cache_info(global_data_t& global_data);
 
+int load_tlb_info(global_data_t& global_data);
+
 int update_cache_fields(cache_data_t& cache_data, size_t cache_level,
         size_t cache_size, size_t line_size, size_t associativity);
 
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef CACHE_SIM_ANALYSIS_H_
+#define CACHE_SIM_ANALYSIS_H_
+
+#include <map>
+#include <string>
+
+#include "analysis_defs.h"
+
+/* Number of source lines to display, ordered by model error. */
+#define CACHE_SIM_LINE_COUNT    5
+
+static const char* MSG_CACHE_SIM = "cache_sim";
+
+static const char* MSG_SOURCE_LINE = "line";
+static const char* MSG_SIMULATED_MISS_RATIO = "simulated_miss_ratio";
+static const char* MSG_MODEL_MISS_RATIO = "model_miss_ratio";
+
+typedef struct {
+    size_t size, line_size, associativity;
+    std::string policy;
+} sim_config_t;
+
+typedef struct {
+    size_t access_count;
+    size_t simulated_miss_count;
+    size_t model_miss_count;    /* from fully associative reuse distances */
+} sim_counts_t;
+
+typedef struct {
+    std::vector<sim_counts_t> var_counts;
+    std::map<size_t, sim_counts_t> line_counts;
+} sim_result_t;
+
+int parse_sim_config(const global_data_t& global_data, const char* arg,
+        sim_config_t& config);
+
+int cache_sim_analysis(const global_data_t& global_data,
+        const sim_config_t& config, sim_result_t& result);
+
+int print_cache_sim(const global_data_t& global_data,
+        const sim_config_t& config, const sim_result_t& result, bool bot);
+
+#endif  /* CACHE_SIM_ANALYSIS_H_ */
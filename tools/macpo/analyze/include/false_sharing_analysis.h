@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef FALSE_SHARING_ANALYSIS_H_
+#define FALSE_SHARING_ANALYSIS_H_
+
+#include <map>
+#include <set>
+
+#include "analysis_defs.h"
+
+/* Largest cache line size for which byte ranges can be tracked. */
+#define FALSE_SHARING_MAX_LINE_SIZE 256
+
+static const char* MSG_FALSE_SHARING = "false_sharing";
+
+static const char* MSG_FALSE_SHARING_LINES = "line_count";
+static const char* MSG_FALSE_SHARING_STRIDE = "element_stride";
+static const char* MSG_FALSE_SHARING_PADDING = "padding";
+static const char* MSG_FALSE_SHARING_CROSS_CACHE = "cross_cache_lines";
+
+typedef struct {
+    size_t line_count;
+    size_t cross_cache_line_count;  /* lines not confined to a shared L1 */
+    std::set<int> thread_set;
+    std::set<size_t> line_number_set;
+    std::map<size_t, size_t> stride_count;  /* per-thread stride, in bytes */
+} false_sharing_t;
+
+typedef std::vector<false_sharing_t> false_sharing_list_t;
+
+int false_sharing_analysis(const global_data_t& global_data,
+        false_sharing_list_t& false_sharing_list);
+
+int print_false_sharing(const global_data_t& global_data,
+        const false_sharing_list_t& false_sharing_list, bool bot);
+
+#endif  /* FALSE_SHARING_ANALYSIS_H_ */
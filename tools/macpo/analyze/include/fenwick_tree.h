@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef FENWICK_TREE_H_
+#define FENWICK_TREE_H_
+
+#include <cstddef>
+#include <vector>
+
+// Binary indexed tree over the positions of an access sequence. Callers
+// keep a mark at the position of the most recent access to each address,
+// so the number of marks after the previous access to an address is the
+// number of distinct addresses touched since, i.e. its reuse distance.
+class fenwick_tree_t {
+ public:
+    explicit fenwick_tree_t(size_t size) : tree(size + 1, 0) {
+    }
+
+    void add(size_t index, int value) {
+        for (index += 1; index < tree.size(); index += index & -index) {
+            tree[index] += value;
+        }
+    }
+
+    size_t prefix_sum(size_t index) const {
+        size_t sum = 0;
+        for (index += 1; index > 0; index -= index & -index) {
+            sum += tree[index];
+        }
+
+        return sum;
+    }
+
+ private:
+    std::vector<int> tree;
+};
+
+#endif  /* FENWICK_TREE_H_ */
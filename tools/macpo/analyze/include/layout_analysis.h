@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef LAYOUT_ANALYSIS_H_
+#define LAYOUT_ANALYSIS_H_
+
+#include <string>
+
+#include "analysis_defs.h"
+#include "cache_sim_analysis.h"
+
+/* Candidate layouts: the variable is shifted by 0..LAYOUT_MAX_OFFSET-1
+   cache lines and, if it has rows, each row is padded by one of the
+   LAYOUT_PADDINGS line counts. */
+#define LAYOUT_MAX_OFFSET   16
+
+static const size_t LAYOUT_PADDINGS[] = { 0, 1, 2, 3, 4, 8 };
+
+/* Number of candidates to display. */
+#define LAYOUT_CANDIDATE_COUNT  5
+
+static const char* MSG_LAYOUT = "layout";
+
+static const char* MSG_OFFSET_LINES = "offset_lines";
+static const char* MSG_PADDING_LINES = "padding_lines";
+static const char* MSG_CONFLICT_MISSES = "conflict_misses";
+
+typedef struct {
+    size_t var_idx;
+    size_t row_bytes;   /* 0 if the variable has no rows */
+} layout_target_t;
+
+typedef struct {
+    size_t offset_lines;
+    size_t padding_lines;
+    size_t conflict_count;      /* conflict misses over all variables */
+    size_t var_conflict_count;  /* conflict misses of the target variable */
+} layout_candidate_t;
+
+typedef std::vector<layout_candidate_t> layout_candidate_list_t;
+
+int parse_layout_target(const global_data_t& global_data, const char* arg,
+        layout_target_t& target);
+
+int layout_analysis(const global_data_t& global_data,
+        const sim_config_t& config, const layout_target_t& target,
+        layout_candidate_list_t& candidate_list);
+
+int print_layout_candidates(const global_data_t& global_data,
+        const layout_target_t& target,
+        const layout_candidate_list_t& candidate_list, bool bot);
+
+#endif  /* LAYOUT_ANALYSIS_H_ */
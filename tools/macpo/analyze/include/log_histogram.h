@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef LOG_HISTOGRAM_H_
+#define LOG_HISTOGRAM_H_
+
+#include <map>
+#include <utility>
+
+/* Number of bins per power of two. */
+#define LOG_HISTOGRAM_SUB_BITS  3
+#define LOG_HISTOGRAM_SUB_BINS  (1 << LOG_HISTOGRAM_SUB_BITS)
+
+// Sparse histogram over non-negative values with a constant number of bins
+// per power of two. Every bin keeps the total weight and the weighted sum of
+// its values, and every power of two starts a new bin, so tail sums taken at
+// a power of two are exact.
+class log_histogram_t {
+ public:
+    void add(size_t value, double weight = 1) {
+        bin_t& bin = bins[bin_index(value)];
+        bin.first += weight;
+        bin.second += weight * value;
+    }
+
+    void merge(const log_histogram_t& other) {
+        for (bin_map_t::const_iterator it = other.bins.begin();
+                it != other.bins.end(); it++) {
+            bin_t& bin = bins[it->first];
+            bin.first += it->second.first;
+            bin.second += it->second.second;
+        }
+    }
+
+    // Total weight and weighted sum of all values that are at least `limit'.
+    // Exact when `limit' is zero or a power of two.
+    std::pair<double, double> tail(size_t limit) const {
+        std::pair<double, double> result(0, 0);
+        for (bin_map_t::const_iterator it = bins.lower_bound(bin_index(limit));
+                it != bins.end(); it++) {
+            result.first += it->second.first;
+            result.second += it->second.second;
+        }
+
+        return result;
+    }
+
+    size_t size() const {
+        return bins.size();
+    }
+
+ private:
+    typedef std::pair<double, double> bin_t;
+    typedef std::map<int, bin_t> bin_map_t;
+
+    static int bin_index(size_t value) {
+        if (value < LOG_HISTOGRAM_SUB_BINS)
+            return value;
+
+        int log = 0;
+        while ((value >> log) >= 2 * LOG_HISTOGRAM_SUB_BINS)
+            log += 1;
+
+        // `value >> log' now lies in [SUB_BINS, 2 * SUB_BINS).
+        return LOG_HISTOGRAM_SUB_BINS * (log + 1) +
+            (value >> log) - LOG_HISTOGRAM_SUB_BINS;
+    }
+
+    bin_map_t bins;
+};
+
+#endif  /* LOG_HISTOGRAM_H_ */
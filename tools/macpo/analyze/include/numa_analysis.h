@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef NUMA_ANALYSIS_H_
+#define NUMA_ANALYSIS_H_
+
+#include <map>
+#include <vector>
+
+#include "analysis_defs.h"
+
+/* Number of source lines to display, ordered by remote accesses. */
+#define NUMA_LINE_COUNT     5
+
+/* A variable has a first-touch problem if it is used from several nodes,
+   at least this share of its pages sit on one node, and at least
+   NUMA_REMOTE_THRESHOLD of its accesses are remote. */
+#define NUMA_PLACEMENT_THRESHOLD    0.9
+#define NUMA_REMOTE_THRESHOLD       0.25
+
+static const char* MSG_NUMA = "numa";
+
+static const char* MSG_NUMA_LINE = "line";
+static const char* MSG_REMOTE_RATIO = "remote_ratio";
+static const char* MSG_FIRST_TOUCH = "first_touch_problem";
+
+typedef struct {
+    size_t local_count, remote_count;
+    std::map<int, size_t> page_node_count;  /* pages per node */
+    std::map<int, size_t> core_node_count;  /* accesses per accessing node */
+} numa_stats_t;
+
+typedef struct {
+    std::vector<numa_stats_t> var_stats;
+    std::map<size_t, numa_stats_t> line_stats;
+} numa_result_t;
+
+int numa_analysis(const global_data_t& global_data, numa_result_t& result);
+
+int print_numa_placement(const global_data_t& global_data,
+        const numa_result_t& result, bool bot);
+
+#endif  /* NUMA_ANALYSIS_H_ */
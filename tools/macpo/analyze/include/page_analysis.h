@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef PAGE_ANALYSIS_H_
+#define PAGE_ANALYSIS_H_
+
+#include <map>
+#include <set>
+
+#include "analysis_defs.h"
+
+#define PAGE_SHIFT_4K   12
+#define PAGE_SHIFT_2M   21
+
+/* Miss ratio above which TLB misses are worth reporting. */
+#define TLB_MISS_THRESHOLD  0.05
+
+static const char* MSG_PAGE_ANALYSIS = "page_analysis";
+
+static const char* MSG_FOOTPRINT_4K = "footprint_4k";
+static const char* MSG_FOOTPRINT_2M = "footprint_2m";
+static const char* MSG_DTLB_MISS_RATIO_4K = "dtlb_miss_ratio_4k";
+static const char* MSG_STLB_MISS_RATIO_4K = "stlb_miss_ratio_4k";
+static const char* MSG_DTLB_MISS_RATIO_2M = "dtlb_miss_ratio_2m";
+static const char* MSG_STLB_MISS_RATIO_2M = "stlb_miss_ratio_2m";
+static const char* MSG_LINES_PER_PAGE = "lines_per_page";
+
+typedef struct {
+    size_t access_count;
+    size_t dtlb_miss_count;
+    size_t stlb_miss_count;
+    std::set<size_t> page_set;
+} page_stats_t;
+
+typedef struct {
+    page_stats_t stats_4k, stats_2m;
+    std::set<size_t> cache_line_set;
+    std::map<size_t, size_t> line_miss_count;  /* STLB misses by source line */
+} page_profile_t;
+
+typedef std::vector<page_profile_t> page_profile_list_t;
+
+int page_analysis(const global_data_t& global_data,
+        page_profile_list_t& profile_list);
+
+int print_page_analysis(const global_data_t& global_data,
+        const page_profile_list_t& profile_list, bool bot);
+
+#endif  /* PAGE_ANALYSIS_H_ */
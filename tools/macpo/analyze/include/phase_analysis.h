@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef PHASE_ANALYSIS_H_
+#define PHASE_ANALYSIS_H_
+
+#include <map>
+
+#include "analysis_defs.h"
+
+/* Bins used for each part of a window signature. */
+#define PHASE_LINE_BINS     16
+#define PHASE_STRIDE_BINS   4
+#define PHASE_REUSE_BINS    12
+#define PHASE_SIGNATURE_SIZE    \
+    (PHASE_LINE_BINS + PHASE_STRIDE_BINS + PHASE_REUSE_BINS)
+
+/* Maximum L1 distance between a window and the phase it joins.
+   Each of the three parts of a signature contributes at most 2. */
+#define PHASE_THRESHOLD     0.75
+#define PHASE_MAX           16
+
+/* Number of source lines to display for each phase. */
+#define PHASE_LINE_COUNT    3
+
+static const char* MSG_PHASE_ANALYSIS = "phase_analysis";
+
+static const char* MSG_WINDOWS = "windows";
+static const char* MSG_ACCESS_SHARE = "access_share";
+static const char* MSG_HOT_LINES = "hot_lines";
+static const char* MSG_ACCESSES = "accesses";
+static const char* MSG_MEAN_REUSE_DISTANCE = "mean_reuse_distance";
+static const char* MSG_COLD_RATIO = "cold_ratio";
+static const char* MSG_UNIT_STRIDE_RATIO = "unit_stride_ratio";
+
+typedef std::vector<double> signature_t;
+
+typedef struct {
+    size_t access_count;
+    size_t reuse_count;         /* accesses with a finite reuse distance */
+    size_t reuse_distance_sum;
+    size_t stride_count;
+    size_t unit_stride_count;
+} phase_var_stats_t;
+
+typedef struct {
+    signature_t centroid;
+    int_list_t window_list;
+    size_t access_count;
+    std::map<size_t, size_t> line_count;
+    std::vector<phase_var_stats_t> var_stats;
+} phase_t;
+
+typedef std::vector<phase_t> phase_list_t;
+
+int phase_analysis(const global_data_t& global_data, phase_list_t& phase_list);
+
+int print_phases(const global_data_t& global_data,
+        const phase_list_t& phase_list, bool bot);
+
+#endif  /* PHASE_ANALYSIS_H_ */
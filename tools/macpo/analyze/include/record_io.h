@@ -37,7 +37,19 @@ static const char* MSG_METADATA_INFO = "metadata_info";
 static const char* MSG_BINARY_NAME = "binary_name";
 static const char* MSG_TIMESTAMP = "timestamp";
 
+static const char* MSG_ALLOC_SITE = "alloc_site";
+
+static const char* MSG_ALLOC_COUNT = "alloc_count";
+static const char* MSG_ALLOC_BYTES = "alloc_bytes";
+
+int get_core_id(const global_data_t& global_data, int core_idx);
+
+/* Lowest cache level shared by two cores, 0 if none (or if the trace has no
+ * topology records). */
+int get_shared_cache_level(const global_data_t& global_data, int core_idx_a,
+        int core_idx_b);
 int print_trace_records(const global_data_t& global_data);
-int read_file(const char* filename, global_data_t& global_data, bool bot);
+int read_file(const char* filename, global_data_t& global_data, bool bot,
+        int rank);
 
 #endif  /* RECORD_IO_H_ */
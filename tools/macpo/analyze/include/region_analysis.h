@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef REGION_ANALYSIS_H_
+#define REGION_ANALYSIS_H_
+
+#include <vector>
+
+#include "analysis_defs.h"
+
+static const char* MSG_REGION = "region";
+
+static const char* MSG_SERIAL = "serial";
+static const char* MSG_ACCESS_COUNT = "access_count";
+static const char* MSG_THREAD_COUNT = "thread_count";
+static const char* MSG_IMBALANCE = "imbalance";
+static const char* MSG_L1_MISS_RATIO = "l1_miss_ratio";
+static const char* MSG_L2_MISS_RATIO = "l2_miss_ratio";
+
+typedef struct {
+    size_t access_count;
+    size_t l1_miss_count, l2_miss_count;
+    std::vector<size_t> thread_access_list;    /* indexed by thread number */
+} region_stats_t;
+
+/* Index 0 holds serial code, index i+1 holds parallel region i. */
+typedef std::vector<region_stats_t> region_stats_list_t;
+
+int region_analysis(const global_data_t& global_data,
+        region_stats_list_t& region_stats_list);
+
+int print_regions(const global_data_t& global_data,
+        const region_stats_list_t& region_stats_list, bool bot);
+
+#endif  /* REGION_ANALYSIS_H_ */
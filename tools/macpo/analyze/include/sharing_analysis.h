@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef SHARING_ANALYSIS_H_
+#define SHARING_ANALYSIS_H_
+
+#include <map>
+
+#include "analysis_defs.h"
+
+/* Number of thread pairs to display in the sharing matrix. */
+#define SHARING_PAIR_COUNT  16
+
+static const char* MSG_SHARING = "sharing";
+static const char* MSG_PLACEMENT = "placement";
+
+static const char* MSG_SHARING_MATRIX = "matrix";
+static const char* MSG_PRIVATE_LINES = "private_lines";
+static const char* MSG_READ_SHARED_LINES = "read_shared_lines";
+static const char* MSG_WRITE_SHARED_LINES = "write_shared_lines";
+static const char* MSG_CROSS_SOCKET_LINES = "cross_socket_lines";
+static const char* MSG_CURRENT_CROSS_SOCKET = "current_cross_socket_lines";
+static const char* MSG_SUGGESTED_CROSS_SOCKET = "suggested_cross_socket_lines";
+static const char* MSG_CORE = "core";
+
+/* Number of cache lines shared by each pair of threads (lower ID first). */
+typedef std::map<pair_t, size_t> sharing_matrix_t;
+
+typedef struct {
+    size_t private_lines;
+    size_t read_shared_lines;
+    size_t write_shared_lines;
+    size_t cross_socket_lines;
+} sharing_profile_t;
+
+typedef std::vector<sharing_profile_t> sharing_profile_list_t;
+
+int sharing_analysis(const global_data_t& global_data,
+        sharing_matrix_t& sharing_matrix,
+        sharing_profile_list_t& profile_list);
+
+int print_sharing_analysis(const global_data_t& global_data,
+        const sharing_matrix_t& sharing_matrix,
+        const sharing_profile_list_t& profile_list, bool bot);
+
+#endif  /* SHARING_ANALYSIS_H_ */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef WORKING_SET_ANALYSIS_H_
+#define WORKING_SET_ANALYSIS_H_
+
+#include "analysis_defs.h"
+#include "log_histogram.h"
+
+/* Window lengths, in accesses, at which footprints are reported:
+   1K, 4K, 16K, ..., 1G. */
+#define WORKING_SET_MIN_SHIFT   10
+#define WORKING_SET_MAX_SHIFT   30
+#define WORKING_SET_STEP_SHIFT  2
+
+static const char* MSG_WORKING_SET = "working_set";
+
+typedef struct {
+    // Reuse times and the distances of first and last accesses from the
+    // ends of their window, which together determine the footprint.
+    log_histogram_t gap_histogram;
+    // Lengths of windows, weighted by the number of distinct lines touched.
+    log_histogram_t line_histogram;
+} working_set_t;
+
+typedef std::vector<working_set_t> working_set_list_t;
+
+int working_set_analysis(const global_data_t& global_data,
+        working_set_list_t& working_set_list,
+        log_histogram_t& window_histogram);
+
+int print_working_sets(const global_data_t& global_data,
+        const working_set_list_t& working_set_list,
+        const log_histogram_t& window_histogram, bool bot);
+
+#endif  /* WORKING_SET_ANALYSIS_H_ */
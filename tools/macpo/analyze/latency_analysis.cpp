@@ -242,7 +242,7 @@ int latency_analysis(const global_data_t& global_data,
         histogram_list_t& rd_list, double_list_t& conflict_list,
         const int DIST_INFINITY) {
     const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
-    const int num_cores = sysconf(_SC_NPROCESSORS_CONF);
+    const int num_cores = global_data.core_id_list.size();
     const int num_streams = global_data.stream_list.size();
 
     int_list_t hit_list;
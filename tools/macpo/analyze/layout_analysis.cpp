@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+#include "err_codes.h"
+#include "fenwick_tree.h"
+#include "layout_analysis.h"
+#include "lib/cache_sim/cache_sim.h"
+
+// Guesses the row pitch of a variable as its most frequent stride that
+// spans more than one cache line.
+static size_t infer_row_bytes(const global_data_t& global_data,
+        size_t var_idx, size_t line_size) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    std::map<size_t, size_t> stride_count;
+
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+        std::map<int, size_t> last_address;
+
+        for (int j=0; j<list.size(); j++) {
+            const mem_info_t& mem_info = list.at(j);
+            if (mem_info.var_idx != var_idx) {
+                continue;
+            }
+
+            std::map<int, size_t>::iterator it =
+                last_address.find(mem_info.coreID);
+            if (it != last_address.end() && mem_info.address > it->second &&
+                    mem_info.address - it->second > line_size) {
+                stride_count[mem_info.address - it->second] += 1;
+            }
+
+            last_address[mem_info.coreID] = mem_info.address;
+        }
+    }
+
+    size_t row_bytes = 0, max_count = 0;
+    for (std::map<size_t, size_t>::iterator it = stride_count.begin();
+            it != stride_count.end(); it++) {
+        if (it->second > max_count) {
+            row_bytes = it->first;
+            max_count = it->second;
+        }
+    }
+
+    return row_bytes;
+}
+
+int parse_layout_target(const global_data_t& global_data, const char* arg,
+        layout_target_t& target) {
+    char var_name[STREAM_LENGTH] = {0};
+    target.row_bytes = 0;
+
+    const char* comma = strchr(arg, ',');
+    size_t length = comma == NULL ? strlen(arg) : comma - arg;
+    strncpy(var_name, arg, std::min(length, (size_t) STREAM_LENGTH - 1));
+
+    const name_list_t& stream_list = global_data.stream_list;
+    name_list_t::const_iterator it = std::find(stream_list.begin(),
+            stream_list.end(), var_name);
+    if (it == stream_list.end()) {
+        return -ERR_INV_DATA;
+    }
+
+    target.var_idx = it - stream_list.begin();
+
+    if (comma != NULL) {
+        if (sscanf(comma + 1, "%zu", &target.row_bytes) != 1) {
+            return -ERR_INV_DATA;
+        }
+    } else {
+        target.row_bytes = infer_row_bytes(global_data, target.var_idx,
+                global_data.l1_data.line_size != 0 ?
+                global_data.l1_data.line_size : 64);
+    }
+
+    return 0;
+}
+
+static size_t relocate(size_t address, size_t base,
+        const layout_target_t& target, const layout_candidate_t& candidate,
+        size_t line_size) {
+    size_t offset = address - base;
+
+    if (target.row_bytes != 0) {
+        size_t row = offset / target.row_bytes;
+        size_t column = offset % target.row_bytes;
+        offset = row * (target.row_bytes + candidate.padding_lines *
+                line_size) + column;
+    }
+
+    return base + candidate.offset_lines * line_size + offset;
+}
+
+// Replays the trace with the target variable moved according to the
+// candidate layout, and counts the misses of the set-associative cache that
+// a fully associative cache of the same size would not have had.
+static int replay_candidate(const global_data_t& global_data,
+        const sim_config_t& config, const layout_target_t& target,
+        size_t base, layout_candidate_t& candidate) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const size_t total_lines = config.size / config.line_size;
+
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+
+        std::map<int, std::vector<size_t> > core_index_map;
+        for (int j=0; j<list.size(); j++) {
+            core_index_map[list.at(j).coreID].push_back(j);
+        }
+
+        for (std::map<int, std::vector<size_t> >::iterator it =
+                core_index_map.begin(); it != core_index_map.end(); it++) {
+            const std::vector<size_t>& index_list = it->second;
+
+            cache_handle_t* cache = cache_sim_init(config.size,
+                    config.line_size, config.associativity,
+                    config.policy.c_str());
+            if (cache == NULL) {
+                return -ERR_INV_CACHE;
+            }
+
+            fenwick_tree_t tree(index_list.size());
+            std::map<size_t, size_t> last_access;
+
+            for (size_t j=0; j<index_list.size(); j++) {
+                const mem_info_t& mem_info = list.at(index_list[j]);
+                size_t address = mem_info.address;
+                if (mem_info.var_idx == target.var_idx) {
+                    address = relocate(address, base, target, candidate,
+                            config.line_size);
+                }
+
+                const size_t cache_line = address / config.line_size;
+                int rc = cache_sim_access(cache, address);
+
+                size_t distance = SIZE_MAX;
+                std::map<size_t, size_t>::iterator jt =
+                    last_access.find(cache_line);
+                if (jt != last_access.end()) {
+                    distance = tree.prefix_sum(j) -
+                        tree.prefix_sum(jt->second);
+                    tree.add(jt->second, -1);
+                }
+
+                tree.add(j, 1);
+                last_access[cache_line] = j;
+
+                if ((rc & CACHE_SIM_L1_MISS) && distance < total_lines) {
+                    candidate.conflict_count += 1;
+                    if (mem_info.var_idx == target.var_idx) {
+                        candidate.var_conflict_count += 1;
+                    }
+                }
+            }
+
+            cache_sim_fini(cache);
+        }
+    }
+
+    return 0;
+}
+
+static bool compare_conflicts(const layout_candidate_t& a,
+        const layout_candidate_t& b) {
+    if (a.conflict_count != b.conflict_count)
+        return a.conflict_count < b.conflict_count;
+
+    // Prefer the cheaper layout among equals.
+    if (a.padding_lines != b.padding_lines)
+        return a.padding_lines < b.padding_lines;
+    return a.offset_lines < b.offset_lines;
+}
+
+int layout_analysis(const global_data_t& global_data,
+        const sim_config_t& config, const layout_target_t& target,
+        layout_candidate_list_t& candidate_list) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+
+    // Addresses are relocated relative to the lowest one seen.
+    size_t base = SIZE_MAX;
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+        for (int j=0; j<list.size(); j++) {
+            if (list.at(j).var_idx == target.var_idx) {
+                base = std::min(base, (size_t) list.at(j).address);
+            }
+        }
+    }
+
+    if (base == SIZE_MAX) {
+        return 0;
+    }
+
+    const int num_paddings = target.row_bytes == 0 ? 1 :
+        sizeof(LAYOUT_PADDINGS) / sizeof(LAYOUT_PADDINGS[0]);
+    for (int i=0; i<num_paddings; i++) {
+        for (size_t j=0; j<LAYOUT_MAX_OFFSET; j++) {
+            layout_candidate_t candidate = { j, LAYOUT_PADDINGS[i], 0, 0 };
+            candidate_list.push_back(candidate);
+        }
+    }
+
+    const int verbose = cache_sim_get_verbose();
+    cache_sim_set_verbose(0);
+
+    // All candidates read the same trace, so they can be replayed at once.
+    int code = 0;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i=0; i<candidate_list.size(); i++) {
+        int local_code = replay_candidate(global_data, config, target, base,
+                candidate_list[i]);
+
+        if (local_code < 0) {
+            #pragma omp critical
+            code = local_code;
+        }
+    }
+
+    cache_sim_set_verbose(verbose);
+    return code;
+}
+
+int print_layout_candidates(const global_data_t& global_data,
+        const layout_target_t& target,
+        const layout_candidate_list_t& candidate_list, bool bot) {
+    if (candidate_list.size() == 0) {
+        return 0;
+    }
+
+    // The first candidate is the unchanged layout.
+    const layout_candidate_t baseline = candidate_list[0];
+    const std::string& var_name = global_data.stream_list[target.var_idx];
+
+    layout_candidate_list_t sorted_list(candidate_list);
+    std::sort(sorted_list.begin(), sorted_list.end(), compare_conflicts);
+
+    std::cout << std::endl;
+
+    size_t limit = std::min((size_t) LAYOUT_CANDIDATE_COUNT,
+            sorted_list.size());
+
+    if (bot == false) {
+        std::cout << macpoprefix << "What-if layouts for var: " << var_name;
+        if (target.row_bytes != 0) {
+            std::cout << " (rows of " << target.row_bytes << " bytes)";
+        }
+
+        std::cout << ", current layout: " << baseline.conflict_count <<
+            " conflict misses (" << baseline.var_conflict_count << " on " <<
+            var_name << ")." << std::endl;
+
+        for (size_t i=0; i<limit; i++) {
+            const layout_candidate_t& candidate = sorted_list[i];
+            std::cout << "shift by " << candidate.offset_lines << " lines";
+            if (target.row_bytes != 0) {
+                std::cout << ", pad rows by " << candidate.padding_lines <<
+                    " lines";
+            }
+
+            std::cout << ": " << candidate.conflict_count <<
+                " conflict misses (" << candidate.var_conflict_count <<
+                " on " << var_name << ")." << std::endl;
+        }
+    } else {
+        for (size_t i=0; i<limit; i++) {
+            const layout_candidate_t& candidate = sorted_list[i];
+            std::cout << MSG_LAYOUT << "." << var_name << "." << i << "." <<
+                MSG_OFFSET_LINES << "=" << candidate.offset_lines << std::endl;
+            std::cout << MSG_LAYOUT << "." << var_name << "." << i << "." <<
+                MSG_PADDING_LINES << "=" << candidate.padding_lines <<
+                std::endl;
+            std::cout << MSG_LAYOUT << "." << var_name << "." << i << "." <<
+                MSG_CONFLICT_MISSES << "=" << candidate.conflict_count <<
+                std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -20,7 +20,9 @@
  */
 
 #include <cassert>
+#include <cstdlib>
 
+#include "aggregate_analysis.h"
 #include "argp_custom.h"
 #include "cache_info.h"
 #include "err_codes.h"
@@ -45,18 +47,35 @@ int main(int argc, char *argv[]) {
         info.location = info.arg2;
     }
 
-    if ((code = load_cache_info(global_data)) < 0) {
-        std::cerr << "Failed to load cache information, terminating." <<
+    int rank = info.rank == NULL ? -1 : atoi(info.rank);
+    if ((code = read_file(info.location, global_data, info.bot, rank)) < 0) {
+        std::cerr << "Failed to read records from file, terminating." <<
             std::endl;
 
         return code;
     }
 
-    if ((code = read_file(info.location, global_data, info.bot)) < 0) {
-        std::cerr << "Failed to read records from file, terminating." <<
-            std::endl;
+    // Prefer the geometry recorded on the machine that produced the trace,
+    // and only probe the local machine for traces that lack it.
+    if (global_data.target_caches == false) {
+        if ((code = load_cache_info(global_data)) < 0) {
+            std::cerr << "Failed to load cache information, terminating." <<
+                std::endl;
 
-        return code;
+            return code;
+        }
+    } else if (info.bot == false) {
+        std::cout << macpoprefix << "Using the cache geometry recorded in the "
+            "trace." << std::endl;
+    }
+
+    if (global_data.target_tlbs == false) {
+        if ((code = load_tlb_info(global_data)) < 0) {
+            std::cerr << "Failed to load TLB information, terminating." <<
+                std::endl;
+
+            return code;
+        }
     }
 
     if (global_data.mem_info_bucket.size() ||
@@ -82,6 +101,12 @@ int main(int argc, char *argv[]) {
                 std::endl;
             return code;
         }
+    } else if (global_data.aggregate_info_list.size()) {
+        if ((code = print_aggregate_records(global_data, info.bot)) < 0) {
+            std::cerr << "Failed to print aggregate records, terminating." <<
+                std::endl;
+            return code;
+        }
     }
 
     return 0;
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+
+#include "histogram.h"
+#include "numa_analysis.h"
+#include "record_io.h"
+
+static int get_numa_node(const global_data_t& global_data, int core_idx) {
+    const int_list_t& core_node_list = global_data.core_node_list;
+    const int core_id = get_core_id(global_data, core_idx);
+    if (core_id >= 0 && core_id < core_node_list.size()) {
+        return core_node_list[core_id];
+    }
+
+    return 0;
+}
+
+static void add_stats(numa_stats_t& dst, const numa_stats_t& src) {
+    dst.local_count += src.local_count;
+    dst.remote_count += src.remote_count;
+
+    for (std::map<int, size_t>::const_iterator it =
+            src.page_node_count.begin(); it != src.page_node_count.end();
+            it++) {
+        dst.page_node_count[it->first] += it->second;
+    }
+
+    for (std::map<int, size_t>::const_iterator it =
+            src.core_node_count.begin(); it != src.core_node_count.end();
+            it++) {
+        dst.core_node_count[it->first] += it->second;
+    }
+}
+
+static double get_remote_ratio(const numa_stats_t& stats) {
+    size_t total = stats.local_count + stats.remote_count;
+    return total == 0 ? 0 : stats.remote_count / static_cast<double>(total);
+}
+
+// Returns the node holding most pages of the variable, and its share.
+static std::pair<int, double> get_home_node(const numa_stats_t& stats) {
+    size_t page_count = 0, max_count = 0;
+    int home_node = 0;
+
+    for (std::map<int, size_t>::const_iterator it =
+            stats.page_node_count.begin(); it != stats.page_node_count.end();
+            it++) {
+        page_count += it->second;
+        if (it->second > max_count) {
+            home_node = it->first;
+            max_count = it->second;
+        }
+    }
+
+    return std::make_pair(home_node,
+            page_count == 0 ? 0 : max_count / static_cast<double>(page_count));
+}
+
+static bool has_first_touch_problem(const numa_stats_t& stats) {
+    // Data that was initialized by one thread ends up on a single node,
+    // even though the threads that use it run on all nodes.
+    return stats.core_node_count.size() > 1 &&
+        get_home_node(stats).second >= NUMA_PLACEMENT_THRESHOLD &&
+        get_remote_ratio(stats) >= NUMA_REMOTE_THRESHOLD;
+}
+
+int numa_analysis(const global_data_t& global_data, numa_result_t& result) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const page_node_map_t& page_node_map = global_data.page_node_map;
+    const size_t num_streams = global_data.stream_list.size();
+
+    result.var_stats.assign(num_streams, numa_stats_t());
+    result.line_stats.clear();
+
+    std::vector<std::set<size_t> > var_page_list(num_streams);
+
+    #pragma omp parallel for
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+
+        std::vector<numa_stats_t> var_stats(num_streams);
+        std::map<size_t, numa_stats_t> line_stats;
+        std::vector<std::set<size_t> > var_pages(num_streams);
+
+        for (int j=0; j<list.size(); j++) {
+            const mem_info_t& mem_info = list.at(j);
+            if (mem_info.var_idx >= num_streams) {
+                continue;
+            }
+
+            // Pages whose node could not be resolved are not counted.
+            const size_t page = mem_info.address >> 12;
+            page_node_map_t::const_iterator it = page_node_map.find(page);
+            if (it == page_node_map.end()) {
+                continue;
+            }
+
+            const int page_node = it->second;
+            const int core_node = get_numa_node(global_data,
+                    mem_info.coreID);
+
+            numa_stats_t* stats_list[] = { &var_stats[mem_info.var_idx],
+                &line_stats[mem_info.line_number] };
+            for (int k=0; k<2; k++) {
+                if (page_node == core_node)
+                    stats_list[k]->local_count += 1;
+                else
+                    stats_list[k]->remote_count += 1;
+
+                stats_list[k]->core_node_count[core_node] += 1;
+            }
+
+            var_pages[mem_info.var_idx].insert(page);
+        }
+
+        #pragma omp critical
+        {
+            for (int j=0; j<num_streams; j++) {
+                add_stats(result.var_stats[j], var_stats[j]);
+                var_page_list[j].insert(var_pages[j].begin(),
+                        var_pages[j].end());
+            }
+
+            for (std::map<size_t, numa_stats_t>::iterator it =
+                    line_stats.begin(); it != line_stats.end(); it++) {
+                add_stats(result.line_stats[it->first], it->second);
+            }
+        }
+    }
+
+    // Pages are counted once per variable, not once per access.
+    for (int i=0; i<num_streams; i++) {
+        const std::set<size_t>& page_set = var_page_list[i];
+        for (std::set<size_t>::const_iterator it = page_set.begin();
+                it != page_set.end(); it++) {
+            result.var_stats[i].page_node_count[
+                page_node_map.find(*it)->second] += 1;
+        }
+    }
+
+    return 0;
+}
+
+int print_numa_placement(const global_data_t& global_data,
+        const numa_result_t& result, bool bot) {
+    if (global_data.page_node_map.size() == 0) {
+        if (bot == false) {
+            std::cout << macpoprefix << "The trace has no NUMA placement "
+                "records, set MACPO_NUMA when running the program." <<
+                std::endl;
+        }
+
+        return 0;
+    }
+
+    std::cout << std::endl;
+
+    for (int i=0; i<result.var_stats.size(); i++) {
+        const numa_stats_t& stats = result.var_stats[i];
+        if (stats.local_count + stats.remote_count == 0) {
+            continue;
+        }
+
+        const std::string& var_name = global_data.stream_list[i];
+        const std::pair<int, double> home_node = get_home_node(stats);
+        const bool first_touch = has_first_touch_problem(stats);
+
+        if (bot == false) {
+            std::cout << macpoprefix << "var: " << var_name <<
+                ", remote accesses: " << 100.0 * get_remote_ratio(stats) <<
+                "%, pages on node " << home_node.first << ": " <<
+                100.0 * home_node.second << "%." << std::endl;
+
+            if (first_touch) {
+                std::cout << macpoprefix << "var: " << var_name <<
+                    " is used from " << stats.core_node_count.size() <<
+                    " nodes but placed on node " << home_node.first <<
+                    ", initialize it in parallel with the same schedule as "
+                    "the loops that use it, so that first-touch places each "
+                    "page near its user." << std::endl;
+            }
+        } else {
+            std::cout << MSG_NUMA << "." << var_name << "." <<
+                MSG_REMOTE_RATIO << "=" << get_remote_ratio(stats) <<
+                std::endl;
+            std::cout << MSG_NUMA << "." << var_name << "." <<
+                MSG_FIRST_TOUCH << "=" << first_touch << std::endl;
+        }
+    }
+
+    // Source lines with the most remote accesses.
+    pair_list_t pair_list;
+    for (std::map<size_t, numa_stats_t>::const_iterator it =
+            result.line_stats.begin(); it != result.line_stats.end(); it++) {
+        if (it->second.remote_count > 0) {
+            pair_list.push_back(pair_t(it->first, it->second.remote_count));
+        }
+    }
+
+    std::sort(pair_list.begin(), pair_list.end(), pair_sort);
+
+    size_t limit = std::min((size_t) NUMA_LINE_COUNT, pair_list.size());
+    for (int i=0; i<limit; i++) {
+        const size_t line_number = pair_list[i].first;
+        const numa_stats_t& stats = result.line_stats.find(line_number)->second;
+
+        if (bot == false) {
+            std::cout << macpoprefix << "line " << line_number <<
+                ": remote accesses: " << 100.0 * get_remote_ratio(stats) <<
+                "%." << std::endl;
+        } else {
+            std::cout << MSG_NUMA << "." << MSG_NUMA_LINE << "." << line_number <<
+                "." << MSG_REMOTE_RATIO << "=" << get_remote_ratio(stats) <<
+                std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <iostream>
+#include <map>
+#include <set>
+
+#include "fenwick_tree.h"
+#include "page_analysis.h"
+
+static void simulate_tlb(const mem_info_list_t& list,
+        const std::vector<size_t>& index_list, int page_shift,
+        size_t dtlb_entries, size_t stlb_entries,
+        page_profile_list_t& profile_list) {
+    fenwick_tree_t tree(index_list.size());
+    std::map<size_t, size_t> last_access;
+
+    for (size_t i=0; i<index_list.size(); i++) {
+        const mem_info_t& mem_info = list.at(index_list[i]);
+        const size_t page = mem_info.address >> page_shift;
+
+        // Cold accesses count as misses in both levels.
+        size_t distance = SIZE_MAX;
+        std::map<size_t, size_t>::iterator it = last_access.find(page);
+        if (it != last_access.end()) {
+            distance = tree.prefix_sum(i) - tree.prefix_sum(it->second);
+            tree.add(it->second, -1);
+        }
+
+        tree.add(i, 1);
+        last_access[page] = i;
+
+        page_profile_t& profile = profile_list[mem_info.var_idx];
+        page_stats_t& stats = page_shift == PAGE_SHIFT_4K ? profile.stats_4k :
+            profile.stats_2m;
+
+        stats.access_count += 1;
+        stats.page_set.insert(page);
+
+        if (distance >= dtlb_entries) {
+            stats.dtlb_miss_count += 1;
+        }
+
+        if (distance >= dtlb_entries + stlb_entries) {
+            stats.stlb_miss_count += 1;
+
+            if (page_shift == PAGE_SHIFT_4K) {
+                profile.line_miss_count[mem_info.line_number] += 1;
+            }
+        }
+    }
+}
+
+int page_analysis(const global_data_t& global_data,
+        page_profile_list_t& profile_list) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const int num_streams = global_data.stream_list.size();
+    const tlb_data_t& dtlb_data = global_data.dtlb_data;
+    const tlb_data_t& stlb_data = global_data.stlb_data;
+
+    profile_list.resize(num_streams);
+
+    #pragma omp parallel for
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+
+        page_profile_list_t local_list;
+        local_list.resize(num_streams);
+
+        // Each core has a TLB of its own, so split the window by core.
+        std::map<int, std::vector<size_t> > core_index_map;
+        for (int j=0; j<list.size(); j++) {
+            const mem_info_t& mem_info = list.at(j);
+            if (mem_info.var_idx < num_streams) {
+                core_index_map[mem_info.coreID].push_back(j);
+                local_list[mem_info.var_idx].cache_line_set.insert(
+                        ADDR_TO_CACHE_LINE(mem_info.address));
+            }
+        }
+
+        for (std::map<int, std::vector<size_t> >::iterator it =
+                core_index_map.begin(); it != core_index_map.end(); it++) {
+            simulate_tlb(list, it->second, PAGE_SHIFT_4K,
+                    dtlb_data.entries_4k, stlb_data.entries_4k, local_list);
+            simulate_tlb(list, it->second, PAGE_SHIFT_2M,
+                    dtlb_data.entries_2m, stlb_data.entries_2m, local_list);
+        }
+
+        #pragma omp critical
+        for (int j=0; j<num_streams; j++) {
+            page_profile_t& profile = profile_list[j];
+            const page_profile_t& local = local_list[j];
+
+            page_stats_t* stats[] = { &profile.stats_4k, &profile.stats_2m };
+            const page_stats_t* local_stats[] = { &local.stats_4k,
+                &local.stats_2m };
+
+            for (int k=0; k<2; k++) {
+                stats[k]->access_count += local_stats[k]->access_count;
+                stats[k]->dtlb_miss_count += local_stats[k]->dtlb_miss_count;
+                stats[k]->stlb_miss_count += local_stats[k]->stlb_miss_count;
+                stats[k]->page_set.insert(local_stats[k]->page_set.begin(),
+                        local_stats[k]->page_set.end());
+            }
+
+            profile.cache_line_set.insert(local.cache_line_set.begin(),
+                    local.cache_line_set.end());
+
+            for (std::map<size_t, size_t>::const_iterator it =
+                    local.line_miss_count.begin();
+                    it != local.line_miss_count.end(); it++) {
+                profile.line_miss_count[it->first] += it->second;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static double miss_ratio(size_t miss_count, size_t access_count) {
+    return access_count == 0 ? 0 : (double) miss_count / access_count;
+}
+
+int print_page_analysis(const global_data_t& global_data,
+        const page_profile_list_t& profile_list, bool bot) {
+    const int num_streams = global_data.stream_list.size();
+    const tlb_data_t& dtlb_data = global_data.dtlb_data;
+    const tlb_data_t& stlb_data = global_data.stlb_data;
+
+    std::cout << std::endl;
+
+    if (bot == false) {
+        std::cout << macpoprefix << "TLB reach: " <<
+            (dtlb_data.entries_4k + stlb_data.entries_4k) * 4 << " KB with "
+            "4 KB pages, " << (dtlb_data.entries_2m + stlb_data.entries_2m) *
+            2 << " MB with 2 MB pages." << std::endl;
+    }
+
+    for (int i=0; i<num_streams; i++) {
+        const page_profile_t& profile = profile_list[i];
+        const page_stats_t& stats_4k = profile.stats_4k;
+        const page_stats_t& stats_2m = profile.stats_2m;
+
+        if (stats_4k.access_count == 0) {
+            continue;
+        }
+
+        const double dtlb_4k = miss_ratio(stats_4k.dtlb_miss_count,
+                stats_4k.access_count);
+        const double stlb_4k = miss_ratio(stats_4k.stlb_miss_count,
+                stats_4k.access_count);
+        const double dtlb_2m = miss_ratio(stats_2m.dtlb_miss_count,
+                stats_2m.access_count);
+        const double stlb_2m = miss_ratio(stats_2m.stlb_miss_count,
+                stats_2m.access_count);
+        const double lines_per_page = (double) profile.cache_line_set.size() /
+            stats_4k.page_set.size();
+
+        if (bot == false) {
+            std::cout << "var: " << global_data.stream_list[i] <<
+                ", 4 KB pages: " << stats_4k.page_set.size() << " (DTLB miss " <<
+                100.0 * dtlb_4k << "%, STLB miss " << 100.0 * stlb_4k <<
+                "%), 2 MB pages: " << stats_2m.page_set.size() <<
+                " (DTLB miss " << 100.0 * dtlb_2m << "%, STLB miss " <<
+                100.0 * stlb_2m << "%), " << lines_per_page <<
+                " cache lines used per 4 KB page." << std::endl;
+
+            if (stlb_4k < TLB_MISS_THRESHOLD) {
+                continue;
+            }
+
+            // Find the source line that suffers the most.
+            size_t worst_line = 0, worst_count = 0;
+            for (std::map<size_t, size_t>::const_iterator it =
+                    profile.line_miss_count.begin();
+                    it != profile.line_miss_count.end(); it++) {
+                if (it->second > worst_count) {
+                    worst_line = it->first;
+                    worst_count = it->second;
+                }
+            }
+
+            if (stlb_2m < stlb_4k / 2) {
+                std::cout << "  Backing " << global_data.stream_list[i] <<
+                    " with transparent huge pages (madvise(MADV_HUGEPAGE)) "
+                    "would remove most of its TLB misses";
+            } else {
+                std::cout << "  Huge pages would not help much, consider "
+                    "re-laying out " << global_data.stream_list[i] <<
+                    " so that consecutive accesses stay within fewer pages";
+            }
+
+            if (lines_per_page < 8) {
+                std::cout << "; the data is sparse, compacting it would "
+                    "shrink its page footprint";
+            }
+
+            std::cout << " (most misses at line " << worst_line << ")." <<
+                std::endl;
+        } else {
+            const std::string& var_name = global_data.stream_list[i];
+            std::cout << MSG_PAGE_ANALYSIS << "." << var_name << "." <<
+                MSG_FOOTPRINT_4K << "=" << stats_4k.page_set.size() <<
+                std::endl;
+            std::cout << MSG_PAGE_ANALYSIS << "." << var_name << "." <<
+                MSG_FOOTPRINT_2M << "=" << stats_2m.page_set.size() <<
+                std::endl;
+            std::cout << MSG_PAGE_ANALYSIS << "." << var_name << "." <<
+                MSG_DTLB_MISS_RATIO_4K << "=" << dtlb_4k << std::endl;
+            std::cout << MSG_PAGE_ANALYSIS << "." << var_name << "." <<
+                MSG_STLB_MISS_RATIO_4K << "=" << stlb_4k << std::endl;
+            std::cout << MSG_PAGE_ANALYSIS << "." << var_name << "." <<
+                MSG_DTLB_MISS_RATIO_2M << "=" << dtlb_2m << std::endl;
+            std::cout << MSG_PAGE_ANALYSIS << "." << var_name << "." <<
+                MSG_STLB_MISS_RATIO_2M << "=" << stlb_2m << std::endl;
+            std::cout << MSG_PAGE_ANALYSIS << "." << var_name << "." <<
+                MSG_LINES_PER_PAGE << "=" << lines_per_page << std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
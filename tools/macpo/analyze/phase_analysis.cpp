@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "fenwick_tree.h"
+#include "histogram.h"
+#include "phase_analysis.h"
+
+typedef struct {
+    signature_t signature;
+    size_t access_count;
+    std::map<size_t, size_t> line_count;
+    std::vector<phase_var_stats_t> var_stats;
+} window_t;
+
+static int stride_bin(size_t last_line, size_t cache_line) {
+    const size_t stride = cache_line > last_line ? cache_line - last_line :
+        last_line - cache_line;
+
+    if (stride == 0)    return 0;
+    if (stride == 1)    return 1;
+    if (stride < 8)     return 2;
+    return 3;
+}
+
+static int reuse_bin(size_t distance) {
+    int bin = 0;
+    while (distance > 0 && bin < PHASE_REUSE_BINS - 2) {
+        distance >>= 1;
+        bin += 1;
+    }
+
+    return bin;
+}
+
+static void normalize(signature_t& signature, int start, int count) {
+    double sum = 0;
+    for (int i=start; i<start+count; i++) {
+        sum += signature[i];
+    }
+
+    if (sum > 0) {
+        for (int i=start; i<start+count; i++) {
+            signature[i] /= sum;
+        }
+    }
+}
+
+static void build_window(const mem_info_list_t& list, int num_streams,
+        window_t& window) {
+    signature_t& signature = window.signature;
+    signature.assign(PHASE_SIGNATURE_SIZE, 0);
+
+    window.access_count = 0;
+    window.var_stats.assign(num_streams, phase_var_stats_t());
+
+    // Reuse distances and strides are tracked for each core separately.
+    std::map<int, std::vector<size_t> > core_index_map;
+    for (int i=0; i<list.size(); i++) {
+        const mem_info_t& mem_info = list.at(i);
+        if (mem_info.var_idx < num_streams) {
+            core_index_map[mem_info.coreID].push_back(i);
+        }
+    }
+
+    for (std::map<int, std::vector<size_t> >::iterator it =
+            core_index_map.begin(); it != core_index_map.end(); it++) {
+        const std::vector<size_t>& index_list = it->second;
+
+        fenwick_tree_t tree(index_list.size());
+        std::map<size_t, size_t> last_access;
+        std::map<size_t, size_t> last_var_line;
+
+        for (size_t i=0; i<index_list.size(); i++) {
+            const mem_info_t& mem_info = list.at(index_list[i]);
+            const size_t cache_line = ADDR_TO_CACHE_LINE(mem_info.address);
+            phase_var_stats_t& stats = window.var_stats[mem_info.var_idx];
+
+            window.access_count += 1;
+            window.line_count[mem_info.line_number] += 1;
+            stats.access_count += 1;
+
+            signature[mem_info.line_number % PHASE_LINE_BINS] += 1;
+
+            std::map<size_t, size_t>::iterator var_it =
+                last_var_line.find(mem_info.var_idx);
+            if (var_it != last_var_line.end()) {
+                int bin = stride_bin(var_it->second, cache_line);
+                signature[PHASE_LINE_BINS + bin] += 1;
+
+                stats.stride_count += 1;
+                if (bin == 1) {
+                    stats.unit_stride_count += 1;
+                }
+            }
+
+            last_var_line[mem_info.var_idx] = cache_line;
+
+            // The last reuse bin holds cold accesses.
+            std::map<size_t, size_t>::iterator line_it =
+                last_access.find(cache_line);
+            if (line_it != last_access.end()) {
+                size_t distance = tree.prefix_sum(i) -
+                    tree.prefix_sum(line_it->second);
+                tree.add(line_it->second, -1);
+
+                signature[PHASE_LINE_BINS + PHASE_STRIDE_BINS +
+                    reuse_bin(distance)] += 1;
+
+                stats.reuse_count += 1;
+                stats.reuse_distance_sum += distance;
+            } else {
+                signature[PHASE_SIGNATURE_SIZE - 1] += 1;
+            }
+
+            tree.add(i, 1);
+            last_access[cache_line] = i;
+        }
+    }
+
+    normalize(signature, 0, PHASE_LINE_BINS);
+    normalize(signature, PHASE_LINE_BINS, PHASE_STRIDE_BINS);
+    normalize(signature, PHASE_LINE_BINS + PHASE_STRIDE_BINS,
+            PHASE_REUSE_BINS);
+}
+
+static double distance(const signature_t& s1, const signature_t& s2) {
+    double sum = 0;
+    for (int i=0; i<PHASE_SIGNATURE_SIZE; i++) {
+        sum += fabs(s1[i] - s2[i]);
+    }
+
+    return sum;
+}
+
+int phase_analysis(const global_data_t& global_data, phase_list_t& phase_list) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const int num_streams = global_data.stream_list.size();
+
+    // Signatures are independent of each other, so build them in parallel.
+    std::vector<window_t> window_list(bucket.size());
+
+    #pragma omp parallel for
+    for (int i=0; i<bucket.size(); i++) {
+        build_window(bucket.at(i), num_streams, window_list[i]);
+    }
+
+    // Leader-follower clustering: visit windows in time order, join the
+    // nearest phase if it is close enough, otherwise start a new phase.
+    for (int i=0; i<window_list.size(); i++) {
+        const window_t& window = window_list[i];
+        if (window.access_count == 0) {
+            continue;
+        }
+
+        int nearest = -1;
+        double nearest_distance = 0;
+        for (int j=0; j<phase_list.size(); j++) {
+            double d = distance(phase_list[j].centroid, window.signature);
+            if (nearest < 0 || d < nearest_distance) {
+                nearest = j;
+                nearest_distance = d;
+            }
+        }
+
+        if (nearest < 0 || (nearest_distance > PHASE_THRESHOLD &&
+                    phase_list.size() < PHASE_MAX)) {
+            phase_t phase;
+            phase.centroid = window.signature;
+            phase.access_count = 0;
+            phase.var_stats.assign(num_streams, phase_var_stats_t());
+
+            phase_list.push_back(phase);
+            nearest = phase_list.size() - 1;
+        }
+
+        phase_t& phase = phase_list[nearest];
+        phase.window_list.push_back(i);
+
+        // Keep the centroid as the running mean of member signatures.
+        const double weight = 1.0 / phase.window_list.size();
+        for (int j=0; j<PHASE_SIGNATURE_SIZE; j++) {
+            phase.centroid[j] += weight *
+                (window.signature[j] - phase.centroid[j]);
+        }
+
+        phase.access_count += window.access_count;
+        for (std::map<size_t, size_t>::const_iterator it =
+                window.line_count.begin(); it != window.line_count.end();
+                it++) {
+            phase.line_count[it->first] += it->second;
+        }
+
+        for (int j=0; j<num_streams; j++) {
+            phase_var_stats_t& stats = phase.var_stats[j];
+            const phase_var_stats_t& window_stats = window.var_stats[j];
+
+            stats.access_count += window_stats.access_count;
+            stats.reuse_count += window_stats.reuse_count;
+            stats.reuse_distance_sum += window_stats.reuse_distance_sum;
+            stats.stride_count += window_stats.stride_count;
+            stats.unit_stride_count += window_stats.unit_stride_count;
+        }
+    }
+
+    return 0;
+}
+
+// Collapse sorted window indices into ranges, e.g. "0-3,7,9-12".
+static std::string window_spans(const int_list_t& window_list) {
+    std::stringstream stream;
+
+    for (int i=0; i<window_list.size(); i++) {
+        int j = i;
+        while (j+1 < window_list.size() &&
+                window_list[j+1] == window_list[j] + 1) {
+            j += 1;
+        }
+
+        if (i > 0) {
+            stream << ",";
+        }
+
+        stream << window_list[i];
+        if (j > i) {
+            stream << "-" << window_list[j];
+        }
+
+        i = j;
+    }
+
+    return stream.str();
+}
+
+static std::string hot_lines(const phase_t& phase) {
+    pair_list_t pair_list(phase.line_count.begin(), phase.line_count.end());
+    std::sort(pair_list.begin(), pair_list.end(), pair_sort);
+
+    std::stringstream stream;
+    for (int i=0; i<pair_list.size() && i<PHASE_LINE_COUNT; i++) {
+        if (i > 0) {
+            stream << ",";
+        }
+
+        stream << pair_list[i].first;
+    }
+
+    return stream.str();
+}
+
+int print_phases(const global_data_t& global_data,
+        const phase_list_t& phase_list, bool bot) {
+    const int num_streams = global_data.stream_list.size();
+
+    size_t total_accesses = 0;
+    for (int i=0; i<phase_list.size(); i++) {
+        total_accesses += phase_list[i].access_count;
+    }
+
+    std::cout << std::endl;
+
+    for (int i=0; i<phase_list.size(); i++) {
+        const phase_t& phase = phase_list[i];
+        const double access_share = total_accesses == 0 ? 0 :
+            (double) phase.access_count / total_accesses;
+
+        if (bot == false) {
+            std::cout << macpoprefix << "Phase " << i << ": " <<
+                phase.window_list.size() << " window(s) [" <<
+                window_spans(phase.window_list) << "], " <<
+                100.0 * access_share << "% of accesses, hot lines: " <<
+                hot_lines(phase) << "." << std::endl;
+        } else {
+            std::cout << MSG_PHASE_ANALYSIS << "." << i << "." << MSG_WINDOWS <<
+                "=" << window_spans(phase.window_list) << std::endl;
+            std::cout << MSG_PHASE_ANALYSIS << "." << i << "." <<
+                MSG_ACCESS_SHARE << "=" << access_share << std::endl;
+            std::cout << MSG_PHASE_ANALYSIS << "." << i << "." <<
+                MSG_HOT_LINES << "=" << hot_lines(phase) << std::endl;
+        }
+
+        for (int j=0; j<num_streams; j++) {
+            const phase_var_stats_t& stats = phase.var_stats[j];
+            if (stats.access_count == 0) {
+                continue;
+            }
+
+            const double mean_distance = stats.reuse_count == 0 ? 0 :
+                (double) stats.reuse_distance_sum / stats.reuse_count;
+            const double cold_ratio = 1.0 -
+                (double) stats.reuse_count / stats.access_count;
+            const double unit_ratio = stats.stride_count == 0 ? 0 :
+                (double) stats.unit_stride_count / stats.stride_count;
+
+            if (bot == false) {
+                std::cout << "  var: " << global_data.stream_list[j] <<
+                    ", accesses: " << stats.access_count <<
+                    ", mean reuse distance: " << mean_distance <<
+                    ", cold: " << 100.0 * cold_ratio << "%, unit stride: " <<
+                    100.0 * unit_ratio << "%." << std::endl;
+            } else {
+                const std::string& var_name = global_data.stream_list[j];
+                std::cout << MSG_PHASE_ANALYSIS << "." << i << "." <<
+                    var_name << "." << MSG_ACCESSES << "=" <<
+                    stats.access_count << std::endl;
+                std::cout << MSG_PHASE_ANALYSIS << "." << i << "." <<
+                    var_name << "." << MSG_MEAN_REUSE_DISTANCE << "=" <<
+                    mean_distance << std::endl;
+                std::cout << MSG_PHASE_ANALYSIS << "." << i << "." <<
+                    var_name << "." << MSG_COLD_RATIO << "=" << cold_ratio <<
+                    std::endl;
+                std::cout << MSG_PHASE_ANALYSIS << "." << i << "." <<
+                    var_name << "." << MSG_UNIT_STRIDE_RATIO << "=" <<
+                    unit_ratio << std::endl;
+            }
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -28,10 +28,19 @@
 #include "err_codes.h"
 #include "record_analysis.h"
 
+#include "cache_sim_analysis.h"
 #include "latency_analysis.h"
+#include "layout_analysis.h"
+#include "numa_analysis.h"
 #include "stride_analysis.h"
 #include "vector_stride_analysis.h"
+#include "false_sharing_analysis.h"
+#include "page_analysis.h"
+#include "phase_analysis.h"
+#include "region_analysis.h"
 #include "set_cache_conflict_analysis.h"
+#include "sharing_analysis.h"
+#include "working_set_analysis.h"
 
 int filter_low_freq_records(global_data_t& global_data) {
     mem_info_bucket_t& bucket = global_data.mem_info_bucket;
@@ -161,5 +170,164 @@ int analyze_records(const global_data_t& global_data, int analysis_flags,
         print_vector_strides(global_data, stride_list /*, info.bot */);
     }
 
+    if (analysis_flags & ANALYSIS_SHARING) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Analyzing records for data sharing "
+                "between threads." << std::endl;
+        }
+
+        sharing_matrix_t sharing_matrix;
+        sharing_profile_list_t profile_list;
+
+        if ((code = sharing_analysis(global_data, sharing_matrix,
+                        profile_list)) < 0)
+            return code;
+
+        print_sharing_analysis(global_data, sharing_matrix, profile_list,
+                info.bot);
+    }
+
+    if (analysis_flags & ANALYSIS_FALSE_SHARING) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Analyzing records for false sharing."
+                << std::endl;
+        }
+
+        false_sharing_list_t false_sharing_list;
+
+        if ((code = false_sharing_analysis(global_data,
+                        false_sharing_list)) < 0)
+            return code;
+
+        print_false_sharing(global_data, false_sharing_list, info.bot);
+    }
+
+    if (analysis_flags & ANALYSIS_PAGES) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Analyzing records for page-level "
+                "reuse." << std::endl;
+        }
+
+        page_profile_list_t page_profile_list;
+
+        if ((code = page_analysis(global_data, page_profile_list)) < 0)
+            return code;
+
+        print_page_analysis(global_data, page_profile_list, info.bot);
+    }
+
+    if (analysis_flags & ANALYSIS_PHASES) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Analyzing records for program "
+                "phases." << std::endl;
+        }
+
+        phase_list_t phase_list;
+
+        if ((code = phase_analysis(global_data, phase_list)) < 0)
+            return code;
+
+        print_phases(global_data, phase_list, info.bot);
+    }
+
+    if (analysis_flags & ANALYSIS_WORKING_SETS) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Analyzing records for working set "
+                "sizes." << std::endl;
+        }
+
+        working_set_list_t working_set_list;
+        log_histogram_t window_histogram;
+
+        if ((code = working_set_analysis(global_data, working_set_list,
+                        window_histogram)) < 0)
+            return code;
+
+        print_working_sets(global_data, working_set_list, window_histogram,
+                info.bot);
+    }
+
+    if (analysis_flags & ANALYSIS_REGIONS) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Analyzing records for OpenMP "
+                "regions." << std::endl;
+        }
+
+        region_stats_list_t region_stats_list;
+
+        if ((code = region_analysis(global_data, region_stats_list)) < 0)
+            return code;
+
+        print_regions(global_data, region_stats_list, info.bot);
+    }
+
+    if (analysis_flags & ANALYSIS_NUMA) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Analyzing records for NUMA "
+                "placement." << std::endl;
+        }
+
+        numa_result_t numa_result;
+
+        if ((code = numa_analysis(global_data, numa_result)) < 0)
+            return code;
+
+        print_numa_placement(global_data, numa_result, info.bot);
+    }
+
+    // Caches are only simulated if the user asked for a geometry, so that a
+    // trace without one still gets the remaining analyses.
+    if ((analysis_flags & ANALYSIS_CACHE_SIM) && info.cache_sim == NULL) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Skipping cache simulation, pass "
+                "--cache-sim to enable it." << std::endl;
+        }
+    } else if (analysis_flags & ANALYSIS_CACHE_SIM) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Simulating caches on the recorded "
+                "accesses." << std::endl;
+        }
+
+        sim_config_t sim_config;
+        sim_result_t sim_result;
+
+        if ((code = parse_sim_config(global_data, info.cache_sim,
+                        sim_config)) < 0)
+            return code;
+
+        if ((code = cache_sim_analysis(global_data, sim_config,
+                        sim_result)) < 0)
+            return code;
+
+        print_cache_sim(global_data, sim_config, sim_result, info.bot);
+    }
+
+    // What-if layouts are only evaluated for a variable named by the user.
+    if ((analysis_flags & ANALYSIS_LAYOUT) && info.what_if != NULL) {
+        if (info.bot == false) {
+            std::cout << macpoprefix << "Simulating alternative layouts." <<
+                std::endl;
+        }
+
+        sim_config_t sim_config;
+        layout_target_t layout_target;
+        layout_candidate_list_t candidate_list;
+
+        if ((code = parse_sim_config(global_data, info.cache_sim,
+                        sim_config)) < 0)
+            return code;
+
+        if ((code = parse_layout_target(global_data, info.what_if,
+                        layout_target)) < 0)
+            return code;
+
+        if ((code = layout_analysis(global_data, sim_config, layout_target,
+                        candidate_list)) < 0)
+            return code;
+
+        print_layout_candidates(global_data, layout_target, candidate_list,
+                info.bot);
+    }
+
     return 0;
 }
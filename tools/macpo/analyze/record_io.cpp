@@ -20,6 +20,8 @@
  */
 
 #include <cassert>
+#include <map>
+#include <set>
 
 #include "err_codes.h"
 #include "generic_defs.h"
@@ -110,6 +112,206 @@ static int handle_vector_stride_msg(const vector_stride_info_t& info,
     return 0;
 }
 
+static int handle_aggregate_msg(const aggregate_info_t& info,
+    global_data_t& global_data) {
+    global_data.aggregate_info_list.push_back(info);
+    return 0;
+}
+
+static int handle_cache_msg(const cache_info_t& info,
+    global_data_t& global_data) {
+    cache_data_t* cache_data = NULL;
+    switch (info.level) {
+        case 1: cache_data = &global_data.l1_data;  break;
+        case 2: cache_data = &global_data.l2_data;  break;
+        case 3: cache_data = &global_data.l3_data;  break;
+        default: return 0;
+    }
+
+    cache_data->size = info.size;
+    cache_data->line_size = info.line_size;
+    cache_data->associativity = info.associativity;
+    cache_data->count = info.count;
+
+    global_data.target_caches = true;
+    return 0;
+}
+
+static int handle_core_msg(const core_info_t& info,
+    global_data_t& global_data) {
+    global_data.core_info_list.push_back(info);
+
+    int_list_t& core_socket_list = global_data.core_socket_list;
+    if (info.coreID >= core_socket_list.size()) {
+        core_socket_list.resize(info.coreID + 1, 0);
+    }
+
+    core_socket_list[info.coreID] = info.socket;
+
+    int_list_t& core_node_list = global_data.core_node_list;
+    if (info.coreID >= core_node_list.size()) {
+        core_node_list.resize(info.coreID + 1, 0);
+    }
+
+    core_node_list[info.coreID] = info.numa_node;
+
+    for (int i=0; i<3; i++) {
+        int_list_t& core_cache_list = global_data.core_cache_list[i];
+        if (info.coreID >= core_cache_list.size()) {
+            core_cache_list.resize(info.coreID + 1, -1);
+        }
+
+        core_cache_list[info.coreID] = info.cache_id[i] == UINT16_MAX ? -1 :
+            info.cache_id[i];
+    }
+
+    return 0;
+}
+
+static int handle_tlb_msg(const tlb_info_t& info,
+    global_data_t& global_data) {
+    global_data.dtlb_data.entries_4k = info.dtlb_entries_4k;
+    global_data.dtlb_data.entries_2m = info.dtlb_entries_2m;
+    global_data.stlb_data.entries_4k = info.stlb_entries_4k;
+    global_data.stlb_data.entries_2m = info.stlb_entries_2m;
+
+    global_data.target_tlbs = true;
+    return 0;
+}
+
+static int handle_alloc_site_msg(const alloc_site_info_t& info,
+    global_data_t& global_data, bool bot) {
+    global_data.alloc_site_info_list.push_back(info);
+
+    if (bot == false) {
+        std::cout << macpoprefix << "Heap allocation site " << info.location <<
+            ": " << info.alloc_count << " allocations, " << info.alloc_bytes <<
+            " bytes." << std::endl;
+    } else {
+        std::cout << MSG_ALLOC_SITE << "." << info.location << "." <<
+            MSG_ALLOC_COUNT << "=" << info.alloc_count << std::endl;
+        std::cout << MSG_ALLOC_SITE << "." << info.location << "." <<
+            MSG_ALLOC_BYTES << "=" << info.alloc_bytes << std::endl;
+    }
+
+    return 0;
+}
+
+static int handle_page_msg(const page_info_t& info,
+    global_data_t& global_data) {
+    global_data.page_node_map[info.page] = info.numa_node;
+    return 0;
+}
+
+static int handle_region_msg(const region_info_t& info,
+    global_data_t& global_data) {
+    global_data.region_info_list.push_back(info);
+    return 0;
+}
+
+static int attribute_alloc_sites(global_data_t& global_data) {
+    const alloc_site_info_list_t& site_list = global_data.alloc_site_info_list;
+    if (site_list.size() == 0) {
+        return 0;
+    }
+
+    // Each allocation site becomes a stream of its own so that all
+    // per-variable analyses report heap objects by where they were
+    // allocated instead of by the pointer used to reach them.
+    size_t base_idx = global_data.stream_list.size();
+    for (int i=0; i<site_list.size(); i++) {
+        global_data.stream_list.push_back(std::string("heap@") +
+                site_list[i].location);
+    }
+
+    mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    for (int i=0; i<bucket.size(); i++) {
+        mem_info_list_t& list = bucket.at(i);
+
+        for (int j=0; j<list.size(); j++) {
+            mem_info_t& mem_info = list.at(j);
+            if (mem_info.alloc_site >= 0 &&
+                    mem_info.alloc_site < site_list.size()) {
+                mem_info.var_idx = base_idx + mem_info.alloc_site;
+            }
+        }
+    }
+
+    return 0;
+}
+
+template <class B>
+static void collect_core_ids(const B& bucket, std::set<int>& core_set) {
+    for (int i=0; i<bucket.size(); i++) {
+        for (int j=0; j<bucket[i].size(); j++) {
+            core_set.insert(bucket[i][j].coreID);
+        }
+    }
+}
+
+template <class B>
+static void renumber_core_ids(B& bucket, const std::map<int, int>& core_map) {
+    for (int i=0; i<bucket.size(); i++) {
+        for (int j=0; j<bucket[i].size(); j++) {
+            bucket[i][j].coreID = core_map.find(bucket[i][j].coreID)->second;
+        }
+    }
+}
+
+static int remap_core_ids(global_data_t& global_data) {
+    // Traces usually use far fewer cores than the IDs they report suggest,
+    // so renumber the observed cores 0..n-1 and size per-core state by n.
+    std::set<int> core_set;
+    collect_core_ids(global_data.mem_info_bucket, core_set);
+    collect_core_ids(global_data.trace_info_bucket, core_set);
+    collect_core_ids(global_data.vector_stride_info_bucket, core_set);
+
+    std::map<int, int> core_map;
+    int_list_t& core_id_list = global_data.core_id_list;
+    for (std::set<int>::iterator it = core_set.begin(); it != core_set.end();
+            it++) {
+        core_map[*it] = core_id_list.size();
+        core_id_list.push_back(*it);
+    }
+
+    renumber_core_ids(global_data.mem_info_bucket, core_map);
+    renumber_core_ids(global_data.trace_info_bucket, core_map);
+    renumber_core_ids(global_data.vector_stride_info_bucket, core_map);
+
+    return 0;
+}
+
+int get_core_id(const global_data_t& global_data, int core_idx) {
+    // Undoes remap_core_ids() to get the core ID recorded in the trace.
+    const int_list_t& core_id_list = global_data.core_id_list;
+    if (core_idx >= 0 && core_idx < core_id_list.size()) {
+        return core_id_list[core_idx];
+    }
+
+    return core_idx;
+}
+
+int get_shared_cache_level(const global_data_t& global_data, int core_idx_a,
+        int core_idx_b) {
+    const int core_a = get_core_id(global_data, core_idx_a);
+    const int core_b = get_core_id(global_data, core_idx_b);
+
+    for (int i=0; i<3; i++) {
+        const int_list_t& core_cache_list = global_data.core_cache_list[i];
+        if (core_a < 0 || core_a >= core_cache_list.size() ||
+                core_b < 0 || core_b >= core_cache_list.size() ||
+                core_cache_list[core_a] == -1) {
+            continue;
+        }
+
+        if (core_cache_list[core_a] == core_cache_list[core_b]) {
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
 int print_trace_records(const global_data_t& global_data) {
     const trace_info_bucket_t& bucket = global_data.trace_info_bucket;
 
@@ -136,8 +338,10 @@ int print_trace_records(const global_data_t& global_data) {
     return 0;
 }
 
-int read_file(const char* filename, global_data_t& global_data, bool bot) {
+int read_file(const char* filename, global_data_t& global_data, bool bot,
+        int rank) {
     int code = 0;
+    std::set<int> other_rank_set;
 
     int fd;
     if ((fd = open(filename, O_RDONLY)) < 0)
@@ -145,6 +349,17 @@ int read_file(const char* filename, global_data_t& global_data, bool bot) {
 
     node_t data_node;
     while (read(fd, &data_node, sizeof(data_node)) == sizeof(data_node)) {
+        // Node-local files interleave the records of several ranks, which
+        // have address spaces of their own, so only one rank is analyzed.
+        if (rank < 0) {
+            rank = data_node.rank;
+        }
+
+        if (data_node.rank != rank) {
+            other_rank_set.insert(data_node.rank);
+            continue;
+        }
+
         switch(data_node.type_message) {
             case MSG_STREAM_INFO:
                 if ((code = handle_stream_msg(data_node.stream_info,
@@ -181,11 +396,63 @@ int read_file(const char* filename, global_data_t& global_data, bool bot) {
                     return code;
                 break;
 
+            case MSG_ALLOC_SITE_INFO:
+                if ((code = handle_alloc_site_msg(data_node.alloc_site_info,
+                        global_data, bot)) < 0)
+                    return code;
+                break;
+
+            case MSG_PAGE_INFO:
+                if ((code = handle_page_msg(data_node.page_info,
+                        global_data)) < 0)
+                    return code;
+                break;
+
+            case MSG_REGION_INFO:
+                if ((code = handle_region_msg(data_node.region_info,
+                        global_data)) < 0)
+                    return code;
+                break;
+
+            case MSG_AGGREGATE_INFO:
+                if ((code = handle_aggregate_msg(data_node.aggregate_info,
+                        global_data)) < 0)
+                    return code;
+                break;
+
+            case MSG_CACHE_INFO:
+                if ((code = handle_cache_msg(data_node.cache_info,
+                        global_data)) < 0)
+                    return code;
+                break;
+
+            case MSG_CORE_INFO:
+                if ((code = handle_core_msg(data_node.core_info,
+                        global_data)) < 0)
+                    return code;
+                break;
+
+            case MSG_TLB_INFO:
+                if ((code = handle_tlb_msg(data_node.tlb_info,
+                        global_data)) < 0)
+                    return code;
+                break;
+
             default:
                 return -ERR_UNKNOWN_MSG;
         }
     }
 
     close(fd);
-    return 0;
+
+    if (other_rank_set.size() > 0 && bot == false) {
+        std::cout << macpoprefix << "The file also holds records of " <<
+            other_rank_set.size() << " other ranks, analyzing rank " << rank <<
+            " (use --rank to select another)." << std::endl;
+    }
+
+    if ((code = attribute_alloc_sites(global_data)) < 0)
+        return code;
+
+    return remap_core_ids(global_data);
 }                        
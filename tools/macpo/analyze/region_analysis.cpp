@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "fenwick_tree.h"
+#include "histogram.h"
+#include "region_analysis.h"
+
+static void add_stats(region_stats_t& dst, const region_stats_t& src) {
+    dst.access_count += src.access_count;
+    dst.l1_miss_count += src.l1_miss_count;
+    dst.l2_miss_count += src.l2_miss_count;
+
+    if (dst.thread_access_list.size() < src.thread_access_list.size()) {
+        dst.thread_access_list.resize(src.thread_access_list.size(), 0);
+    }
+
+    for (int i=0; i<src.thread_access_list.size(); i++) {
+        dst.thread_access_list[i] += src.thread_access_list[i];
+    }
+}
+
+// Ratio of the busiest thread's accesses to the mean over all threads.
+static double get_imbalance(const region_stats_t& stats) {
+    size_t thread_count = 0, max_count = 0;
+    for (int i=0; i<stats.thread_access_list.size(); i++) {
+        if (stats.thread_access_list[i] > 0) {
+            thread_count += 1;
+            max_count = std::max(max_count, stats.thread_access_list[i]);
+        }
+    }
+
+    if (thread_count == 0) {
+        return 1.0;
+    }
+
+    return max_count * thread_count / static_cast<double>(stats.access_count);
+}
+
+static size_t get_thread_count(const region_stats_t& stats) {
+    return stats.thread_access_list.size() - std::count(
+            stats.thread_access_list.begin(), stats.thread_access_list.end(),
+            0);
+}
+
+static std::string get_region_name(const global_data_t& global_data,
+        size_t index) {
+    if (index == 0) {
+        return MSG_SERIAL;
+    }
+
+    const region_info_list_t& region_info_list = global_data.region_info_list;
+    for (int i=0; i<region_info_list.size(); i++) {
+        if (region_info_list[i].region_idx == index - 1) {
+            return region_info_list[i].location;
+        }
+    }
+
+    return "unknown";
+}
+
+int region_analysis(const global_data_t& global_data,
+        region_stats_list_t& region_stats_list) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const size_t line_size = global_data.l1_data.line_size != 0 ?
+        global_data.l1_data.line_size : 64;
+    const size_t l1_lines = global_data.l1_data.size / line_size;
+    const size_t l2_lines = global_data.l2_data.size / line_size;
+
+    region_stats_list.clear();
+
+    #pragma omp parallel for
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+        region_stats_list_t local_stats_list;
+
+        // Accesses of each core are replayed through a fully associative
+        // cache model, so that the misses of each region include those
+        // caused by data it has to bring back after other code ran.
+        std::map<int, std::vector<size_t> > core_index_map;
+        for (int j=0; j<list.size(); j++) {
+            core_index_map[list.at(j).coreID].push_back(j);
+        }
+
+        for (std::map<int, std::vector<size_t> >::iterator it =
+                core_index_map.begin(); it != core_index_map.end(); it++) {
+            const std::vector<size_t>& index_list = it->second;
+
+            fenwick_tree_t tree(index_list.size());
+            std::map<size_t, size_t> last_access;
+
+            for (size_t j=0; j<index_list.size(); j++) {
+                const mem_info_t& mem_info = list.at(index_list[j]);
+                const size_t cache_line = mem_info.address / line_size;
+
+                size_t distance = SIZE_MAX;
+                std::map<size_t, size_t>::iterator jt =
+                    last_access.find(cache_line);
+                if (jt != last_access.end()) {
+                    distance = tree.prefix_sum(j) -
+                        tree.prefix_sum(jt->second);
+                    tree.add(jt->second, -1);
+                }
+
+                tree.add(j, 1);
+                last_access[cache_line] = j;
+
+                size_t index = mem_info.region_idx < 0 ? 0 :
+                    mem_info.region_idx + 1;
+                if (index >= local_stats_list.size()) {
+                    local_stats_list.resize(index + 1, region_stats_t());
+                }
+
+                region_stats_t& stats = local_stats_list[index];
+                if (mem_info.threadID >= stats.thread_access_list.size()) {
+                    stats.thread_access_list.resize(mem_info.threadID + 1, 0);
+                }
+
+                stats.access_count += 1;
+                stats.thread_access_list[mem_info.threadID] += 1;
+
+                if (distance >= l1_lines)
+                    stats.l1_miss_count += 1;
+                if (distance >= l2_lines)
+                    stats.l2_miss_count += 1;
+            }
+        }
+
+        #pragma omp critical
+        {
+            if (region_stats_list.size() < local_stats_list.size()) {
+                region_stats_list.resize(local_stats_list.size(),
+                        region_stats_t());
+            }
+
+            for (int j=0; j<local_stats_list.size(); j++) {
+                add_stats(region_stats_list[j], local_stats_list[j]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+int print_regions(const global_data_t& global_data,
+        const region_stats_list_t& region_stats_list, bool bot) {
+    // Regions with the most L1 misses first.
+    pair_list_t pair_list;
+    for (int i=0; i<region_stats_list.size(); i++) {
+        if (region_stats_list[i].access_count > 0) {
+            pair_list.push_back(pair_t(i,
+                        region_stats_list[i].l1_miss_count));
+        }
+    }
+
+    std::stable_sort(pair_list.begin(), pair_list.end(), pair_sort);
+
+    size_t total_accesses = 0;
+    for (int i=0; i<region_stats_list.size(); i++) {
+        total_accesses += region_stats_list[i].access_count;
+    }
+
+    std::cout << std::endl;
+
+    for (int i=0; i<pair_list.size(); i++) {
+        const size_t index = pair_list[i].first;
+        const region_stats_t& stats = region_stats_list[index];
+        const std::string name = get_region_name(global_data, index);
+
+        const double l1_miss_ratio = stats.l1_miss_count /
+            static_cast<double>(stats.access_count);
+        const double l2_miss_ratio = stats.l2_miss_count /
+            static_cast<double>(stats.access_count);
+
+        if (bot == false) {
+            if (index == 0) {
+                std::cout << macpoprefix << "Serial code";
+            } else {
+                std::cout << macpoprefix << "Parallel region at " << name <<
+                    " (" << get_thread_count(stats) << " threads, " <<
+                    "imbalance " << get_imbalance(stats) << ")";
+            }
+
+            std::cout << ": " << 100.0 * stats.access_count / total_accesses
+                << "% of accesses, L1 miss ratio: " << 100.0 * l1_miss_ratio
+                << "%, L2 miss ratio: " << 100.0 * l2_miss_ratio << "%." <<
+                std::endl;
+        } else {
+            std::cout << MSG_REGION << "." << name << "." << MSG_ACCESS_COUNT
+                << "=" << stats.access_count << std::endl;
+            std::cout << MSG_REGION << "." << name << "." << MSG_THREAD_COUNT
+                << "=" << get_thread_count(stats) << std::endl;
+            std::cout << MSG_REGION << "." << name << "." << MSG_IMBALANCE <<
+                "=" << get_imbalance(stats) << std::endl;
+            std::cout << MSG_REGION << "." << name << "." <<
+                MSG_L1_MISS_RATIO << "=" << l1_miss_ratio << std::endl;
+            std::cout << MSG_REGION << "." << name << "." <<
+                MSG_L2_MISS_RATIO << "=" << l2_miss_ratio << std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -101,7 +101,7 @@ void printCacheInformation(cache_data_t cache_data, int number_of_sets) {
 
 int set_cache_conflict_analysis(const global_data_t& global_data) {
     const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
-    const int num_cores = sysconf(_SC_NPROCESSORS_CONF);
+    const int num_cores = global_data.core_id_list.size();
     const int num_streams = global_data.stream_list.size();
     cache_data_t l1_data = global_data.l1_data;
     size_t l1_cache_lines = l1_data.size / l1_data.line_size;
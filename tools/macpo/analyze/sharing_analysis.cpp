@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+
+#include "record_io.h"
+#include "sharing_analysis.h"
+
+typedef struct {
+    size_t count;
+    bool written;
+} sharer_t;
+
+typedef std::map<int, sharer_t> sharer_map_t;
+
+// Keyed on (variable index, cache line).
+typedef std::map<pair_t, sharer_map_t> line_sharer_map_t;
+
+typedef std::map<int, int> placement_t;
+
+static int get_socket(const global_data_t& global_data, int core_idx) {
+    const int_list_t& core_socket_list = global_data.core_socket_list;
+    const int core_id = get_core_id(global_data, core_idx);
+    if (core_id >= 0 && core_id < core_socket_list.size()) {
+        return core_socket_list[core_id];
+    }
+
+    return 0;
+}
+
+static bool compare_volume(const std::pair<pair_t, size_t>& a,
+        const std::pair<pair_t, size_t>& b) {
+    return a.second > b.second;
+}
+
+static size_t cross_socket_volume(const sharing_matrix_t& sharing_matrix,
+        placement_t& placement) {
+    size_t volume = 0;
+    for (sharing_matrix_t::const_iterator it = sharing_matrix.begin();
+            it != sharing_matrix.end(); it++) {
+        if (placement[it->first.first] != placement[it->first.second]) {
+            volume += it->second;
+        }
+    }
+
+    return volume;
+}
+
+static void suggest_placement(const sharing_matrix_t& sharing_matrix,
+        const std::set<int>& thread_set, int num_sockets,
+        int socket_capacity, placement_t& placement) {
+    std::vector<std::pair<pair_t, size_t> > pair_list(sharing_matrix.begin(),
+            sharing_matrix.end());
+    std::sort(pair_list.begin(), pair_list.end(), compare_volume);
+
+    int_list_t socket_load(num_sockets, 0);
+
+    // Greedily keep the heaviest sharing pairs on the same socket.
+    for (int i=0; i<pair_list.size(); i++) {
+        const int thread_a = pair_list[i].first.first;
+        const int thread_b = pair_list[i].first.second;
+        const bool placed_a = placement.find(thread_a) != placement.end();
+        const bool placed_b = placement.find(thread_b) != placement.end();
+
+        if (placed_a && placed_b) {
+            continue;
+        }
+
+        int socket = -1;
+        if (placed_a || placed_b) {
+            socket = placed_a ? placement[thread_a] : placement[thread_b];
+            if (socket_load[socket] >= socket_capacity) {
+                continue;
+            }
+        } else {
+            socket = std::min_element(socket_load.begin(), socket_load.end()) -
+                socket_load.begin();
+        }
+
+        if (placed_a == false && socket_load[socket] < socket_capacity) {
+            placement[thread_a] = socket;
+            socket_load[socket] += 1;
+        }
+
+        if (placed_b == false && socket_load[socket] < socket_capacity) {
+            placement[thread_b] = socket;
+            socket_load[socket] += 1;
+        }
+    }
+
+    // Threads that share nothing (or did not fit) go to the emptiest socket.
+    for (std::set<int>::const_iterator it = thread_set.begin();
+            it != thread_set.end(); it++) {
+        if (placement.find(*it) == placement.end()) {
+            int socket = std::min_element(socket_load.begin(),
+                    socket_load.end()) - socket_load.begin();
+            placement[*it] = socket;
+            socket_load[socket] += 1;
+        }
+    }
+}
+
+int sharing_analysis(const global_data_t& global_data,
+        sharing_matrix_t& sharing_matrix,
+        sharing_profile_list_t& profile_list) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const int num_streams = global_data.stream_list.size();
+
+    sharing_profile_t empty_profile = { 0, 0, 0, 0 };
+    profile_list.assign(num_streams, empty_profile);
+
+    line_sharer_map_t line_map;
+
+    #pragma omp parallel for
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+        line_sharer_map_t local_map;
+
+        for (int j=0; j<list.size(); j++) {
+            const mem_info_t& mem_info = list.at(j);
+            if (mem_info.var_idx >= num_streams) {
+                continue;
+            }
+
+            pair_t key(mem_info.var_idx, ADDR_TO_CACHE_LINE(mem_info.address));
+            sharer_t& sharer = local_map[key][mem_info.coreID];
+            sharer.count += 1;
+
+            if (mem_info.read_write == TYPE_WRITE ||
+                    mem_info.read_write == TYPE_READ_AND_WRITE) {
+                sharer.written = true;
+            }
+        }
+
+        #pragma omp critical
+        for (line_sharer_map_t::iterator it = local_map.begin();
+                it != local_map.end(); it++) {
+            sharer_map_t& sharer_map = line_map[it->first];
+            for (sharer_map_t::iterator jt = it->second.begin();
+                    jt != it->second.end(); jt++) {
+                sharer_t& sharer = sharer_map[jt->first];
+                sharer.count += jt->second.count;
+                sharer.written |= jt->second.written;
+            }
+        }
+    }
+
+    // Only lines with more than one sharer contribute to the matrix, which
+    // keeps it sparse even with hundreds of threads.
+    for (line_sharer_map_t::iterator it = line_map.begin();
+            it != line_map.end(); it++) {
+        sharing_profile_t& profile = profile_list[it->first.first];
+        const sharer_map_t& sharer_map = it->second;
+
+        if (sharer_map.size() == 1) {
+            profile.private_lines += 1;
+            continue;
+        }
+
+        bool written = false;
+        std::set<int> socket_set;
+        for (sharer_map_t::const_iterator jt = sharer_map.begin();
+                jt != sharer_map.end(); jt++) {
+            written |= jt->second.written;
+            socket_set.insert(get_socket(global_data, jt->first));
+
+            sharer_map_t::const_iterator kt = jt;
+            for (kt++; kt != sharer_map.end(); kt++) {
+                sharing_matrix[pair_t(jt->first, kt->first)] += 1;
+            }
+        }
+
+        if (written) {
+            profile.write_shared_lines += 1;
+        } else {
+            profile.read_shared_lines += 1;
+        }
+
+        if (socket_set.size() > 1) {
+            profile.cross_socket_lines += 1;
+        }
+    }
+
+    return 0;
+}
+
+static void print_placement_advice(const global_data_t& global_data,
+        const sharing_matrix_t& sharing_matrix,
+        const sharing_profile_list_t& profile_list, bool bot) {
+    const int_list_t& core_socket_list = global_data.core_socket_list;
+    const int num_sockets = core_socket_list.size() == 0 ? 1 :
+        *std::max_element(core_socket_list.begin(),
+                core_socket_list.end()) + 1;
+
+    std::set<int> thread_set;
+    placement_t current_placement;
+    for (sharing_matrix_t::const_iterator it = sharing_matrix.begin();
+            it != sharing_matrix.end(); it++) {
+        thread_set.insert(it->first.first);
+        thread_set.insert(it->first.second);
+    }
+
+    for (std::set<int>::iterator it = thread_set.begin();
+            it != thread_set.end(); it++) {
+        current_placement[*it] = get_socket(global_data, *it);
+    }
+
+    if (num_sockets < 2 || thread_set.size() < 2) {
+        if (bot == false) {
+            std::cout << macpoprefix << "All sharing threads run on a single "
+                "socket, no placement advice." << std::endl;
+        }
+
+        return;
+    }
+
+    int cores_per_socket = std::max((size_t) 1,
+            core_socket_list.size() / num_sockets);
+    int socket_capacity = std::max(cores_per_socket,
+            (int) (thread_set.size() + num_sockets - 1) / num_sockets);
+
+    placement_t suggested_placement;
+    suggest_placement(sharing_matrix, thread_set, num_sockets,
+            socket_capacity, suggested_placement);
+
+    size_t current_volume = cross_socket_volume(sharing_matrix,
+            current_placement);
+    size_t suggested_volume = cross_socket_volume(sharing_matrix,
+            suggested_placement);
+
+    if (bot == false) {
+        std::cout << macpoprefix << "Placement advice:" << std::endl;
+        std::cout << "cross-socket shared lines: " << current_volume <<
+            " with the current placement, " << suggested_volume <<
+            " with the suggested placement." << std::endl;
+
+        if (suggested_volume < current_volume) {
+            for (int i=0; i<num_sockets; i++) {
+                std::cout << "socket " << i << ": threads seen on cores";
+                for (placement_t::iterator it = suggested_placement.begin();
+                        it != suggested_placement.end(); it++) {
+                    if (it->second == i) {
+                        std::cout << " " << get_core_id(global_data,
+                                it->first);
+                    }
+                }
+
+                std::cout << "." << std::endl;
+            }
+        }
+
+        const int num_streams = global_data.stream_list.size();
+        for (int i=0; i<num_streams; i++) {
+            const sharing_profile_t& profile = profile_list[i];
+            if (profile.cross_socket_lines == 0) {
+                continue;
+            }
+
+            std::cout << "var: " << global_data.stream_list[i] << ", " <<
+                profile.cross_socket_lines << " lines are shared across "
+                "sockets; ";
+            if (profile.write_shared_lines > profile.read_shared_lines) {
+                std::cout << "partition it so that the threads of each "
+                    "socket write to a disjoint block." << std::endl;
+            } else {
+                std::cout << "replicate its read-only part on each socket." <<
+                    std::endl;
+            }
+        }
+    } else {
+        std::cout << MSG_PLACEMENT << "." << MSG_CURRENT_CROSS_SOCKET << "=" <<
+            current_volume << std::endl;
+        std::cout << MSG_PLACEMENT << "." << MSG_SUGGESTED_CROSS_SOCKET <<
+            "=" << suggested_volume << std::endl;
+
+        for (placement_t::iterator it = suggested_placement.begin();
+                it != suggested_placement.end(); it++) {
+            std::cout << MSG_PLACEMENT << "." << MSG_CORE << "." <<
+                get_core_id(global_data, it->first) << "=" << it->second <<
+                std::endl;
+        }
+    }
+}
+
+int print_sharing_analysis(const global_data_t& global_data,
+        const sharing_matrix_t& sharing_matrix,
+        const sharing_profile_list_t& profile_list, bool bot) {
+    const int num_streams = global_data.stream_list.size();
+
+    std::vector<std::pair<pair_t, size_t> > pair_list(sharing_matrix.begin(),
+            sharing_matrix.end());
+    std::sort(pair_list.begin(), pair_list.end(), compare_volume);
+
+    std::cout << std::endl;
+
+    if (bot == false) {
+        std::cout << macpoprefix << "Thread sharing matrix (shared cache "
+            "lines):" << std::endl;
+
+        size_t limit = std::min((size_t) SHARING_PAIR_COUNT, pair_list.size());
+        for (size_t i=0; i<limit; i++) {
+            const pair_t& threads = pair_list[i].first;
+            const bool same_socket = get_socket(global_data, threads.first) ==
+                get_socket(global_data, threads.second);
+            const int cache_level = get_shared_cache_level(global_data,
+                    threads.first, threads.second);
+
+            std::cout << "cores " << get_core_id(global_data, threads.first) <<
+                " and " << get_core_id(global_data, threads.second) << ": " <<
+                pair_list[i].second << " lines (";
+            if (cache_level > 0) {
+                std::cout << "shared L" << cache_level << " cache";
+            } else {
+                std::cout << (same_socket ? "same socket" : "cross-socket");
+            }
+
+            std::cout << ")." << std::endl;
+        }
+
+        for (int i=0; i<num_streams; i++) {
+            const sharing_profile_t& profile = profile_list[i];
+            if (profile.private_lines + profile.read_shared_lines +
+                    profile.write_shared_lines == 0) {
+                continue;
+            }
+
+            std::cout << "var: " << global_data.stream_list[i] <<
+                ", private lines: " << profile.private_lines <<
+                ", read-shared: " << profile.read_shared_lines <<
+                ", write-shared: " << profile.write_shared_lines <<
+                ", cross-socket: " << profile.cross_socket_lines << "." <<
+                std::endl;
+        }
+    } else {
+        for (size_t i=0; i<pair_list.size(); i++) {
+            const pair_t& threads = pair_list[i].first;
+            std::cout << MSG_SHARING << "." << MSG_SHARING_MATRIX << "." <<
+                get_core_id(global_data, threads.first) << "." <<
+                get_core_id(global_data, threads.second) << "=" <<
+                pair_list[i].second << std::endl;
+        }
+
+        for (int i=0; i<num_streams; i++) {
+            const sharing_profile_t& profile = profile_list[i];
+            const std::string& var_name = global_data.stream_list[i];
+
+            std::cout << MSG_SHARING << "." << var_name << "." <<
+                MSG_PRIVATE_LINES << "=" << profile.private_lines << std::endl;
+            std::cout << MSG_SHARING << "." << var_name << "." <<
+                MSG_READ_SHARED_LINES << "=" << profile.read_shared_lines <<
+                std::endl;
+            std::cout << MSG_SHARING << "." << var_name << "." <<
+                MSG_WRITE_SHARED_LINES << "=" << profile.write_shared_lines <<
+                std::endl;
+            std::cout << MSG_SHARING << "." << var_name << "." <<
+                MSG_CROSS_SOCKET_LINES << "=" << profile.cross_socket_lines <<
+                std::endl;
+        }
+    }
+
+    print_placement_advice(global_data, sharing_matrix, profile_list, bot);
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -28,7 +28,7 @@
 int vector_stride_analysis(const global_data_t& global_data,
         histogram_list_t& stride_list) {
     const vector_stride_info_bucket_t& bucket = global_data.vector_stride_info_bucket;
-    const int num_cores = sysconf(_SC_NPROCESSORS_CONF);
+    const int num_cores = global_data.core_id_list.size();
     const int num_streams = global_data.stream_list.size();
 
     #pragma omp parallel for
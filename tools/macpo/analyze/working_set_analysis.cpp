@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "working_set_analysis.h"
+
+// The average footprint over all windows of length w follows from reuse
+// times in linear time (Xiang et al., "All-window profiling and composable
+// models of cache sharing", PPoPP 2011):
+//
+//   fp(w) = m - (sum over gaps g > w of (g - w)) / (n - w + 1)
+//
+// where m is the number of distinct lines in a trace of length n and the
+// gaps are all reuse times plus, for every line, the time of its first
+// access and the time from its last access to the end of the trace.
+// Each (bucket, core) pair is treated as a separate trace, and the sums
+// are accumulated over all traces that are at least w accesses long.
+
+static void add_trace(const mem_info_list_t& list,
+        const std::vector<size_t>& index_list, int num_streams,
+        working_set_list_t& working_set_list,
+        log_histogram_t& window_histogram) {
+    typedef std::map<size_t, std::pair<size_t, size_t> > first_last_map_t;
+
+    const size_t n = index_list.size();
+    std::vector<first_last_map_t> line_map_list(num_streams);
+
+    for (size_t i=0; i<n; i++) {
+        const mem_info_t& mem_info = list.at(index_list[i]);
+        const size_t cache_line = ADDR_TO_CACHE_LINE(mem_info.address);
+        const size_t time = i + 1;
+
+        first_last_map_t& line_map = line_map_list[mem_info.var_idx];
+        first_last_map_t::iterator it = line_map.find(cache_line);
+        if (it == line_map.end()) {
+            line_map[cache_line] = std::make_pair(time, time);
+        } else {
+            working_set_list[mem_info.var_idx].gap_histogram.add(time -
+                    it->second.second);
+            it->second.second = time;
+        }
+    }
+
+    window_histogram.add(n);
+
+    for (int i=0; i<num_streams; i++) {
+        const first_last_map_t& line_map = line_map_list[i];
+        if (line_map.size() == 0) {
+            continue;
+        }
+
+        working_set_t& working_set = working_set_list[i];
+        for (first_last_map_t::const_iterator it = line_map.begin();
+                it != line_map.end(); it++) {
+            working_set.gap_histogram.add(it->second.first);
+            working_set.gap_histogram.add(n + 1 - it->second.second);
+        }
+
+        working_set.line_histogram.add(n, line_map.size());
+    }
+}
+
+int working_set_analysis(const global_data_t& global_data,
+        working_set_list_t& working_set_list,
+        log_histogram_t& window_histogram) {
+    const mem_info_bucket_t& bucket = global_data.mem_info_bucket;
+    const int num_streams = global_data.stream_list.size();
+
+    working_set_list.resize(num_streams);
+
+    #pragma omp parallel for
+    for (int i=0; i<bucket.size(); i++) {
+        const mem_info_list_t& list = bucket.at(i);
+
+        working_set_list_t local_list(num_streams);
+        log_histogram_t local_histogram;
+
+        std::map<int, std::vector<size_t> > core_index_map;
+        for (int j=0; j<list.size(); j++) {
+            const mem_info_t& mem_info = list.at(j);
+            if (mem_info.var_idx < num_streams) {
+                core_index_map[mem_info.coreID].push_back(j);
+            }
+        }
+
+        for (std::map<int, std::vector<size_t> >::iterator it =
+                core_index_map.begin(); it != core_index_map.end(); it++) {
+            add_trace(list, it->second, num_streams, local_list,
+                    local_histogram);
+        }
+
+        #pragma omp critical
+        {
+            window_histogram.merge(local_histogram);
+            for (int j=0; j<num_streams; j++) {
+                working_set_list[j].gap_histogram.merge(
+                        local_list[j].gap_histogram);
+                working_set_list[j].line_histogram.merge(
+                        local_list[j].line_histogram);
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Returns the average number of lines touched in windows of `window'
+// accesses, or a negative value if no trace is that long.
+static double footprint(const working_set_t& working_set,
+        const log_histogram_t& window_histogram, size_t window) {
+    std::pair<double, double> windows = window_histogram.tail(window);
+    double window_count = windows.second - (window - 1) * windows.first;
+    if (window_count <= 0) {
+        return -1;
+    }
+
+    std::pair<double, double> lines = working_set.line_histogram.tail(window);
+    std::pair<double, double> gaps = working_set.gap_histogram.tail(window);
+
+    return (lines.second - (window - 1) * lines.first -
+            (gaps.second - window * gaps.first)) / window_count;
+}
+
+static const char* cache_level(const global_data_t& global_data,
+        size_t bytes) {
+    if (bytes <= global_data.l1_data.size)  return "L1";
+    if (bytes <= global_data.l2_data.size)  return "L2";
+    if (bytes <= global_data.l3_data.size)  return "L3";
+    return "memory";
+}
+
+static std::string window_label(int shift) {
+    static const char* suffix[] = { "K", "M", "G" };
+
+    std::stringstream stream;
+    stream << (1 << (shift % 10)) << suffix[shift / 10 - 1];
+    return stream.str();
+}
+
+int print_working_sets(const global_data_t& global_data,
+        const working_set_list_t& working_set_list,
+        const log_histogram_t& window_histogram, bool bot) {
+    const int num_streams = global_data.stream_list.size();
+    const size_t line_size = global_data.l1_data.line_size != 0 ?
+        global_data.l1_data.line_size : 64;
+
+    std::cout << std::endl;
+
+    for (int i=0; i<num_streams; i++) {
+        const working_set_t& working_set = working_set_list[i];
+        if (working_set.line_histogram.size() == 0) {
+            continue;
+        }
+
+        if (bot == false) {
+            std::cout << "var: " << global_data.stream_list[i] <<
+                ", average working set by window length:";
+        }
+
+        for (int shift=WORKING_SET_MIN_SHIFT; shift<=WORKING_SET_MAX_SHIFT;
+                shift += WORKING_SET_STEP_SHIFT) {
+            double lines = footprint(working_set, window_histogram,
+                    1ul << shift);
+            if (lines < 0) {
+                break;
+            }
+
+            const size_t bytes = lines * line_size;
+            if (bot == false) {
+                std::cout << (shift > WORKING_SET_MIN_SHIFT ? ", " : " ") <<
+                    window_label(shift) << ": " <<
+                    bytes / 1024.0 << " KB (" <<
+                    cache_level(global_data, bytes) << ")";
+            } else {
+                std::cout << MSG_WORKING_SET << "." <<
+                    global_data.stream_list[i] << "." << window_label(shift) <<
+                    "=" << bytes << std::endl;
+            }
+        }
+
+        if (bot == false) {
+            std::cout << "." << std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -75,6 +75,7 @@ static bool is_same_file(const std::string& file_1, const std::string& file_2) {
 typedef struct _tag_options_t {
     bool no_compile;
     bool disable_sampling;
+    bool aggregate;
     bool profile_analysis;
     bool dynamic_inst;
     std::string base_compiler;
@@ -153,6 +154,7 @@ typedef struct _tag_options_t {
     void reset() {
         no_compile = false;
         disable_sampling = false;
+        aggregate = false;
         profile_analysis = false;
         dynamic_inst = false;
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef TOOLS_MACPO_COMMON_HYPERLOGLOG_H_
+#define TOOLS_MACPO_COMMON_HYPERLOGLOG_H_
+
+#include <stdint.h>
+
+#include <cmath>
+#include <cstring>
+
+// Number of index bits; 2^10 one-byte registers give a relative
+// standard error of about 1.04 / sqrt(1024), i.e. roughly 3%.
+#define HLL_PRECISION   10
+#define HLL_REGISTERS   (1 << HLL_PRECISION)
+
+class hyperloglog_t {
+ public:
+    hyperloglog_t() {
+        reset();
+    }
+
+    void reset() {
+        memset(registers, 0, sizeof(registers));
+    }
+
+    void insert(uint64_t value) {
+        uint64_t hash = mix(value);
+        uint32_t index = hash >> (64 - HLL_PRECISION);
+
+        // Position of the first set bit in the remaining (64 - p) bits.
+        uint64_t remainder = hash << HLL_PRECISION;
+        uint8_t rank = remainder == 0 ? 64 - HLL_PRECISION + 1 :
+            __builtin_clzll(remainder) + 1;
+
+        if (rank > registers[index]) {
+            registers[index] = rank;
+        }
+    }
+
+    void merge(const hyperloglog_t& other) {
+        for (int i = 0; i < HLL_REGISTERS; i++) {
+            if (other.registers[i] > registers[i]) {
+                registers[i] = other.registers[i];
+            }
+        }
+    }
+
+    uint64_t estimate() const {
+        const double m = HLL_REGISTERS;
+        const double alpha = 0.7213 / (1 + 1.079 / m);
+
+        double sum = 0;
+        int zero_registers = 0;
+        for (int i = 0; i < HLL_REGISTERS; i++) {
+            sum += ldexp(1.0, -registers[i]);
+            if (registers[i] == 0) {
+                zero_registers += 1;
+            }
+        }
+
+        double estimate = alpha * m * m / sum;
+
+        // Small-range correction: fall back to linear counting.
+        if (estimate <= 2.5 * m && zero_registers > 0) {
+            estimate = m * log(m / zero_registers);
+        }
+
+        return static_cast<uint64_t>(estimate + 0.5);
+    }
+
+ private:
+    uint8_t registers[HLL_REGISTERS];
+
+    static inline uint64_t mix(uint64_t value) {
+        // Finalizer from splitmix64, spreads nearby cache lines apart.
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31;
+        return value;
+    }
+};
+
+#endif  // TOOLS_MACPO_COMMON_HYPERLOGLOG_H_
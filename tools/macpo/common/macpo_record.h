@@ -30,7 +30,9 @@
 
 enum { TYPE_UNKNOWN = 0, TYPE_READ, TYPE_WRITE, TYPE_READ_AND_WRITE };
 enum { MSG_TERMINAL = 0, MSG_STREAM_INFO, MSG_MEM_INFO, MSG_METADATA,
-        MSG_TRACE_INFO, MSG_VECTOR_STRIDE_INFO };
+        MSG_TRACE_INFO, MSG_VECTOR_STRIDE_INFO, MSG_AGGREGATE_INFO,
+        MSG_ALLOC_SITE_INFO, MSG_CACHE_INFO, MSG_CORE_INFO, MSG_TLB_INFO,
+        MSG_REGION_INFO, MSG_PAGE_INFO };
 
 typedef struct {
     uint16_t coreID;
@@ -56,8 +58,67 @@ typedef struct {
     size_t address;
     size_t var_idx;
     int type_size;
+    int alloc_site;     // Index of the heap allocation site, or -1.
+    int region_idx;     // Index of the OpenMP parallel region, or -1.
+    uint16_t threadID;  // OpenMP thread number within the team.
+    uint16_t team_size;
 } mem_info_t;
 
+// Per-site summary written in aggregate mode instead of per-access records.
+// A line_number of zero holds the totals for the variable across all sites.
+typedef struct {
+    size_t line_number;
+    size_t var_idx;
+    uint64_t read_count;
+    uint64_t write_count;
+    uint64_t byte_count;
+    uint64_t distinct_lines;
+} aggregate_info_t;
+
+// Heap allocation site, written at exit when MACPO_TRACK_HEAP is set.
+typedef struct {
+    size_t site_idx;
+    size_t alloc_count;
+    size_t alloc_bytes;
+    char location[STRING_LENGTH - 3 * sizeof(size_t)];
+} alloc_site_info_t;
+
+// OpenMP parallel region, written at exit for each region that was entered.
+typedef struct {
+    size_t region_idx;
+    size_t instance_count;  // Number of times the region was entered.
+    char location[STRING_LENGTH - 2 * sizeof(size_t)];
+} region_info_t;
+
+// Cache geometry of the machine that produced the trace, one per level.
+typedef struct {
+    uint16_t level;
+    size_t size;
+    size_t line_size;
+    size_t associativity;
+    size_t count;       // Number of instances of this cache.
+} cache_info_t;
+
+// Socket and cache instances (named by their first core, UINT16_MAX if the
+// core has no such cache) of each core.
+typedef struct {
+    uint16_t coreID;
+    uint16_t socket;
+    uint16_t cache_id[3];
+    uint16_t numa_node;
+} core_info_t;
+
+// NUMA node of a sampled page, written when MACPO_NUMA is set.
+typedef struct {
+    size_t page;        // Address divided by the 4 KB page size.
+    int numa_node;
+} page_info_t;
+
+typedef struct {
+    size_t dtlb_entries_4k, dtlb_entries_2m;
+    size_t stlb_entries_4k, stlb_entries_2m;
+} tlb_info_t;
+
 typedef struct {
     char binary_name[STRING_LENGTH];
     time_t execution_timestamp;
@@ -69,12 +130,20 @@ typedef struct {
 
 typedef struct node {
     uint16_t type_message;
+    uint32_t rank;      // MPI rank of the process that wrote the record.
     union {
         mem_info_t mem_info;
         trace_info_t trace_info;
         stream_info_t stream_info;
         metadata_info_t metadata_info;
         vector_stride_info_t vector_stride_info;
+        aggregate_info_t aggregate_info;
+        alloc_site_info_t alloc_site_info;
+        region_info_t region_info;
+        cache_info_t cache_info;
+        core_info_t core_info;
+        tlb_info_t tlb_info;
+        page_info_t page_info;
     };
 } node_t;
 
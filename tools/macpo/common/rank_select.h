@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ * 
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ * 
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef TOOLS_MACPO_COMMON_RANK_SELECT_H_
+#define TOOLS_MACPO_COMMON_RANK_SELECT_H_
+
+#include <cstdlib>
+
+// rank_list holds a list of ranks and ranges (e.g. "0,8,16-19") and
+// rank_stride selects every n-th rank. A rank is selected if either selects
+// it, or if neither is set. Parsing stops at the first malformed entry, so
+// entries after it select nothing.
+inline bool is_rank_selected(int rank, const char* rank_list,
+        const char* rank_stride) {
+    if (rank_list == NULL && rank_stride == NULL) {
+        return true;
+    }
+
+    if (rank_stride != NULL && atoi(rank_stride) > 0 &&
+            rank % atoi(rank_stride) == 0) {
+        return true;
+    }
+
+    const char* ptr = rank_list;
+    while (ptr != NULL && *ptr != '\0') {
+        char* end = NULL;
+        long first = strtol(ptr, &end, 10), last = first;
+        if (end == ptr) {
+            break;
+        }
+
+        if (*end == '-') {
+            ptr = end + 1;
+            last = strtol(ptr, &end, 10);
+            if (end == ptr) {
+                break;
+            }
+        }
+
+        if (*end != ',' && *end != '\0') {
+            break;
+        }
+
+        if (rank >= first && rank <= last) {
+            return true;
+        }
+
+        ptr = *end == ',' ? end + 1 : NULL;
+    }
+
+    return false;
+}
+
+#endif  // TOOLS_MACPO_COMMON_RANK_SELECT_H_
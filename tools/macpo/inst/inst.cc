@@ -193,6 +193,8 @@ int parse_argument(char* arg, macpo_options_t& macpo_options) {
         set_disable_sampling_flag(&macpo_options, 0);
     } else if (option == "disable-sampling") {
         set_disable_sampling_flag(&macpo_options, 1);
+    } else if (option == "aggregate") {
+        set_aggregate_flag(&macpo_options, 1);
     } else if (option == "profile-analysis") {
         set_profiling_flag(&macpo_options, 1);
     } else if (option == "compiler") {
@@ -195,6 +195,8 @@ int argparse::parse_arguments(char* arg, options_t& options) {
         options.disable_sampling = false;
     } else if (option == "disable-sampling") {
         options.disable_sampling = true;
+    } else if (option == "aggregate") {
+        options.aggregate = true;
     } else if (option == "profile-analysis") {
         options.profile_analysis = true;
     } else if (option == "compiler") {
@@ -64,6 +64,22 @@ void set_disable_sampling_flag(macpo_options_t* macpo_options, uint8_t flag) {
     macpo_options->disable_sampling_flag = flag;
 }
 
+uint8_t get_aggregate_flag(const macpo_options_t* macpo_options) {
+    if (macpo_options == NULL) {
+        return -1;
+    }
+
+    return macpo_options->aggregate_flag;
+}
+
+void set_aggregate_flag(macpo_options_t* macpo_options, uint8_t flag) {
+    if (macpo_options == NULL) {
+        return;
+    }
+
+    macpo_options->aggregate_flag = flag;
+}
+
 void set_dynamic_instrumentation_flag(macpo_options_t *macpo_options, uint8_t flag) {
     if (macpo_options == NULL) {
         return;
@@ -195,6 +211,7 @@ static options_t convert_macpo_options(macpo_options_t* macpo_options) {
 
     options.no_compile          = macpo_options->no_compile_flag == 1;
     options.disable_sampling    = macpo_options->disable_sampling_flag == 1;
+    options.aggregate           = macpo_options->aggregate_flag == 1;
     options.profile_analysis    = macpo_options->profiling_flag == 1;
     options.dynamic_inst        = macpo_options->dynamic_inst_flag == 1;
 
@@ -36,6 +36,7 @@ typedef struct __tag_code_location_t {
 typedef struct {
     uint8_t no_compile_flag;
     uint8_t disable_sampling_flag;
+    uint8_t aggregate_flag;
     uint8_t profiling_flag;
     uint8_t dynamic_inst_flag;
 
@@ -54,6 +55,9 @@ void set_dynamic_instrumentation_flag(macpo_options_t *macpo_options,
 uint8_t get_disable_sampling_flag(const macpo_options_t* macpo_options);
 void set_disable_sampling_flag(macpo_options_t* macpo_options, uint8_t flag);
 
+uint8_t get_aggregate_flag(const macpo_options_t* macpo_options);
+void set_aggregate_flag(macpo_options_t* macpo_options, uint8_t flag);
+
 uint8_t get_profiling_flag(const macpo_options_t* macpo_options);
 void set_profiling_flag(macpo_options_t* macpo_options, uint8_t flag);
 
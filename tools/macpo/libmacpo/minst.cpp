@@ -446,6 +446,7 @@ void MINST::add_hooks_to_main_function(SgFunctionDefinition* main_def) {
 
     int create_file = 0;
     int enable_sampling;
+    int aggregate;
 
     bool insert_map_call = false;
     std::vector<SgExpression*> params, empty_params;
@@ -472,6 +473,7 @@ void MINST::add_hooks_to_main_function(SgFunctionDefinition* main_def) {
     }
 
     enable_sampling = options.disable_sampling ? 0 : 1;
+    aggregate = options.aggregate ? 1 : 0;
 
     SgIntVal* rose_create_file = new SgIntVal(file_info, create_file);
     rose_create_file->set_endOfConstruct(file_info);
@@ -481,6 +483,10 @@ void MINST::add_hooks_to_main_function(SgFunctionDefinition* main_def) {
     rose_enable_sampling->set_endOfConstruct(file_info);
     params.push_back(rose_enable_sampling);
 
+    SgIntVal* rose_aggregate = new SgIntVal(file_info, aggregate);
+    rose_aggregate->set_endOfConstruct(file_info);
+    params.push_back(rose_aggregate);
+
     SgExprStatement* expr_stmt = NULL;
     expr_stmt = ir_methods::prepare_call_statement(body, indigo__init, params,
             statement);
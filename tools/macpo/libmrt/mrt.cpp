@@ -25,23 +25,43 @@
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE
 #endif
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
 #include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <algorithm>
 #include <cstdarg>
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
 #include <vector>
 #include <utility>
 
+// OMPT is only provided by some OpenMP runtimes (LLVM, Intel).
+#if defined(__has_include)
+#if __has_include(<omp-tools.h>)
+#include <omp-tools.h>
+#define HAVE_OMPT
+#endif
+#endif
+
 #include "avl_tree.h"
 #include "elf_reader.h"
 #include "generic_defs.h"
 #include "histogram.h"
+#include "hyperloglog.h"
 #include "mrt.h"
+#include "mrt_heap.h"
 #include "macpo_record.h"
+#include "rank_select.h"
 
 typedef std::pair<int64_t, int16_t> val_idx_pair;
 typedef std::pair<int, int16_t> line_threadid_pair;
@@ -58,6 +78,48 @@ typedef std::map<int64_t, long_histogram> long_histogram_coll;
 static const int DIST_INFINITY = 40 * 1024 * 1024 / 64;
 static const int RECORD_THRESHOLD = 512;
 
+// Capacity (power of two) of the per-thread table of instrumentation sites
+// used in aggregate mode.
+static const int AGGREGATE_SITES = 1024;
+
+// Pages whose NUMA node is queried together, and the capacity (power of
+// two) of the per-thread cache of pages that were already queried.
+static const int NUMA_BATCH = 512;
+static const int NUMA_CACHE = 4096;
+static const size_t NUMA_PENDING = (size_t) 1 << 63;
+static const int PAGE_SHIFT_4K = 12;
+
+// Without OMPT, the OpenMP state of a thread is looked up again only when
+// it enters or leaves a parallel region, or after this many records, since
+// a worker thread can move to another region without leaving parallel code.
+static const int OMP_STATE_REFRESH = 4096;
+
+// Capacity of the shared memory segment used for node-local output. The
+// segment is written out whenever it fills up, so it only needs to absorb
+// the records written while that happens. It is made smaller if /dev/shm
+// is short on space, but not smaller than the minimum.
+static const uint64_t NODE_SEGMENT_RECORDS = 1 << 16;
+static const uint64_t NODE_SEGMENT_MIN_RECORDS = 1 << 10;
+
+// A rank copies a single record into a slot that it claimed, so a slot that
+// is still not filled after this many seconds belongs to a rank that died
+// or hung, and its record is given up.
+static const int NODE_SEGMENT_TIMEOUT = 5;
+
+// Spin loops give up the processor after this many iterations, and the rank
+// that waits for the flush lock checks this often whether its holder is
+// still alive.
+static const int SPIN_YIELD = 64;
+static const int SPIN_OWNER_CHECK = 4096;
+
+// Heap objects are spread over shards by the 1 MB chunk of the address space
+// they lie in, so that threads allocating from different arenas do not
+// contend. Objects that cross a chunk boundary are kept in one extra shard.
+// Each thread caches the allocation sites it used last.
+static const int HEAP_SHARDS = 64;
+static const int HEAP_CHUNK_SHIFT = 20;
+static const int ALLOC_SITE_CACHE = 64;
+
 typedef struct _tag_source_location {
     int64_t line_number;
     void* function_address;
@@ -68,6 +130,99 @@ typedef struct _tag_source_location {
     }
 } src_location_t;
 
+typedef struct {
+    bool used;
+    size_t line_number;
+    size_t var_idx;
+    uint64_t read_count;
+    uint64_t write_count;
+    uint64_t byte_count;
+    hyperloglog_t* cache_lines;     // Allocated when the site is first used.
+} aggregate_site_t;
+
+typedef struct _tag_aggregate_table {
+    aggregate_site_t sites[AGGREGATE_SITES];
+    size_t last_site;
+    size_t dropped_count;
+    struct _tag_aggregate_table* next;
+} aggregate_table_t;
+
+typedef std::pair<size_t, size_t> site_key_t;
+
+// Header of the shared memory segment that all instrumented ranks of a
+// node append their records to. The rank that creates the segment sets the
+// capacity and then marks it ready; the others wait for that before they
+// attach. record_count is the number of slots that were handed out and
+// committed_count the number of them that hold a complete record; the slot
+// flags that follow the records tell which ones. flush_owner is the process
+// ID of the rank that writes the segment out, or zero.
+typedef struct {
+    volatile int32_t ready;
+    volatile int32_t attach_count;
+    volatile int32_t flush_owner;
+    volatile uint64_t capacity;
+    volatile uint64_t record_count;
+    volatile uint64_t committed_count;
+} node_segment_t;
+
+// Pages are queued by the thread that owns the table and resolved by the
+// NUMA thread, one batch at a time, while the owner fills the other batch.
+// A cached page is marked with NUMA_PENDING until its node is known, and
+// is cleared again if the query failed so that it is retried.
+typedef struct _tag_numa_table {
+    volatile size_t cached_pages[NUMA_CACHE];   // Page number plus one, or 0.
+    void* pending_pages[2][NUMA_BATCH];
+    int pending_count[2];
+    volatile int submitted[2];  // Batch is waiting for the NUMA thread.
+    int active;                 // Batch that the owner fills.
+    struct _tag_numa_table* next;
+} numa_table_t;
+
+typedef struct {
+    size_t end;
+    int site_idx;
+} heap_object_t;
+
+typedef struct {
+    void* return_address;
+    size_t alloc_count;
+    size_t alloc_bytes;
+} alloc_site_t;
+
+// Live heap objects never overlap, so a map keyed on the start address
+// works as an interval tree: upper_bound() followed by one step back finds
+// the only object that may contain a given address.
+typedef std::map<size_t, heap_object_t> heap_object_map_t;
+typedef std::map<void*, int> alloc_site_map_t;
+typedef std::deque<alloc_site_t> alloc_site_list_t;
+
+// Every recorded access looks up its heap object, while only allocations
+// and releases change the map, so lookups share the lock.
+typedef struct {
+    pthread_rwlock_t lock;
+    heap_object_map_t* objects;
+} __attribute__((aligned(64))) heap_shard_t;
+
+typedef struct {
+    void* return_address;
+    alloc_site_t* alloc_site;   // Stays in place as the deque grows.
+    int site_idx;
+} alloc_site_cache_t;
+
+typedef struct {
+    const void* return_address;     // NULL if the region is not known.
+    size_t instance_count;
+} region_t;
+
+typedef struct {
+    int region_idx;     // -1 outside of parallel regions.
+    uint16_t thread_num;
+    uint16_t team_size;
+} omp_state_t;
+
+typedef std::map<const void*, int> region_map_t;
+typedef std::vector<region_t> region_list_t;
+
 bool operator<(const src_location_t& left, const src_location_t& right) {
     return left.function_address < right.function_address ||
         (left.function_address == right.function_address &&
@@ -96,27 +251,83 @@ static volatile sig_atomic_t sleeping = 0;
 static volatile sig_atomic_t access_count = 0;
 
 static int fd = -1;
+static int mpi_rank = 0;
+static node_segment_t* node_segment = NULL;
+static node_t* node_record_list = NULL;
+static volatile uint8_t* node_slot_list = NULL;
+static size_t node_segment_size = 0;
+static char node_segment_name[NAME_MAX];
+static __thread volatile sig_atomic_t in_node_write = 0;
+static __thread volatile sig_atomic_t terminal_pending = 0;
 static int sleep_sec = 0;
 static int new_sleep_sec = 1;
-static int *intel_apic_mapping = NULL;
+static int *apic_mapping = NULL;
 static node_t terminal_node;
 static size_t numCores = 0;
 
 static std::vector<std::string> stream_list;
 
+static bool aggregate_mode = false;
+static aggregate_table_t* aggregate_table_list = NULL;
+
+// Allocated on the heap and never freed so that they remain usable
+// from malloc() and free() calls made during static destruction.
+static bool heap_tracking = false;
+static heap_shard_t heap_shards[HEAP_SHARDS + 1];
+static alloc_site_map_t* alloc_site_map = NULL;
+static alloc_site_list_t* alloc_site_list = NULL;
+static pthread_mutex_t alloc_site_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Bounds of the addresses that were ever tracked, and the number of live
+// objects in the shard for objects that cross a chunk boundary.
+static volatile size_t heap_low = ~(size_t) 0;
+static volatile size_t heap_high = 0;
+static volatile size_t spanning_count = 0;
+
+static bool numa_sampling = false;
+static numa_table_t* volatile numa_table_list = NULL;
+static pthread_t numa_thread;
+static pthread_mutex_t numa_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t numa_cond = PTHREAD_COND_INITIALIZER;
+static int numa_submitted = 0;
+static bool numa_stopped = false;
+
+static region_map_t* region_map = NULL;
+static region_list_t* region_list = NULL;
+static bool ompt_active = false;
+
 static __thread int coreID = -1;
+static __thread aggregate_table_t* aggregate_table = NULL;
+static __thread numa_table_t* numa_table = NULL;
+static __thread bool in_heap_hook = false;
+static __thread alloc_site_cache_t alloc_site_cache[ALLOC_SITE_CACHE];
 static __thread avl_tree* tree = NULL;
 static __thread rdhist* histogram_list[MAX_VARIABLES];
+static __thread omp_state_t omp_state = { -1, 0, 1 };
+static __thread int omp_state_countdown = 0;
 
 static volatile int16_t global_lock = 0;
 
+// Called once per iteration of a spin loop, so that the loop neither
+// starves the other hardware thread of the core nor a lock holder that was
+// descheduled.
+static inline void spin_pause(int* spins) {
+    *spins += 1;
+    if (*spins % SPIN_YIELD == 0) {
+        sched_yield();
+    } else {
+        asm volatile("pause" ::: "memory");
+    }
+}
+
 static inline void lock(volatile int16_t* lock_var) {
     if (lock_var == NULL) {
         return;
     }
 
+    int spins = 0;
     while (__sync_bool_compare_and_swap(lock_var, 0, 1) == false) {
-        // do nothing.
+        spin_pause(&spins);
     }
 
     asm volatile("lfence" ::: "memory");
@@ -131,6 +342,169 @@ static inline void unlock(volatile int16_t* lock_var) {
     asm volatile("sfence" ::: "memory");
 }
 
+// Takes the flush lock of the node segment. The lock is taken over from a
+// rank that died while holding it.
+static void lock_node_segment() {
+    const pid_t self = getpid();
+
+    int spins = 0;
+    while (true) {
+        pid_t owner = node_segment->flush_owner;
+        if (owner == 0 || (spins % SPIN_OWNER_CHECK == SPIN_OWNER_CHECK - 1 &&
+                    kill(owner, 0) != 0 && errno == ESRCH)) {
+            if (__sync_bool_compare_and_swap(&node_segment->flush_owner,
+                        owner, self)) {
+                break;
+            }
+        }
+
+        spin_pause(&spins);
+    }
+
+    __sync_synchronize();
+}
+
+static void unlock_node_segment() {
+    __sync_synchronize();
+    node_segment->flush_owner = 0;
+}
+
+static double get_monotonic_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Appends the filled ones of the first count slots of the node segment to
+// the node log.
+static void write_node_log(uint64_t count, bool complete) {
+    char hostname[HOST_NAME_MAX + 1] = {0};
+    gethostname(hostname, sizeof(hostname) - 1);
+
+    char filename[PATH_MAX];
+    snprintf(filename, sizeof(filename), "macpo.%s%s.out", hostname,
+            strchr(node_segment_name, '.'));
+
+    int node_fd = open(filename, O_CREAT | O_APPEND | O_WRONLY, S_IRUSR |
+            S_IWUSR | S_IRGRP);
+    if (node_fd < 0) {
+        perror("MACPO :: Error opening node log for writing");
+        return;
+    }
+
+    uint64_t begin = 0;
+    while (begin < count) {
+        // Write the slots in runs of filled ones.
+        uint64_t end = begin;
+        if (complete) {
+            end = count;
+        } else {
+            while (begin < count && node_slot_list[begin] == 0) {
+                begin += 1;
+            }
+
+            end = begin;
+            while (end < count && node_slot_list[end] != 0) {
+                end += 1;
+            }
+        }
+
+        const char* buffer =
+            reinterpret_cast<const char*>(node_record_list + begin);
+        size_t remaining = (end - begin) * sizeof(node_t);
+        while (remaining > 0) {
+            ssize_t written = write(node_fd, buffer, remaining);
+            if (written <= 0) {
+                perror("MACPO :: Error writing node log");
+                break;
+            }
+
+            buffer += written;
+            remaining -= written;
+        }
+
+        begin = end;
+    }
+
+    close(node_fd);
+}
+
+// Writes out the node segment and empties it. The caller holds the flush
+// lock.
+static void drain_node_segment() {
+    // Pushing record_count past the capacity makes writers that arrive from
+    // now on wait for the lock instead of claiming a slot.
+    const uint64_t capacity = node_segment->capacity;
+    uint64_t count = __sync_fetch_and_add(&node_segment->record_count,
+            capacity);
+    if (count > capacity) {
+        count = capacity;
+    }
+
+    // Writers that claimed a slot before that still have to fill it.
+    int spins = 0;
+    double deadline = get_monotonic_time() + NODE_SEGMENT_TIMEOUT;
+    while (node_segment->committed_count < count) {
+        spin_pause(&spins);
+        if (spins % SPIN_YIELD == 0 && get_monotonic_time() > deadline) {
+            break;
+        }
+    }
+
+    uint64_t committed = node_segment->committed_count;
+    if (committed < count) {
+        fprintf(stderr, "MACPO :: Dropping %llu records of the node log that "
+                "were not completed in time.\n",
+                (unsigned long long) (count - committed));
+    }
+
+    write_node_log(count, committed >= count);
+
+    memset(const_cast<uint8_t*>(node_slot_list), 0, count);
+    node_segment->committed_count = 0;
+    __sync_synchronize();
+    node_segment->record_count = 0;
+}
+
+static inline void write_node(node_t* node) {
+    node->rank = mpi_rank;
+
+    if (node_segment == NULL) {
+        write(fd, node, sizeof(node_t));
+        return;
+    }
+
+    // The timer signal may arrive while this thread holds a slot or the
+    // flush lock, so the handler leaves its record for us to write.
+    in_node_write = 1;
+    while (true) {
+        uint64_t index = __sync_fetch_and_add(&node_segment->record_count, 1);
+        if (index < node_segment->capacity) {
+            node_record_list[index] = *node;
+            __sync_synchronize();
+            node_slot_list[index] = 1;
+            __sync_fetch_and_add(&node_segment->committed_count, 1);
+            break;
+        }
+
+        // The segment is full. The first rank to get here writes it out,
+        // the others wait for the lock and then retry.
+        lock_node_segment();
+        if (node_segment->record_count >= node_segment->capacity) {
+            drain_node_segment();
+        }
+
+        unlock_node_segment();
+    }
+
+    in_node_write = 0;
+
+    if (terminal_pending) {
+        terminal_pending = 0;
+        write_node(&terminal_node);
+    }
+}
+
 static bool index_comparator(const val_idx_pair& v1, const val_idx_pair& v2) {
     return v1.first < v2.first;
 }
@@ -157,53 +531,51 @@ static int get_proc_kind() {
     return proc;
 }
 
+static int read_apic_id() {
+    int info[4];
+    __cpuid(info, 0, 0);
+    if (info[EAX] >= 0xB) {
+        __cpuid(info, 0xB, 0);
+        if (info[EBX] != 0) {   // x2APIC
+            __cpuid(info, 0xB, 2);
+            return info[EDX];
+        }
+    }
+
+    // Traditonal APIC
+    __cpuid(info, 1, 0);
+    return (info[EBX] & 0xff000000) >> 24;
+}
+
+// Returns the OS index of the CPU that runs this thread, which is also how
+// cores are named in the topology records.
 static int getCoreID() {
     if (coreID != -1)
         return coreID;
 
-    int info[4];
     if (!isCPUIDSupported()) {
         coreID = 0;
         return coreID;  // default
     }
 
-    int proc = get_proc_kind();
-    if (proc == PROC_AMD) {
-        __cpuid(info, 1, 0);
-        coreID = (info[1] & 0xff000000) >> 24;
-        return coreID;
-    } else if (proc == PROC_INTEL) {
-        int apic_id = 0;
-        __cpuid(info, 0xB, 0);
-        if (info[EBX] != 0) {   // x2APIC
-            __cpuid(info, 0xB, 2);
-            apic_id = info[EDX];
+    // Not known until set_thread_affinity() has run.
+    if (apic_mapping == NULL) {
+        return 0;
+    }
 
-#ifdef DEBUG_PRINT
-            fprintf(stderr, "MACPO :: Request from core with x2APIC ID "
-                "%d\n", apic_id);
-#endif
-        } else {    // Traditonal APIC
-            __cpuid(info, 1, 0);
-            apic_id = (info[EBX] & 0xff000000) >> 24;
+    int apic_id = read_apic_id();
 
 #ifdef DEBUG_PRINT
-            fprintf(stderr, "MACPO :: Request from core with legacy APIC ID "
-                    "%d\n", apic_id);
+    fprintf(stderr, "MACPO :: Request from core with APIC ID %d\n", apic_id);
 #endif
-        }
 
-        int i;
-        for (i = 0; i < numCores; i++) {
-            if (apic_id == intel_apic_mapping[i])
-                break;
-        }
-
-        coreID = i == numCores ? 0 : i;
-        return coreID;
+    int i;
+    for (i = 0; i < numCores; i++) {
+        if (apic_id == apic_mapping[i])
+            break;
     }
 
-    coreID = 0;
+    coreID = i == numCores ? 0 : i;
     return coreID;
 }
 
@@ -848,13 +1220,448 @@ void print_stride_check_results(const src_location_t& location) {
     }
 }
 
+static void write_aggregate_records() {
+    typedef std::map<site_key_t, aggregate_site_t*> site_map_t;
+
+    site_map_t site_map;
+    size_t dropped_count = 0;
+
+    // Merge the tables of all threads. Each site also contributes to the
+    // totals of its variable, which are stored under line number zero.
+    lock(&global_lock);
+    for (aggregate_table_t* table = aggregate_table_list; table != NULL;
+            table = table->next) {
+        dropped_count += table->dropped_count;
+
+        for (int i = 0; i < AGGREGATE_SITES; i++) {
+            const aggregate_site_t& site = table->sites[i];
+            if (site.used == false) {
+                continue;
+            }
+
+            site_key_t keys[2] = { site_key_t(site.var_idx, site.line_number),
+                site_key_t(site.var_idx, 0) };
+
+            for (int k = 0; k < 2; k++) {
+                aggregate_site_t*& merged = site_map[keys[k]];
+                if (merged == NULL) {
+                    merged = new aggregate_site_t();
+                    merged->used = true;
+                    merged->var_idx = keys[k].first;
+                    merged->line_number = keys[k].second;
+                    merged->cache_lines = new hyperloglog_t();
+                }
+
+                merged->read_count += site.read_count;
+                merged->write_count += site.write_count;
+                merged->byte_count += site.byte_count;
+                merged->cache_lines->merge(*site.cache_lines);
+            }
+        }
+    }
+    unlock(&global_lock);
+
+    for (site_map_t::iterator it = site_map.begin(); it != site_map.end();
+            it++) {
+        aggregate_site_t* merged = it->second;
+
+        node_t node;
+        node.type_message = MSG_AGGREGATE_INFO;
+        node.aggregate_info.line_number = merged->line_number;
+        node.aggregate_info.var_idx = merged->var_idx;
+        node.aggregate_info.read_count = merged->read_count;
+        node.aggregate_info.write_count = merged->write_count;
+        node.aggregate_info.byte_count = merged->byte_count;
+        node.aggregate_info.distinct_lines = merged->cache_lines->estimate();
+
+        write_node(&node);
+        delete merged->cache_lines;
+        delete merged;
+    }
+
+    if (dropped_count > 0) {
+        fprintf(stderr, "MACPO :: Too many instrumentation sites, %zu "
+                "accesses were not aggregated.\n", dropped_count);
+    }
+}
+
+static void flush_numa_pages(numa_table_t* table, int batch) {
+    void** pages = table->pending_pages[batch];
+    const int count = table->pending_count[batch];
+    int status[NUMA_BATCH];
+
+    // With no target nodes, move_pages() only reports where pages are.
+    if (syscall(SYS_move_pages, 0, count, pages, NULL, status, 0) != 0) {
+        for (int i = 0; i < count; i++) {
+            status[i] = -1;
+        }
+    }
+
+    node_t node;
+    node.type_message = MSG_PAGE_INFO;
+
+    for (int i = 0; i < count; i++) {
+        size_t page = reinterpret_cast<size_t>(pages[i]) >> PAGE_SHIFT_4K;
+        volatile size_t* cached_page =
+            &table->cached_pages[page & (NUMA_CACHE - 1)];
+
+        // Negative values are errors, e.g. for pages not yet touched. Such
+        // pages are dropped from the cache, unless the owner reused the
+        // slot in the meantime, so that they are queried again.
+        if (status[i] >= 0) {
+            node.page_info.page = page;
+            node.page_info.numa_node = status[i];
+            write_node(&node);
+
+            __sync_bool_compare_and_swap(cached_page,
+                    (page + 1) | NUMA_PENDING, page + 1);
+        } else {
+            __sync_bool_compare_and_swap(cached_page,
+                    (page + 1) | NUMA_PENDING, 0);
+        }
+    }
+
+    table->pending_count[batch] = 0;
+    __sync_synchronize();
+    table->submitted[batch] = 0;
+}
+
+// Resolves the batches that threads submit, so that the system calls are
+// kept out of the recorded accesses.
+static void* numa_thread_main(void* arg) {
+    pthread_mutex_lock(&numa_mutex);
+    while (true) {
+        while (numa_submitted == 0 && numa_stopped == false) {
+            pthread_cond_wait(&numa_cond, &numa_mutex);
+        }
+
+        if (numa_submitted == 0) {
+            break;
+        }
+
+        numa_submitted = 0;
+        pthread_mutex_unlock(&numa_mutex);
+
+        for (numa_table_t* table = numa_table_list; table != NULL;
+                table = table->next) {
+            for (int batch = 0; batch < 2; batch++) {
+                if (table->submitted[batch]) {
+                    flush_numa_pages(table, batch);
+                }
+            }
+        }
+
+        pthread_mutex_lock(&numa_mutex);
+    }
+    pthread_mutex_unlock(&numa_mutex);
+
+    return NULL;
+}
+
+static void init_numa_sampling() {
+    if (pthread_create(&numa_thread, NULL, numa_thread_main, NULL) != 0) {
+        fprintf(stderr, "MACPO :: Failed to start NUMA thread, NUMA "
+                "sampling is disabled.\n");
+        return;
+    }
+
+    numa_sampling = true;
+}
+
+static void write_numa_records() {
+    // The NUMA thread resolves what was submitted before it stops.
+    pthread_mutex_lock(&numa_mutex);
+    numa_stopped = true;
+    pthread_cond_signal(&numa_cond);
+    pthread_mutex_unlock(&numa_mutex);
+    pthread_join(numa_thread, NULL);
+
+    lock(&global_lock);
+    for (numa_table_t* table = numa_table_list; table != NULL;
+            table = table->next) {
+        for (int batch = 0; batch < 2; batch++) {
+            if (table->pending_count[batch] > 0) {
+                flush_numa_pages(table, batch);
+            }
+        }
+    }
+    unlock(&global_lock);
+}
+
+static void write_alloc_site_records(elf_reader_t& elf_reader) {
+    // Nothing allocated from here on needs to be attributed.
+    heap_tracking = false;
+
+    for (int i = 0; i < alloc_site_list->size(); i++) {
+        const alloc_site_t& alloc_site = alloc_site_list->at(i);
+        bfd_vma vma = reinterpret_cast<bfd_vma>(alloc_site.return_address);
+        const elf_reader_t::location_t location =
+            elf_reader.translate_address(vma);
+
+        std::string file_name = location.filename;
+        const std::string rose_prefix = "rose_";
+        if (file_name.find(rose_prefix) == 0) {
+            file_name.erase(0, rose_prefix.size());
+        }
+
+        node_t node;
+        node.type_message = MSG_ALLOC_SITE_INFO;
+        node.alloc_site_info.site_idx = i;
+        node.alloc_site_info.alloc_count = alloc_site.alloc_count;
+        node.alloc_site_info.alloc_bytes = alloc_site.alloc_bytes;
+        snprintf(node.alloc_site_info.location,
+                sizeof(node.alloc_site_info.location), "%s:%d",
+                file_name.c_str(), location.line_number);
+
+        write_node(&node);
+    }
+}
+
+static void write_region_records(elf_reader_t& elf_reader) {
+    lock(&global_lock);
+    for (int i = 0; i < region_list->size(); i++) {
+        const region_t& region = region_list->at(i);
+
+        node_t node;
+        node.type_message = MSG_REGION_INFO;
+        node.region_info.region_idx = i;
+        node.region_info.instance_count = region.instance_count;
+
+        if (region.return_address == NULL) {
+            snprintf(node.region_info.location,
+                    sizeof(node.region_info.location), "unknown");
+        } else {
+            bfd_vma vma = reinterpret_cast<bfd_vma>(region.return_address);
+            const elf_reader_t::location_t location =
+                elf_reader.translate_address(vma);
+
+            std::string file_name = location.filename;
+            const std::string rose_prefix = "rose_";
+            if (file_name.find(rose_prefix) == 0) {
+                file_name.erase(0, rose_prefix.size());
+            }
+
+            snprintf(node.region_info.location,
+                    sizeof(node.region_info.location), "%s:%d",
+                    file_name.c_str(), location.line_number);
+        }
+
+        write_node(&node);
+    }
+    unlock(&global_lock);
+}
+
+// Returns the value of the first of the variables that is set.
+static const char* get_first_env(const char* const* name_list) {
+    for (int i = 0; name_list[i] != NULL; i++) {
+        const char* value = getenv(name_list[i]);
+        if (value != NULL) {
+            return value;
+        }
+    }
+
+    return NULL;
+}
+
+static int get_mpi_rank() {
+    // Set by the launchers of Open MPI, MPICH / Intel MPI, PMIx, MVAPICH2
+    // and SLURM respectively.
+    static const char* const rank_variables[] = { "OMPI_COMM_WORLD_RANK",
+        "PMI_RANK", "PMIX_RANK", "MV2_COMM_WORLD_RANK", "SLURM_PROCID",
+        NULL };
+
+    const char* value = get_first_env(rank_variables);
+    return value == NULL ? 0 : atoi(value);
+}
+
+// Writes out the records that are left once the last rank of this node
+// detaches from the segment. A rank may still attach while that happens;
+// it keeps using the segment and the last rank to detach writes the rest.
+static void detach_node_segment() {
+    if (__sync_sub_and_fetch(&node_segment->attach_count, 1) == 0) {
+        lock_node_segment();
+        drain_node_segment();
+        unlock_node_segment();
+
+        // Ranks that start from now on use a new segment, and append to
+        // the same file.
+        shm_unlink(node_segment_name);
+    }
+
+    munmap(node_segment, node_segment_size);
+    node_segment = NULL;
+}
+
+// Returns the start time of a process in clock ticks since boot, or zero.
+static uint64_t get_start_time(pid_t pid) {
+    char filename[PATH_MAX];
+    snprintf(filename, sizeof(filename), "/proc/%d/stat", pid);
+
+    FILE* stat_file = fopen(filename, "r");
+    if (stat_file == NULL) {
+        return 0;
+    }
+
+    char buffer[1024] = {0};
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, stat_file);
+    fclose(stat_file);
+    buffer[length] = '\0';
+
+    // The process name may contain spaces, so count the fields from the
+    // parenthesis that closes it. The start time is the 22nd field.
+    const char* ptr = strrchr(buffer, ')');
+    for (int field = 2; ptr != NULL && field < 22; field++) {
+        ptr = strchr(ptr + 1, ' ');
+    }
+
+    return ptr == NULL ? 0 : strtoull(ptr + 1, NULL, 10);
+}
+
+// Creates the segment, sized to what /dev/shm can hold. The space is
+// allocated up front, so running out of it is reported here instead of
+// raising SIGBUS when a record is written.
+static void* create_node_segment(int shm_fd) {
+    uint64_t capacity = NODE_SEGMENT_RECORDS;
+
+    struct statvfs shm_stat;
+    if (fstatvfs(shm_fd, &shm_stat) == 0) {
+        // Leave half of the free space to others.
+        uint64_t available = shm_stat.f_bavail * shm_stat.f_frsize / 2;
+        if (available < sizeof(node_segment_t) +
+                capacity * (sizeof(node_t) + 1)) {
+            capacity = (available - std::min<uint64_t>(available,
+                        sizeof(node_segment_t))) / (sizeof(node_t) + 1);
+        }
+    }
+
+    if (capacity < NODE_SEGMENT_MIN_RECORDS) {
+        fprintf(stderr, "MACPO :: Not enough space in /dev/shm for the node "
+                "log segment.\n");
+        return MAP_FAILED;
+    }
+
+    node_segment_size = sizeof(node_segment_t) +
+        capacity * (sizeof(node_t) + 1);
+
+    int error = posix_fallocate(shm_fd, 0, node_segment_size);
+    if (error != 0) {
+        fprintf(stderr, "MACPO :: Error allocating node log segment: %s\n",
+                strerror(error));
+        return MAP_FAILED;
+    }
+
+    void* base = mmap(NULL, node_segment_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED, shm_fd, 0);
+    if (base == MAP_FAILED) {
+        perror("MACPO :: Error mapping node log segment");
+        return MAP_FAILED;
+    }
+
+    node_segment_t* segment = reinterpret_cast<node_segment_t*>(base);
+    segment->capacity = capacity;
+    __sync_synchronize();
+    segment->ready = 1;
+    return base;
+}
+
+// Maps a segment that another rank created, once that rank has set it up.
+static void* open_node_segment(int shm_fd) {
+    const int attempts = 1000;
+
+    for (int i = 0; i < attempts; i++) {
+        struct stat shm_stat;
+        if (fstat(shm_fd, &shm_stat) == 0 &&
+                shm_stat.st_size >= (off_t) sizeof(node_segment_t)) {
+            void* base = mmap(NULL, shm_stat.st_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, shm_fd, 0);
+            if (base == MAP_FAILED) {
+                perror("MACPO :: Error mapping node log segment");
+                return MAP_FAILED;
+            }
+
+            if (reinterpret_cast<node_segment_t*>(base)->ready) {
+                node_segment_size = shm_stat.st_size;
+                return base;
+            }
+
+            munmap(base, shm_stat.st_size);
+        }
+
+        usleep(1000);
+    }
+
+    fprintf(stderr, "MACPO :: Timed out waiting for node log segment.\n");
+    return MAP_FAILED;
+}
+
+static bool attach_node_segment() {
+    // The segment is named after the job so that the ranks of the same job
+    // on this node share it.
+    static const char* const job_variables[] = { "SLURM_JOB_ID", "PBS_JOBID",
+        "LSB_JOBID", "OMPI_MCA_ess_base_jobid", NULL };
+
+    const char* job_id = get_first_env(job_variables);
+    if (job_id != NULL) {
+        snprintf(node_segment_name, sizeof(node_segment_name),
+                "/macpo.%s", job_id);
+    } else {
+        // Ranks started by the same launcher share its process ID. Process
+        // IDs are reused, so the start time of the launcher is part of the
+        // name too, which keeps a segment that an earlier run left behind
+        // from being picked up.
+        pid_t launcher = getppid();
+        snprintf(node_segment_name, sizeof(node_segment_name),
+                "/macpo.%d.%lu", launcher, get_start_time(launcher));
+    }
+
+    // Exactly one rank creates the segment, the others open it.
+    void* base = MAP_FAILED;
+    int shm_fd = shm_open(node_segment_name, O_CREAT | O_EXCL | O_RDWR,
+            S_IRUSR | S_IWUSR);
+    if (shm_fd >= 0) {
+        base = create_node_segment(shm_fd);
+        if (base == MAP_FAILED) {
+            shm_unlink(node_segment_name);
+        }
+    } else if (errno == EEXIST) {
+        shm_fd = shm_open(node_segment_name, O_RDWR, S_IRUSR | S_IWUSR);
+        if (shm_fd >= 0) {
+            base = open_node_segment(shm_fd);
+        }
+    }
+
+    if (shm_fd < 0) {
+        perror("MACPO :: Error opening node log segment");
+        return false;
+    }
+
+    if (base == MAP_FAILED) {
+        close(shm_fd);
+        return false;
+    }
+
+    node_segment = reinterpret_cast<node_segment_t*>(base);
+    node_record_list = reinterpret_cast<node_t*>(node_segment + 1);
+    node_slot_list = reinterpret_cast<volatile uint8_t*>(node_record_list +
+            node_segment->capacity);
+    __sync_add_and_fetch(&node_segment->attach_count, 1);
+
+    // The descriptor only marks this process as recording from now on.
+    fd = shm_fd;
+    return true;
+}
+
 void indigo__exit() {
-    if (fd >= 0) {
-        close(fd);
+    if (aggregate_mode && fd >= 0) {
+        write_aggregate_records();
+    }
+
+    if (numa_sampling && fd >= 0) {
+        write_numa_records();
     }
 
-    if (intel_apic_mapping) {
-        free(intel_apic_mapping);
+    if (apic_mapping) {
+        free(apic_mapping);
     }
 
     // Get the name of the executable file.
@@ -875,6 +1682,14 @@ void indigo__exit() {
         // this binary is freed upon processing all loop hotspots.
         elf_reader_t elf_reader(binary_path);
 
+        if (heap_tracking && fd >= 0) {
+            write_alloc_site_records(elf_reader);
+        }
+
+        if (region_list != NULL && fd >= 0) {
+            write_region_records(elf_reader);
+        }
+
         for (src_location_list_t::iterator it = analyzed_loops.begin();
                 it != analyzed_loops.end(); it++) {
             const src_location_t& loc = *it;
@@ -909,6 +1724,14 @@ void indigo__exit() {
         }
     }
 
+    if (node_segment != NULL) {
+        detach_node_segment();
+    }
+
+    if (fd >= 0) {
+        close(fd);
+    }
+
     fprintf(stderr, "\n==== Reuse distance metrics ====");
 
     for (int i = 0; i < MAX_VARIABLES; i++) {
@@ -1047,7 +1870,7 @@ void indigo__vector_stride_c(int loop_line_number, int var_idx, void* addr,
     node.vector_stride_info.loop_line_number = loop_line_number;
     node.vector_stride_info.type_size = type_size;
 
-    write(fd, &node, sizeof(node_t));
+    write_node(&node);
 }
 
 /**
@@ -1364,6 +2187,348 @@ void indigo__reuse_dist_c(int var_id, void* address) {
     tree->insert(&mem_info);
 }
 
+static void init_heap_tracking() {
+    in_heap_hook = true;
+    for (int i = 0; i <= HEAP_SHARDS; i++) {
+        pthread_rwlock_init(&heap_shards[i].lock, NULL);
+        heap_shards[i].objects = new heap_object_map_t();
+    }
+
+    alloc_site_map = new alloc_site_map_t();
+    alloc_site_list = new alloc_site_list_t();
+    in_heap_hook = false;
+
+    asm volatile("" ::: "memory");
+    heap_tracking = true;
+}
+
+static inline heap_shard_t& get_heap_shard(size_t address) {
+    return heap_shards[(address >> HEAP_CHUNK_SHIFT) % HEAP_SHARDS];
+}
+
+static inline bool is_heap_address(size_t address) {
+    return address >= heap_low && address < heap_high;
+}
+
+static const alloc_site_cache_t& get_alloc_site_entry(void* return_address) {
+    alloc_site_cache_t& entry = alloc_site_cache[
+        (reinterpret_cast<size_t>(return_address) >> 2) % ALLOC_SITE_CACHE];
+    if (entry.return_address == return_address && entry.alloc_site != NULL) {
+        return entry;
+    }
+
+    pthread_mutex_lock(&alloc_site_mutex);
+    std::pair<alloc_site_map_t::iterator, bool> result =
+        alloc_site_map->insert(std::make_pair(return_address,
+                    static_cast<int>(alloc_site_list->size())));
+    if (result.second) {
+        alloc_site_t alloc_site = { return_address, 0, 0 };
+        alloc_site_list->push_back(alloc_site);
+    }
+
+    entry.return_address = return_address;
+    entry.site_idx = result.first->second;
+    entry.alloc_site = &alloc_site_list->at(entry.site_idx);
+    pthread_mutex_unlock(&alloc_site_mutex);
+
+    return entry;
+}
+
+void mrt_track_allocation(void* ptr, size_t size, void* return_address) {
+    // Allocations made by the maps themselves must not be tracked.
+    if (heap_tracking == false || in_heap_hook || ptr == NULL) {
+        return;
+    }
+
+    in_heap_hook = true;
+
+    const alloc_site_cache_t& entry = get_alloc_site_entry(return_address);
+    __sync_fetch_and_add(&entry.alloc_site->alloc_count, 1);
+    __sync_fetch_and_add(&entry.alloc_site->alloc_bytes, size);
+
+    size_t start = reinterpret_cast<size_t>(ptr);
+    size_t end = start + (size == 0 ? 1 : size);
+
+    size_t low = heap_low;
+    while (start < low && !__sync_bool_compare_and_swap(&heap_low, low,
+                start)) {
+        low = heap_low;
+    }
+
+    size_t high = heap_high;
+    while (end > high && !__sync_bool_compare_and_swap(&heap_high, high,
+                end)) {
+        high = heap_high;
+    }
+
+    heap_shard_t* shard = &get_heap_shard(start);
+    if ((start >> HEAP_CHUNK_SHIFT) != ((end - 1) >> HEAP_CHUNK_SHIFT)) {
+        shard = &heap_shards[HEAP_SHARDS];
+        __sync_fetch_and_add(&spanning_count, 1);
+    }
+
+    heap_object_t heap_object = { end, entry.site_idx };
+    pthread_rwlock_wrlock(&shard->lock);
+    (*shard->objects)[start] = heap_object;
+    pthread_rwlock_unlock(&shard->lock);
+
+    in_heap_hook = false;
+}
+
+void mrt_untrack_allocation(void* ptr) {
+    if (heap_tracking == false || in_heap_hook || ptr == NULL) {
+        return;
+    }
+
+    // Released memory that was allocated before tracking started.
+    size_t start = reinterpret_cast<size_t>(ptr);
+    if (!is_heap_address(start)) {
+        return;
+    }
+
+    in_heap_hook = true;
+
+    heap_shard_t& shard = get_heap_shard(start);
+    pthread_rwlock_wrlock(&shard.lock);
+    size_t erased = shard.objects->erase(start);
+    pthread_rwlock_unlock(&shard.lock);
+
+    if (erased == 0 && spanning_count > 0) {
+        heap_shard_t& spanning = heap_shards[HEAP_SHARDS];
+        pthread_rwlock_wrlock(&spanning.lock);
+        erased = spanning.objects->erase(start);
+        pthread_rwlock_unlock(&spanning.lock);
+
+        if (erased != 0) {
+            __sync_fetch_and_sub(&spanning_count, 1);
+        }
+    }
+
+    in_heap_hook = false;
+}
+
+// No other object starts between the start of an object and an address in
+// it, so a shard that holds the object finds it as a single map would.
+static inline int find_heap_object(heap_shard_t& shard, size_t address) {
+    int site_idx = -1;
+
+    pthread_rwlock_rdlock(&shard.lock);
+    heap_object_map_t::iterator it = shard.objects->upper_bound(address);
+    if (it != shard.objects->begin()) {
+        it--;
+        if (address < it->second.end) {
+            site_idx = it->second.site_idx;
+        }
+    }
+    pthread_rwlock_unlock(&shard.lock);
+
+    return site_idx;
+}
+
+static inline int get_alloc_site(size_t address) {
+    // Accesses to the stack and to static data skip the locks altogether.
+    if (heap_tracking == false || !is_heap_address(address)) {
+        return -1;
+    }
+
+    int site_idx = find_heap_object(get_heap_shard(address), address);
+    if (site_idx < 0 && spanning_count > 0) {
+        site_idx = find_heap_object(heap_shards[HEAP_SHARDS], address);
+    }
+
+    return site_idx;
+}
+
+// Resolved at link time only if the program uses OpenMP.
+extern "C" {
+int omp_get_thread_num() __attribute__((weak));
+int omp_get_num_threads() __attribute__((weak));
+int omp_in_parallel() __attribute__((weak));
+}
+
+static int register_region(const void* return_address) {
+    lock(&global_lock);
+    if (region_list == NULL) {
+        region_map = new region_map_t();
+        region_list = new region_list_t();
+    }
+
+    std::pair<region_map_t::iterator, bool> result =
+        region_map->insert(std::make_pair(return_address,
+                    static_cast<int>(region_list->size())));
+    if (result.second) {
+        region_t region = { return_address, 0 };
+        region_list->push_back(region);
+    }
+
+    int region_idx = result.first->second;
+    region_list->at(region_idx).instance_count += 1;
+    unlock(&global_lock);
+
+    return region_idx;
+}
+
+// Without OMPT, all parallel code is attributed to a single region whose
+// location is unknown.
+static int unknown_region = -1;
+static pthread_once_t unknown_region_once = PTHREAD_ONCE_INIT;
+
+static void register_unknown_region() {
+    unknown_region = register_region(NULL);
+}
+
+static inline const omp_state_t& get_omp_state() {
+    // With OMPT, the callbacks keep omp_state up to date.
+    if (ompt_active || omp_in_parallel == NULL) {
+        return omp_state;
+    }
+
+    // Otherwise, the cached state holds until the thread enters or leaves a
+    // parallel region, or until it is due for a refresh.
+    const bool in_parallel = omp_in_parallel();
+    if (in_parallel == (omp_state.region_idx != -1) &&
+            --omp_state_countdown > 0) {
+        return omp_state;
+    }
+
+    omp_state_countdown = OMP_STATE_REFRESH;
+    if (in_parallel) {
+        pthread_once(&unknown_region_once, register_unknown_region);
+
+        omp_state.region_idx = unknown_region;
+        omp_state.thread_num = omp_get_thread_num();
+        omp_state.team_size = omp_get_num_threads();
+    } else {
+        omp_state.region_idx = -1;
+        omp_state.thread_num = 0;
+        omp_state.team_size = 1;
+    }
+
+    return omp_state;
+}
+
+#ifdef HAVE_OMPT
+static void on_parallel_begin(ompt_data_t* encountering_task_data,
+        const ompt_frame_t* encountering_task_frame,
+        ompt_data_t* parallel_data, unsigned int requested_parallelism,
+        int flags, const void* codeptr_ra) {
+    parallel_data->value = register_region(codeptr_ra);
+}
+
+static void on_implicit_task(ompt_scope_endpoint_t endpoint,
+        ompt_data_t* parallel_data, ompt_data_t* task_data,
+        unsigned int actual_parallelism, unsigned int index, int flags) {
+    if (flags & ompt_task_initial) {
+        return;
+    }
+
+    if (endpoint == ompt_scope_begin) {
+        // Save the state of the enclosing region in the task so that it
+        // can be restored when a nested region ends.
+        task_data->value =
+            static_cast<uint64_t>(static_cast<uint32_t>(
+                        omp_state.region_idx)) << 32 |
+            static_cast<uint64_t>(omp_state.thread_num) << 16 |
+            omp_state.team_size;
+
+        omp_state.region_idx = parallel_data->value;
+        omp_state.thread_num = index;
+        omp_state.team_size = actual_parallelism;
+    } else {
+        omp_state.region_idx =
+            static_cast<int32_t>(task_data->value >> 32);
+        omp_state.thread_num = (task_data->value >> 16) & 0xffff;
+        omp_state.team_size = task_data->value & 0xffff;
+    }
+}
+
+static int ompt_initialize(ompt_function_lookup_t lookup,
+        int initial_device_num, ompt_data_t* tool_data) {
+    ompt_set_callback_t set_callback =
+        reinterpret_cast<ompt_set_callback_t>(lookup("ompt_set_callback"));
+    if (set_callback == NULL) {
+        return 0;
+    }
+
+    if (set_callback(ompt_callback_parallel_begin,
+                reinterpret_cast<ompt_callback_t>(on_parallel_begin)) !=
+                ompt_set_always ||
+            set_callback(ompt_callback_implicit_task,
+                reinterpret_cast<ompt_callback_t>(on_implicit_task)) !=
+                ompt_set_always) {
+        return 0;
+    }
+
+    ompt_active = true;
+    return 1;
+}
+
+static void ompt_finalize(ompt_data_t* tool_data) {
+}
+
+// Looked up by the OpenMP runtime when it starts. Executables have to
+// export this symbol (e.g. by linking with -rdynamic) for it to be found.
+extern "C" ompt_start_tool_result_t* ompt_start_tool(
+        unsigned int omp_version, const char* runtime_version) {
+    static ompt_start_tool_result_t result = { ompt_initialize,
+        ompt_finalize, { 0 } };
+    return &result;
+}
+#endif
+
+// Hands the active batch to the NUMA thread and switches to the other
+// one, unless that one was not resolved yet.
+static inline bool submit_numa_batch(numa_table_t* table) {
+    const int other = table->active ^ 1;
+    if (table->submitted[other]) {
+        return false;
+    }
+
+    table->submitted[table->active] = 1;
+    table->active = other;
+
+    pthread_mutex_lock(&numa_mutex);
+    numa_submitted += 1;
+    pthread_cond_signal(&numa_cond);
+    pthread_mutex_unlock(&numa_mutex);
+    return true;
+}
+
+static inline void sample_numa_page(size_t address) {
+    if (numa_table == NULL) {
+        numa_table = new numa_table_t();
+
+        lock(&global_lock);
+        numa_table->next = numa_table_list;
+        numa_table_list = numa_table;
+        unlock(&global_lock);
+    }
+
+    // Only pages missing from the cache are queued, and the queue is
+    // resolved with one system call once it is full.
+    size_t page = address >> PAGE_SHIFT_4K;
+    volatile size_t& cached_page =
+        numa_table->cached_pages[page & (NUMA_CACHE - 1)];
+    if ((cached_page & ~NUMA_PENDING) == page + 1) {
+        return;
+    }
+
+    // If the NUMA thread is behind, the page is sampled on a later access.
+    if (numa_table->pending_count[numa_table->active] == NUMA_BATCH &&
+            !submit_numa_batch(numa_table)) {
+        return;
+    }
+
+    const int active = numa_table->active;
+    cached_page = (page + 1) | NUMA_PENDING;
+    numa_table->pending_pages[active][numa_table->pending_count[active]++] =
+        reinterpret_cast<void*>(page << PAGE_SHIFT_4K);
+
+    if (numa_table->pending_count[active] == NUMA_BATCH) {
+        submit_numa_batch(numa_table);
+    }
+}
+
 static inline void fill_trace_struct(int read_write, int line_number,
         size_t base, size_t p, int var_idx) {
     // If this process was never supposed to record stats
@@ -1387,7 +2552,7 @@ static inline void fill_trace_struct(int read_write, int line_number,
     node.trace_info.var_idx = var_idx;
     node.trace_info.line_number = line_number;
 
-    write(fd, &node, sizeof(node_t));
+    write_node(&node);
 }
 
 static inline void fill_mem_struct(int read_write, int line_number, size_t p,
@@ -1409,8 +2574,83 @@ static inline void fill_mem_struct(int read_write, int line_number, size_t p,
     node.mem_info.var_idx = var_idx;
     node.mem_info.line_number = line_number;
     node.mem_info.type_size = type_size;
+    node.mem_info.alloc_site = get_alloc_site(p);
+
+    const omp_state_t& state = get_omp_state();
+    node.mem_info.region_idx = state.region_idx;
+    node.mem_info.threadID = state.thread_num;
+    node.mem_info.team_size = state.team_size;
+
+    write_node(&node);
+
+    if (numa_sampling) {
+        sample_numa_page(p);
+    }
+}
+
+static inline aggregate_site_t* get_aggregate_site(size_t line_number,
+        size_t var_idx) {
+    if (aggregate_table == NULL) {
+        aggregate_table = new aggregate_table_t();
+
+        lock(&global_lock);
+        aggregate_table->next = aggregate_table_list;
+        aggregate_table_list = aggregate_table;
+        unlock(&global_lock);
+    }
+
+    // Consecutive accesses very often come from the same site.
+    size_t index = aggregate_table->last_site;
+    aggregate_site_t* site = &aggregate_table->sites[index];
+    if (site->used && site->line_number == line_number &&
+            site->var_idx == var_idx) {
+        return site;
+    }
+
+    index = (line_number * 31 + var_idx) & (AGGREGATE_SITES - 1);
+    for (int probe = 0; probe < AGGREGATE_SITES; probe++) {
+        site = &aggregate_table->sites[index];
+        if (site->used == false) {
+            site->used = true;
+            site->line_number = line_number;
+            site->var_idx = var_idx;
+            site->cache_lines = new hyperloglog_t();
+        }
+
+        if (site->line_number == line_number && site->var_idx == var_idx) {
+            aggregate_table->last_site = index;
+            return site;
+        }
+
+        index = (index + 1) & (AGGREGATE_SITES - 1);
+    }
 
-    write(fd, &node, sizeof(node_t));
+    return NULL;
+}
+
+static inline void aggregate_mem_struct(int read_write, int line_number,
+        size_t p, int var_idx, int type_size) {
+    // Unlike fill_mem_struct(), every access is counted since
+    // nothing is written out until the program exits.
+    if (fd < 0)
+        return;
+
+    aggregate_site_t* site = get_aggregate_site(line_number, var_idx);
+    if (site == NULL) {
+        aggregate_table->dropped_count += 1;
+        return;
+    }
+
+    if (read_write & TYPE_READ) {
+        site->read_count += 1;
+    }
+
+    if (read_write & TYPE_WRITE) {
+        site->write_count += 1;
+    }
+
+    site->byte_count += type_size;
+    site->cache_lines->insert(ADDR_TO_CACHE_LINE(p));
 }
 
 void indigo__gen_trace_c(int read_write, int line_number, void* base,
@@ -1429,14 +2669,20 @@ void indigo__gen_trace_f(int *read_write, int *line_number, void* base,
 
 void indigo__record_c(int read_write, int line_number, void* addr,
         int var_idx, int type_size) {
-    if (fd >= 0)
+    if (aggregate_mode)
+        aggregate_mem_struct(read_write, line_number, (size_t) addr, var_idx,
+                type_size);
+    else if (fd >= 0)
         fill_mem_struct(read_write, line_number, (size_t) addr, var_idx,
                 type_size);
 }
 
 void indigo__record_f_(int *read_write, int *line_number, void* addr,
         int *var_idx, int* type_size) {
-    if (fd >= 0)
+    if (aggregate_mode)
+        aggregate_mem_struct(*read_write, *line_number, (size_t) addr,
+                *var_idx, *type_size);
+    else if (fd >= 0)
         fill_mem_struct(*read_write, *line_number, (size_t) addr, *var_idx,
                 *type_size);
 }
@@ -1455,7 +2701,7 @@ void indigo__write_idx_c(const char* var_name, const int length) {
     stream_list.push_back(stream_name);
 
     if (fd >= 0) {
-        write(fd, &node, sizeof(node_t));
+        write_node(&node);
     }
 }
 
@@ -1465,7 +2711,225 @@ void indigo__write_idx_f_(const char* var_name, const int* length) {
 }
 }
 
+// Reads a sysfs attribute such as "32K" or "1" into a number of bytes.
+static size_t read_sysfs_size(const char* path) {
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+        return 0;
+
+    size_t value = 0;
+    char suffix = '\0';
+    if (fscanf(fp, "%zu%c", &value, &suffix) < 1)
+        value = 0;
+
+    fclose(fp);
+
+    if (suffix == 'K')
+        return value * 1024;
+    if (suffix == 'M')
+        return value * 1024 * 1024;
+    return value;
+}
+
+static void write_tlb_record() {
+    node_t node;
+    node.type_message = MSG_TLB_INFO;
+
+    tlb_info_t& tlb_info = node.tlb_info;
+    memset(&tlb_info, 0, sizeof(tlb_info_t));
+
+    int info[4];
+    int proc = get_proc_kind();
+    if (proc == PROC_INTEL) {
+        __cpuid(info, 0, 0);
+        if (info[EAX] < 0x18)
+            return;
+
+        // Deterministic address translation parameters.
+        __cpuid(info, 0x18, 0);
+        int max_subleaf = info[EAX];
+        for (int i = 0; i <= max_subleaf; i++) {
+            __cpuid(info, 0x18, i);
+
+            int type = info[EDX] & 0x1f;
+            int level = (info[EDX] >> 5) & 0x7;
+            if (type != 1 && type != 3)     // Neither data nor unified.
+                continue;
+
+            size_t entries = ((unsigned int) info[EBX] >> 16) * info[ECX];
+            if (info[EBX] & 0x1) {
+                if (level == 1)
+                    tlb_info.dtlb_entries_4k = entries;
+                else
+                    tlb_info.stlb_entries_4k = entries;
+            }
+
+            if (info[EBX] & 0x2) {
+                if (level == 1)
+                    tlb_info.dtlb_entries_2m = entries;
+                else
+                    tlb_info.stlb_entries_2m = entries;
+            }
+        }
+    } else if (proc == PROC_AMD) {
+        __cpuid(info, 0x80000000, 0);
+        if ((unsigned int) info[EAX] < 0x80000006)
+            return;
+
+        __cpuid(info, 0x80000005, 0);
+        tlb_info.dtlb_entries_4k = (info[EBX] >> 16) & 0xff;
+        tlb_info.dtlb_entries_2m = (info[EAX] >> 16) & 0xff;
+
+        __cpuid(info, 0x80000006, 0);
+        tlb_info.stlb_entries_4k = (info[EBX] >> 16) & 0xfff;
+        tlb_info.stlb_entries_2m = (info[EAX] >> 16) & 0xfff;
+    }
+
+    // Leave it to the analyzer to guess if cpuid told us nothing.
+    if (tlb_info.dtlb_entries_4k != 0)
+        write_node(&node);
+}
+
+static int read_numa_node(int cpu) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+
+    // The CPU directory holds a link named after the node of the CPU.
+    int numa_node = 0;
+    DIR* dir = opendir(path);
+    if (dir != NULL) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (sscanf(entry->d_name, "node%d", &numa_node) == 1)
+                break;
+        }
+
+        closedir(dir);
+    }
+
+    return numa_node;
+}
+
+// Records the cache and TLB topology of this machine so that the traces can
+// be analyzed on a different machine.
+static void write_topology_records() {
+    const int num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+    cache_info_t cache_list[3];
+    std::set<int> instance_list[3];
+    memset(cache_list, 0, sizeof(cache_list));
+
+    node_t node;
+    node.type_message = MSG_CORE_INFO;
+
+    char path[PATH_MAX];
+    for (int i = 0; i < num_cpus; i++) {
+        core_info_t& core_info = node.core_info;
+        memset(&core_info, 0, sizeof(core_info_t));
+        core_info.coreID = i;
+        for (int level = 0; level < 3; level++) {
+            core_info.cache_id[level] = UINT16_MAX;
+        }
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/"
+                "physical_package_id", i);
+        core_info.socket = read_sysfs_size(path);
+        core_info.numa_node = read_numa_node(i);
+
+        for (int j = 0; ; j++) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/"
+                    "index%d/level", i, j);
+            size_t level = read_sysfs_size(path);
+            if (level == 0)
+                break;
+
+            if (level > 3)
+                continue;
+
+            char type[16] = {0};
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/"
+                    "index%d/type", i, j);
+            FILE* fp = fopen(path, "r");
+            if (fp != NULL) {
+                if (fscanf(fp, "%15s", type) != 1)
+                    type[0] = '\0';
+                fclose(fp);
+            }
+
+            if (strcmp(type, "Instruction") == 0)
+                continue;
+
+            // Name each cache instance after the first core that shares it.
+            int first_cpu = i;
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/"
+                    "index%d/shared_cpu_list", i, j);
+            fp = fopen(path, "r");
+            if (fp != NULL) {
+                if (fscanf(fp, "%d", &first_cpu) != 1)
+                    first_cpu = i;
+                fclose(fp);
+            }
+
+            cache_info_t& cache_info = cache_list[level-1];
+            if (cache_info.level == 0) {
+                cache_info.level = level;
+
+                snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/"
+                        "cache/index%d/size", i, j);
+                cache_info.size = read_sysfs_size(path);
+
+                snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/"
+                        "cache/index%d/coherency_line_size", i, j);
+                cache_info.line_size = read_sysfs_size(path);
+
+                snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/"
+                        "cache/index%d/ways_of_associativity", i, j);
+                cache_info.associativity = read_sysfs_size(path);
+            }
+
+            instance_list[level-1].insert(first_cpu);
+            core_info.cache_id[level-1] = first_cpu;
+        }
+
+        write_node(&node);
+    }
+
+    node.type_message = MSG_CACHE_INFO;
+    for (int i = 0; i < 3; i++) {
+        if (cache_list[i].level != 0 && cache_list[i].size != 0) {
+            node.cache_info = cache_list[i];
+            node.cache_info.count = instance_list[i].size();
+            write_node(&node);
+        }
+    }
+
+    write_tlb_record();
+}
+
+static void write_metadata_records() {
+    node_t node;
+    node.type_message = MSG_METADATA;
+    size_t exe_path_len = readlink("/proc/self/exe",
+            node.metadata_info.binary_name, STRING_LENGTH-1);
+    if (exe_path_len == -1) {
+        perror("MACPO :: Failed to read binary name from /proc/self/exe");
+    } else {
+        // Write the terminating character
+        node.metadata_info.binary_name[exe_path_len] = '\0';
+        time(&node.metadata_info.execution_timestamp);
+        write_node(&node);
+    }
+
+    write_topology_records();
+}
+
 static void create_output_file() {
+    if (getenv("MACPO_NODE_OUTPUT") != NULL && attach_node_segment()) {
+        write_metadata_records();
+        terminal_node.type_message = MSG_TERMINAL;
+        return;
+    }
+
     char szFilename[32];
     snprintf(szFilename, sizeof(szFilename), "macpo.%d.out", getpid());
 
@@ -1488,18 +2952,7 @@ static void create_output_file() {
 
     // Now that we are done handling the critical stuff,
     // write the metadata log to the macpo.out file.
-    node_t node;
-    node.type_message = MSG_METADATA;
-    size_t exe_path_len = readlink("/proc/self/exe",
-            node.metadata_info.binary_name, STRING_LENGTH-1);
-    if (exe_path_len == -1) {
-        perror("MACPO :: Failed to read binary name from /proc/self/exe");
-    } else {
-        // Write the terminating character
-        node.metadata_info.binary_name[exe_path_len] = '\0';
-        time(&node.metadata_info.execution_timestamp);
-        write(fd, &node, sizeof(node_t));
-    }
+    write_metadata_records();
 
     terminal_node.type_message = MSG_TERMINAL;
 }
@@ -1516,7 +2969,11 @@ static void signalHandler(int sig) {
         // Wake up for a brief period of time
         if (fd >= 0) {
             fdatasync(fd);
-            write(fd, &terminal_node, sizeof(node_t));
+            if (in_node_write) {
+                terminal_pending = 1;
+            } else {
+                write_node(&terminal_node);
+            }
         }
 
         // Don't reorder so that `sleeping = 0' remains after fwrite()
@@ -1565,17 +3022,16 @@ static void set_timers() {
 }
 
 static void set_thread_affinity() {
-    int info[4];
     int proc = get_proc_kind();
     if (proc == PROC_UNKNOWN) {
         fprintf(stderr, "MACPO :: Cannot determine processor identification, "
                 "resorting to defaults...\n");
-    } else if (proc == PROC_INTEL) {
+    } else {
         numCores = sysconf(_SC_NPROCESSORS_CONF);
-        intel_apic_mapping = reinterpret_cast<int*>(malloc (sizeof (int) *
+        apic_mapping = reinterpret_cast<int*>(malloc (sizeof (int) *
                 numCores));
 
-        if (intel_apic_mapping) {
+        if (apic_mapping) {
             // Get the original affinity mask
             cpu_set_t old_mask;
             CPU_ZERO(&old_mask);
@@ -1584,24 +3040,18 @@ static void set_thread_affinity() {
             // Loop over all cores and find map their APIC IDs to core IDs
             int i;
             for (i = 0; i < numCores; i++) {
+                apic_mapping[i] = -1;
+
                 cpu_set_t mask;
                 CPU_ZERO(&mask);
                 CPU_SET(i, &mask);
 
                 if (sched_setaffinity(0, sizeof(cpu_set_t), &mask) != -1) {
-                    // Get the APIC ID
-                    __cpuid(info, 0xB, 0);
-                    if (info[EBX] != 0) {   // x2APIC
-                        __cpuid(info, 0xB, 2);
-                        intel_apic_mapping[i] = info[EDX];
-                    } else {  // Traditonal APIC
-                        __cpuid(info, 1, 0);
-                        intel_apic_mapping[i] = (info[EBX] & 0xff000000) >> 24;
-                    }
+                    apic_mapping[i] = read_apic_id();
 
 #ifdef DEBUG_PRINT
                     fprintf(stderr, "MACPO :: Registered mapping from core %d "
-                            "to APIC %d\n", i, intel_apic_mapping[i]);
+                            "to APIC %d\n", i, apic_mapping[i]);
 #endif
                 }
             }
@@ -1616,14 +3066,35 @@ static void set_thread_affinity() {
     }
 }
 
-void indigo__init_(int16_t create_file, int16_t enable_sampling) {
+void indigo__init_(int16_t create_file, int16_t enable_sampling,
+        int16_t aggregate) {
     set_thread_affinity();
 
+    // Processes of ranks that are not selected record nothing, so they
+    // install neither timers nor hooks and leave fd closed.
+    mpi_rank = get_mpi_rank();
+    if (!is_rank_selected(mpi_rank, getenv("MACPO_RANKS"),
+                getenv("MACPO_RANK_STRIDE"))) {
+        return;
+    }
+
     if (create_file) {
         create_output_file();
     }
 
-    if (enable_sampling) {
+    if (&mrt_heap_linked != NULL) {
+        init_heap_tracking();
+    }
+
+    if (getenv("MACPO_NUMA") != NULL && fd >= 0) {
+        init_numa_sampling();
+    }
+
+    if (aggregate) {
+        // Counters are summarized at exit, so there is no need to sample.
+        aggregate_mode = true;
+        sleeping = 0;
+    } else if (enable_sampling) {
         set_timers();
     } else {
         // Explicitly set awake mode to ON.
@@ -210,7 +210,8 @@ void indigo__stride_check_c(int line_number, void* func_addr, int stride);
 
 void indigo__reuse_dist_c(int index, void* address);
 
-void indigo__init_(int16_t create_file, int16_t enable_sampling);
+void indigo__init_(int16_t create_file, int16_t enable_sampling,
+        int16_t aggregate);
 
 void indigo__write_idx_c(const char* var_name, const int length);
 
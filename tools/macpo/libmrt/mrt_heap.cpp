@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <dlfcn.h>
+
+#include <cstring>
+#include <new>
+
+#include "mrt_heap.h"
+
+#if __cplusplus >= 201103L
+#define MRT_THROW_BAD_ALLOC
+#define MRT_NO_THROW noexcept
+#else
+#define MRT_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define MRT_NO_THROW throw()
+#endif
+
+extern const bool mrt_heap_linked = true;
+
+typedef void* (*malloc_fn_t)(size_t);
+typedef void* (*calloc_fn_t)(size_t, size_t);
+typedef void* (*realloc_fn_t)(void*, size_t);
+typedef void (*free_fn_t)(void*);
+typedef int (*posix_memalign_fn_t)(void**, size_t, size_t);
+typedef void* (*memalign_fn_t)(size_t, size_t);
+
+// The allocator that follows the program in the symbol lookup order, so a
+// preloaded or linked jemalloc or tcmalloc still serves the allocations.
+static malloc_fn_t next_malloc = NULL;
+static calloc_fn_t next_calloc = NULL;
+static realloc_fn_t next_realloc = NULL;
+static free_fn_t next_free = NULL;
+static posix_memalign_fn_t next_posix_memalign = NULL;
+static memalign_fn_t next_aligned_alloc = NULL;
+static memalign_fn_t next_memalign = NULL;
+
+// dlsym() may allocate while the allocator is looked up. Those allocations
+// come from this buffer, which is zero-filled and never reused.
+static char bootstrap_buffer[4096] __attribute__((aligned(16)));
+static size_t bootstrap_used = 0;
+static bool resolving = false;
+
+static void* bootstrap_alloc(size_t size) {
+    size_t offset = (bootstrap_used + 15) & ~static_cast<size_t>(15);
+    if (size > sizeof(bootstrap_buffer) - offset) {
+        return NULL;
+    }
+
+    bootstrap_used = offset + size;
+    return bootstrap_buffer + offset;
+}
+
+static inline bool is_bootstrap(void* ptr) {
+    return static_cast<char*>(ptr) >= bootstrap_buffer &&
+        static_cast<char*>(ptr) < bootstrap_buffer + sizeof(bootstrap_buffer);
+}
+
+static void resolve_allocator() {
+    resolving = true;
+    next_malloc = reinterpret_cast<malloc_fn_t>(dlsym(RTLD_NEXT, "malloc"));
+    next_calloc = reinterpret_cast<calloc_fn_t>(dlsym(RTLD_NEXT, "calloc"));
+    next_realloc = reinterpret_cast<realloc_fn_t>(dlsym(RTLD_NEXT,
+                "realloc"));
+    next_free = reinterpret_cast<free_fn_t>(dlsym(RTLD_NEXT, "free"));
+    next_posix_memalign = reinterpret_cast<posix_memalign_fn_t>(dlsym(
+                RTLD_NEXT, "posix_memalign"));
+    next_aligned_alloc = reinterpret_cast<memalign_fn_t>(dlsym(RTLD_NEXT,
+                "aligned_alloc"));
+    next_memalign = reinterpret_cast<memalign_fn_t>(dlsym(RTLD_NEXT,
+                "memalign"));
+    resolving = false;
+}
+
+// Allocates for operator new, which reports the site that called it rather
+// than its own call to malloc() inside the C++ runtime.
+static void* new_block(size_t size, size_t alignment, void* return_address) {
+    if (next_malloc == NULL) {
+        resolve_allocator();
+    }
+
+    size = size == 0 ? 1 : size;
+
+    void* ptr = NULL;
+    while (true) {
+        if (alignment == 0) {
+            ptr = next_malloc(size);
+        } else if (next_posix_memalign(&ptr, alignment, size) != 0) {
+            ptr = NULL;
+        }
+
+        if (ptr != NULL) {
+            break;
+        }
+
+        std::new_handler handler = std::set_new_handler(NULL);
+        std::set_new_handler(handler);
+        if (handler == NULL) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+
+    mrt_track_allocation(ptr, size, return_address);
+    return ptr;
+}
+
+extern "C" {
+void* malloc(size_t size) {
+    if (next_malloc == NULL) {
+        if (resolving) {
+            return bootstrap_alloc(size);
+        }
+        resolve_allocator();
+    }
+
+    void* ptr = next_malloc(size);
+    mrt_track_allocation(ptr, size, __builtin_return_address(0));
+    return ptr;
+}
+
+void* calloc(size_t nmemb, size_t size) {
+    if (next_calloc == NULL) {
+        if (resolving) {
+            return bootstrap_alloc(nmemb * size);
+        }
+        resolve_allocator();
+    }
+
+    void* ptr = next_calloc(nmemb, size);
+    mrt_track_allocation(ptr, nmemb * size, __builtin_return_address(0));
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (next_realloc == NULL) {
+        resolve_allocator();
+    }
+
+    // Blocks from the bootstrap buffer are copied out, as far as they can
+    // extend.
+    if (is_bootstrap(ptr)) {
+        void* new_ptr = next_malloc(size);
+        if (new_ptr != NULL) {
+            size_t left = bootstrap_buffer + sizeof(bootstrap_buffer) -
+                static_cast<char*>(ptr);
+            memcpy(new_ptr, ptr, size < left ? size : left);
+            mrt_track_allocation(new_ptr, size, __builtin_return_address(0));
+        }
+        return new_ptr;
+    }
+
+    void* new_ptr = next_realloc(ptr, size);
+
+    // The old block is only released if realloc() succeeded.
+    if (new_ptr != NULL || size == 0) {
+        mrt_untrack_allocation(ptr);
+        mrt_track_allocation(new_ptr, size, __builtin_return_address(0));
+    }
+
+    return new_ptr;
+}
+
+void free(void* ptr) {
+    if (ptr == NULL || is_bootstrap(ptr)) {
+        return;
+    }
+
+    if (next_free == NULL) {
+        resolve_allocator();
+    }
+
+    mrt_untrack_allocation(ptr);
+    next_free(ptr);
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size) {
+    if (next_posix_memalign == NULL) {
+        resolve_allocator();
+    }
+
+    int rc = next_posix_memalign(memptr, alignment, size);
+    if (rc == 0) {
+        mrt_track_allocation(*memptr, size, __builtin_return_address(0));
+    }
+
+    return rc;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    if (next_aligned_alloc == NULL) {
+        resolve_allocator();
+    }
+
+    void* ptr = next_aligned_alloc(alignment, size);
+    mrt_track_allocation(ptr, size, __builtin_return_address(0));
+    return ptr;
+}
+
+void* memalign(size_t alignment, size_t size) {
+    if (next_memalign == NULL) {
+        resolve_allocator();
+    }
+
+    void* ptr = next_memalign(alignment, size);
+    mrt_track_allocation(ptr, size, __builtin_return_address(0));
+    return ptr;
+}
+}
+
+// The C++ runtime releases through free(), so only allocations need to be
+// replaced.
+void* operator new(size_t size) MRT_THROW_BAD_ALLOC {
+    return new_block(size, 0, __builtin_return_address(0));
+}
+
+void* operator new[](size_t size) MRT_THROW_BAD_ALLOC {
+    return new_block(size, 0, __builtin_return_address(0));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) MRT_NO_THROW {
+    try {
+        return new_block(size, 0, __builtin_return_address(0));
+    } catch (...) {
+        return NULL;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) MRT_NO_THROW {
+    try {
+        return new_block(size, 0, __builtin_return_address(0));
+    } catch (...) {
+        return NULL;
+    }
+}
+
+#if defined(__cpp_aligned_new)
+void* operator new(size_t size, std::align_val_t alignment) {
+    return new_block(size, static_cast<size_t>(alignment),
+            __builtin_return_address(0));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return new_block(size, static_cast<size_t>(alignment),
+            __builtin_return_address(0));
+}
+
+void* operator new(size_t size, std::align_val_t alignment,
+        const std::nothrow_t&) noexcept {
+    try {
+        return new_block(size, static_cast<size_t>(alignment),
+                __builtin_return_address(0));
+    } catch (...) {
+        return NULL;
+    }
+}
+
+void* operator new[](size_t size, std::align_val_t alignment,
+        const std::nothrow_t&) noexcept {
+    try {
+        return new_block(size, static_cast<size_t>(alignment),
+                __builtin_return_address(0));
+    } catch (...) {
+        return NULL;
+    }
+}
+#endif
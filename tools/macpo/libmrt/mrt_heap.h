@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2011-2013  University of Texas at Austin. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * This file is part of PerfExpert.
+ *
+ * PerfExpert is free software: you can redistribute it and/or modify it under
+ * the terms of the The University of Texas at Austin Research License
+ *
+ * PerfExpert is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.
+ *
+ * Authors: Leonardo Fialho and Ashay Rane
+ *
+ * $HEADER$
+ */
+
+#ifndef TOOLS_MACPO_LIBMRT_MRT_HEAP_H_
+#define TOOLS_MACPO_LIBMRT_MRT_HEAP_H_
+
+#include <cstddef>
+
+// libmrt_heap replaces the allocation functions of the program and reports
+// each allocation and release to libmrt. It is only linked in when asked
+// for (macpo.sh --macpo:track-heap), and libmrt only tracks the heap if it
+// finds mrt_heap_linked.
+extern const bool mrt_heap_linked __attribute__((weak));
+
+void mrt_track_allocation(void* ptr, size_t size, void* return_address);
+void mrt_untrack_allocation(void* ptr);
+
+#endif  // TOOLS_MACPO_LIBMRT_MRT_HEAP_H_
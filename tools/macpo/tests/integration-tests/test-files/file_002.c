@@ -1,5 +1,5 @@
 #if 0
-[macpo-integration-test]:init:1:1:
+[macpo-integration-test]:init:1:1:0:
 [macpo-integration-test]:write_idx:array:5:
 [macpo-integration-test]:record:2:15:?:0:4:
 [macpo-integration-test]:record:1:16:?:0:4:
@@ -1,5 +1,5 @@
 #if 0
-[macpo-integration-test]:init:1:1:
+[macpo-integration-test]:init:1:1:0:
 [macpo-integration-test]:write_idx:c:1:
 [macpo-integration-test]:write_idx:a:1:
 [macpo-integration-test]:write_idx:b:1:
@@ -1,5 +1,5 @@
 #if 0
-[macpo-integration-test]:init:0:1:
+[macpo-integration-test]:init:0:1:0:
 [macpo-integration-test]:overlap_check:21:?:3:?:?:?:?:?:?
 [macpo-integration-test]:overlap_check:21:?:3:?:?:?:?:?:?
 [macpo-integration-test]:overlap_check:20:?:3:?:?:?:?:?:?
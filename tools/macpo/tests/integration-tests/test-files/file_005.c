@@ -1,5 +1,5 @@
 #if 0
-[macpo-integration-test]:init:0:1:
+[macpo-integration-test]:init:0:1:0:
 [macpo-integration-test]:stride_check:35:?:0
 [macpo-integration-test]:stride_check:35:?:0
 [macpo-integration-test]:stride_check:35:?:1
@@ -1,5 +1,5 @@
 #if 0
-[macpo-integration-test]:init:0:1:
+[macpo-integration-test]:init:0:1:0:
 [macpo-integration-test]:write_idx:c:1:
 [macpo-integration-test]:reuse_dist:0:?:
 [macpo-integration-test]:reuse_dist:0:?:
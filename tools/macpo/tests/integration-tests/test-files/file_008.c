@@ -1,5 +1,5 @@
 #if 0
-[macpo-integration-test]:init:0:1:
+[macpo-integration-test]:init:0:1:0:
 [macpo-integration-test]:aligncheck:33:?:3:2:?:?:?:
 [macpo-integration-test]:sstore_aligncheck:33:?:3:2:?:?:?:
 [macpo-integration-test]:aligncheck:33:?:3:2:?:?:?:
@@ -83,9 +83,10 @@ void indigo__tripcount_check_c(int line_number, void* func_addr,
         func_addr << ":" << trip_count << std::endl;
 }
 
-void indigo__init_(int16_t create_file, int16_t enable_sampling) {
+void indigo__init_(int16_t create_file, int16_t enable_sampling,
+        int16_t aggregate) {
     std::cerr << test_prefix << "init:" << create_file << ":" <<
-        enable_sampling << ":" << std::endl;
+        enable_sampling << ":" << aggregate << ":" << std::endl;
 }
 
 void indigo__gen_trace_c(int read_write, int line_number, void* base,
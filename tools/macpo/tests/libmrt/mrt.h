@@ -82,7 +82,8 @@ void indigo__tripcount_check_c(int line_number, void* func_addr,
 #if defined(__cplusplus)
 extern "C" {
 #endif
-void indigo__init_(int16_t create_file, int16_t enable_sampling);
+void indigo__init_(int16_t create_file, int16_t enable_sampling,
+        int16_t aggregate);
 #if defined (__cplusplus)
 }
 #endif
@@ -29,6 +29,18 @@ TEST(ArgParse, ValidNoCompile) {
     EXPECT_EQ(options.no_compile, true);
 }
 
+TEST(ArgParse, ValidAggregate) {
+    char argument[128];
+    options_t options;
+
+    EXPECT_EQ(options.aggregate, false);
+
+    snprintf(argument, sizeof(argument), "--macpo:aggregate");
+    EXPECT_EQ(argparse::parse_arguments(argument, options), 0);
+
+    EXPECT_EQ(options.aggregate, true);
+}
+
 TEST(ArgParse, ValidInstrumentFunction) {
     char argument[128];
     options_t options;
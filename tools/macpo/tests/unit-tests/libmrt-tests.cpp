@@ -1,6 +1,10 @@
 
+#include "fenwick_tree.h"
 #include "generic_defs.h"
 #include "histogram.h"
+#include "hyperloglog.h"
+#include "log_histogram.h"
+#include "rank_select.h"
 
 #include "gtest/gtest.h"
 
@@ -23,3 +27,191 @@ TEST(libmrt, HistogramSort) {
     EXPECT_EQ(pair.first, 13);
     EXPECT_EQ(pair.second, 30);
 }
+
+TEST(libmrt, RankSelectDefault) {
+    EXPECT_TRUE(is_rank_selected(0, NULL, NULL));
+    EXPECT_TRUE(is_rank_selected(17, NULL, NULL));
+}
+
+TEST(libmrt, RankSelectList) {
+    EXPECT_TRUE(is_rank_selected(0, "0,8,16-19", NULL));
+    EXPECT_TRUE(is_rank_selected(8, "0,8,16-19", NULL));
+    EXPECT_TRUE(is_rank_selected(16, "0,8,16-19", NULL));
+    EXPECT_TRUE(is_rank_selected(19, "0,8,16-19", NULL));
+
+    EXPECT_FALSE(is_rank_selected(1, "0,8,16-19", NULL));
+    EXPECT_FALSE(is_rank_selected(15, "0,8,16-19", NULL));
+    EXPECT_FALSE(is_rank_selected(20, "0,8,16-19", NULL));
+}
+
+TEST(libmrt, RankSelectStride) {
+    EXPECT_TRUE(is_rank_selected(0, NULL, "4"));
+    EXPECT_TRUE(is_rank_selected(12, NULL, "4"));
+    EXPECT_FALSE(is_rank_selected(13, NULL, "4"));
+
+    // Either the list or the stride may select a rank.
+    EXPECT_TRUE(is_rank_selected(3, "3", "4"));
+    EXPECT_TRUE(is_rank_selected(8, "3", "4"));
+    EXPECT_FALSE(is_rank_selected(5, "3", "4"));
+}
+
+TEST(libmrt, RankSelectBadInput) {
+    EXPECT_FALSE(is_rank_selected(0, "", NULL));
+    EXPECT_FALSE(is_rank_selected(0, "abc", NULL));
+    EXPECT_FALSE(is_rank_selected(3, "3-", NULL));
+    EXPECT_FALSE(is_rank_selected(3, "3x", NULL));
+    EXPECT_FALSE(is_rank_selected(4, "5-3", NULL));
+
+    // Entries after a malformed one are ignored.
+    EXPECT_TRUE(is_rank_selected(1, "1,x,3", NULL));
+    EXPECT_FALSE(is_rank_selected(3, "1,x,3", NULL));
+
+    // A stride that is not positive selects nothing.
+    EXPECT_FALSE(is_rank_selected(0, NULL, "0"));
+    EXPECT_FALSE(is_rank_selected(0, NULL, "-2"));
+    EXPECT_FALSE(is_rank_selected(0, NULL, "abc"));
+}
+
+TEST(libmrt, FenwickTreePrefixSum) {
+    fenwick_tree_t tree(8);
+
+    tree.add(0, 1);
+    tree.add(3, 2);
+    tree.add(7, 4);
+
+    EXPECT_EQ(tree.prefix_sum(0), 1);
+    EXPECT_EQ(tree.prefix_sum(2), 1);
+    EXPECT_EQ(tree.prefix_sum(3), 3);
+    EXPECT_EQ(tree.prefix_sum(6), 3);
+    EXPECT_EQ(tree.prefix_sum(7), 7);
+
+    // Moving a mark to a later position.
+    tree.add(3, -2);
+    tree.add(5, 2);
+    EXPECT_EQ(tree.prefix_sum(3), 1);
+    EXPECT_EQ(tree.prefix_sum(4), 1);
+    EXPECT_EQ(tree.prefix_sum(5), 3);
+    EXPECT_EQ(tree.prefix_sum(7), 7);
+}
+
+TEST(libmrt, FenwickTreeSize) {
+    fenwick_tree_t single(1);
+    single.add(0, 5);
+    EXPECT_EQ(single.prefix_sum(0), 5);
+
+    // Sizes that are not a power of two, checked against a plain array.
+    const size_t sizes[] = { 13, 64, 100 };
+    for (int i=0; i<3; i++) {
+        const size_t size = sizes[i];
+        fenwick_tree_t tree(size);
+        std::vector<int> values(size, 0);
+
+        for (size_t j=0; j<size; j++) {
+            const int value = (j * 7) % 5;
+            tree.add(j, value);
+            values[j] += value;
+        }
+
+        tree.add(size - 1, 3);
+        values[size - 1] += 3;
+
+        size_t sum = 0;
+        for (size_t j=0; j<size; j++) {
+            sum += values[j];
+            EXPECT_EQ(tree.prefix_sum(j), sum);
+        }
+    }
+}
+
+TEST(libmrt, HyperLogLogEstimate) {
+    hyperloglog_t hll;
+    EXPECT_EQ(hll.estimate(), 0);
+
+    // Cache line addresses, each inserted twice. With 1024 registers the
+    // standard error is about 3%, so allow for three times that.
+    const uint64_t count = 100000;
+    for (int pass=0; pass<2; pass++) {
+        for (uint64_t i=0; i<count; i++) {
+            hll.insert(i * 64);
+        }
+    }
+
+    EXPECT_NEAR(hll.estimate(), count, 0.1 * count);
+
+    // Small sets are counted from the empty registers.
+    hll.reset();
+    for (uint64_t i=0; i<100; i++) {
+        hll.insert(i * 64);
+    }
+
+    EXPECT_NEAR(hll.estimate(), 100, 5);
+}
+
+TEST(libmrt, HyperLogLogMerge) {
+    hyperloglog_t first, second, all;
+
+    for (uint64_t i=0; i<60000; i++) {
+        all.insert(i);
+        if (i < 40000) {
+            first.insert(i);
+        }
+
+        // The two halves overlap on [20000, 40000).
+        if (i >= 20000) {
+            second.insert(i);
+        }
+    }
+
+    first.merge(second);
+    EXPECT_EQ(first.estimate(), all.estimate());
+    EXPECT_NEAR(first.estimate(), 60000, 0.1 * 60000);
+}
+
+TEST(libmrt, LogHistogramSmallValues) {
+    log_histogram_t hist;
+
+    hist.add(0, 2);
+    EXPECT_EQ(hist.size(), 1);
+    EXPECT_EQ(hist.tail(0), std::make_pair(2.0, 0.0));
+    EXPECT_EQ(hist.tail(1), std::make_pair(0.0, 0.0));
+
+    // Values below the number of bins per power of two get a bin each.
+    for (size_t i=1; i<LOG_HISTOGRAM_SUB_BINS; i++) {
+        hist.add(i);
+    }
+
+    EXPECT_EQ(hist.size(), LOG_HISTOGRAM_SUB_BINS);
+    for (size_t i=1; i<LOG_HISTOGRAM_SUB_BINS; i++) {
+        EXPECT_EQ(hist.tail(i).first, LOG_HISTOGRAM_SUB_BINS - i);
+    }
+}
+
+TEST(libmrt, LogHistogramPowersOfTwo) {
+    // Every power of two starts a new bin, so the value just below it is
+    // never counted in the tail.
+    for (int i=1; i<64; i++) {
+        const size_t value = (size_t) 1 << i;
+
+        log_histogram_t hist;
+        hist.add(value - 1);
+        hist.add(value, 3);
+
+        EXPECT_EQ(hist.tail(value), std::make_pair(3.0, 3.0 * value));
+        EXPECT_EQ(hist.tail(value - 1).first, 4);
+    }
+}
+
+TEST(libmrt, LogHistogramMaxValue) {
+    const size_t max_value = (size_t) -1;
+    const size_t top = (size_t) 1 << 63;
+
+    log_histogram_t hist;
+    hist.add(max_value);
+    hist.add(top);
+    hist.add(top - 1);
+
+    EXPECT_EQ(hist.size(), 3);
+    EXPECT_EQ(hist.tail(max_value), std::make_pair(1.0, (double) max_value));
+    EXPECT_EQ(hist.tail(top).first, 2);
+    EXPECT_EQ(hist.tail(0).first, 3);
+}